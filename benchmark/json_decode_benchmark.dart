@@ -0,0 +1,111 @@
+// Dart-side cost per message of a JSON feed: jsonDecode on the isolate vs
+// reading the same fields from the POD records built natively by
+// fcb::JsonIngest (json_ingest.h).
+//
+// The records are laid out here exactly as json_ingest.h does, so no native
+// library is needed; linux/benchmark/json_ingest_bench.cc measures the
+// worker-side conversion of the same documents.
+//
+//   dart run benchmark/json_decode_benchmark.dart
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+const _iterations = 2000;
+
+double _sink = 0;
+
+// Same generator as json_ingest_bench.cc.
+String _doc(int i, int samples) {
+  final values = [for (var k = 0; k < samples; k++) '${k % 1000}.25'];
+  return '{"id":$i,"ok":${i % 2 == 0},"sensor":{"name":"probe-${i % 16}",'
+      '"temp":${20 + i % 10}.5,"samples":[${values.join(',')}]}}';
+}
+
+/// One message decoded the 1.0.x way: bytes → String → jsonDecode per line.
+void _decode(Uint8List message) {
+  for (final line in const LineSplitter().convert(utf8.decode(message))) {
+    final doc = jsonDecode(line) as Map<String, dynamic>;
+    final sensor = doc['sensor'] as Map<String, dynamic>;
+    _sink += (doc['id'] as int) + (sensor['temp'] as num) +
+        (sensor['samples'] as List)[0] +
+        (sensor['name'] as String).length +
+        (doc['ok'] == true ? 1 : 0);
+  }
+}
+
+// Record layout of json_ingest.h for the mapping /id int64, /ok bool,
+// /sensor/temp float64, /sensor/name string, /sensor/samples/0 float64.
+const _recordSize = 48;
+
+Uint8List _records(int docs) {
+  final names = <int>[];
+  final data = ByteData(16 + docs * _recordSize);
+  for (var i = 0; i < docs; i++) {
+    final at = 16 + i * _recordSize;
+    final name = utf8.encode('probe-${i % 16}');
+    data.setUint64(at, 0x1f, Endian.host);
+    data.setInt64(at + 8, i, Endian.host);
+    data.setUint8(at + 16, i % 2 == 0 ? 1 : 0);
+    data.setFloat64(at + 24, 20 + i % 10 + 0.5, Endian.host);
+    data.setUint32(at + 32, names.length, Endian.host);
+    data.setUint32(at + 36, name.length, Endian.host);
+    data.setFloat64(at + 40, 0.25, Endian.host);
+    names.addAll(name);
+  }
+  data.setUint32(0, docs, Endian.host);
+  data.setUint32(4, _recordSize, Endian.host);
+  data.setUint32(8, data.lengthInBytes, Endian.host);
+  data.setUint32(12, names.length, Endian.host);
+  return Uint8List.fromList([...data.buffer.asUint8List(), ...names]);
+}
+
+/// The same message read from the POD records, as JsonRecordBatch does.
+void _read(Uint8List message) {
+  final data = ByteData.sublistView(message);
+  final count = data.getUint32(0, Endian.host);
+  final stringsAt = data.getUint32(8, Endian.host);
+  for (var i = 0; i < count; i++) {
+    final at = 16 + i * _recordSize;
+    final nameAt = stringsAt + data.getUint32(at + 32, Endian.host);
+    final name = utf8.decode(Uint8List.sublistView(
+        message, nameAt, nameAt + data.getUint32(at + 36, Endian.host)));
+    _sink += data.getInt64(at + 8, Endian.host) +
+        data.getFloat64(at + 24, Endian.host) +
+        data.getFloat64(at + 40, Endian.host) +
+        name.length +
+        data.getUint8(at + 16);
+  }
+}
+
+double _measure(void Function(Uint8List) fn, Uint8List message) {
+  var best = double.infinity;
+  for (var rep = 0; rep < 6; rep++) {
+    final sw = Stopwatch()..start();
+    for (var i = 0; i < _iterations; i++) {
+      fn(message);
+    }
+    sw.stop();
+    final ns = sw.elapsedMicroseconds * 1000 / _iterations;
+    if (rep > 0 && ns < best) best = ns; // rep 0 warms up
+  }
+  return best;
+}
+
+void main() {
+  const cases = [
+    ('1 doc, 4 samples', 1, 4),
+    ('1 doc, 500 samples', 1, 500),
+    ('64 docs NDJSON, 4 samples', 64, 4),
+  ];
+  for (final (name, docs, samples) in cases) {
+    final json = utf8.encode(
+        [for (var i = 0; i < docs; i++) '${_doc(i, samples)}\n'].join());
+    final decode = _measure(_decode, Uint8List.fromList(json));
+    final read = _measure(_read, _records(docs));
+    stdout.writeln('$name (${json.length} B):');
+    stdout.writeln('  jsonDecode:  ${decode.toStringAsFixed(0)} ns/message');
+    stdout.writeln('  POD records: ${read.toStringAsFixed(0)} ns/message');
+  }
+  stdout.writeln('(checksum $_sink)');
+}
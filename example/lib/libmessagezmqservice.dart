@@ -1,6 +1,7 @@
 import 'dart:ffi';
 
 import 'package:flutter_cpp_bridge/service.dart';
+import 'package:flutter_cpp_bridge/zmq_ingest_service.dart';
 
 import 'messages_fcb_msgs_generated.dart';
 
@@ -9,9 +10,9 @@ export 'messages_fcb_msgs_generated.dart';
 /// Dart wrapper for libmessagezmq.so.
 ///
 /// Receives FlatBuffers messages published by an external process over ZMQ
-/// (SUB socket connected to `ipc:///tmp/zmq_test`).  The C++ worker holds a
-/// switch-case that filters and routes messages before pushing them into the
-/// [fcb::BytesQueue] — Dart only receives what C++ explicitly forwarded.
+/// (SUB socket connected to `ipc:///tmp/zmq_test` by default).  The C++
+/// filter holds a switch-case that drops messages before they are queued —
+/// Dart only receives what C++ explicitly forwarded.
 ///
 /// Usage:
 /// ```dart
@@ -23,26 +24,23 @@ export 'messages_fcb_msgs_generated.dart';
 /// });
 /// servicePool.addService(svc);
 /// ```
-class LibMessageZmqService extends Service {
-  LibMessageZmqService() : super('libmessagezmq.so') {
-    _getBytes = lib
-        .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
-          'get_msg_bytes',
-        )
-        .asFunction();
-    _getLen = lib
-        .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
-          'get_msg_len',
-        )
-        .asFunction();
-  }
-
-  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes;
-  late final int Function(Pointer<BackendMsg>) _getLen;
+///
+/// The library registers itself as `messagezmq` (kind `zmq_ingest`), so a
+/// `ServiceRegistry` can build this service from the path it was actually
+/// loaded from: `LibMessageZmqService(libname: info.library)`.
+class LibMessageZmqService extends ZmqIngestService {
+  LibMessageZmqService({
+    String libname = 'libmessagezmq.so',
+    List<String> endpoints = const ['ipc:///tmp/zmq_test'],
+    int? receiveHighWaterMark,
+  }) : super(
+          libname,
+          endpoints: endpoints,
+          receiveHighWaterMark: receiveHighWaterMark,
+        );
 
-  /// Deserialise the FlatBuffers buffer into a [Message].
+  /// Deserialise the FlatBuffers payload into a [Message].
   ///
   /// Valid only for the duration of the [assignJob] callback.
-  Message? decode(Pointer<BackendMsg> msg) =>
-      Message(_getBytes(msg).asTypedList(_getLen(msg)));
+  Message? decode(Pointer<BackendMsg> msg) => Message(payload(msg));
 }
@@ -1,7 +1,7 @@
 #include <chrono>
 #include <cstdint>
 #include <random>
-#include "flutter_cpp_bridge/service_helpers.h"
+#include "flutter_cpp_bridge/service_registry.h"
 
 struct liba_message_t
 {
@@ -15,7 +15,8 @@ static void worker(fcb::Queue<liba_message_t>& svc)
     std::mt19937 gen(std::random_device{}());
     std::uniform_int_distribution<uint8_t> dis(0, 255);
 
-    while (!svc.stopped()) {
+    // Parks the thread while no Dart job is assigned (screen hidden, …).
+    while (svc.wait_for_consumer()) {
         svc.push({dis(gen), dis(gen), dis(gen)});
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
@@ -23,6 +24,9 @@ static void worker(fcb::Queue<liba_message_t>& svc)
 
 FCB_EXPORT_SYMBOLS(g_svc, worker)
 
+// Lets Dart find this service through ServiceRegistry.
+FCB_REGISTER_SERVICE(g_svc, "liba", "color")
+
 FCB_EXPORT uint32_t get_hexa_color(liba_message_t* msg)
 {
     return 0xFF000000u | (uint32_t(msg->r) << 16) | (uint32_t(msg->g) << 8) | msg->b;
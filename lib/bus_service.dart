@@ -0,0 +1,115 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// One topic of the in-process bus, received as an ordinary [Service]; see
+/// [BusBridge.subscribe].
+///
+/// The channel is subscribed natively only while the service is started, so
+/// publishers skip it while it is stopped.
+class BusChannel extends Service {
+  BusChannel._(super.libname, super.channel, this.topic) : super.channel();
+
+  /// The bus topic this channel receives.
+  final String topic;
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getData = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'bus_msg_data',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _getSize = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'bus_msg_size',
+      )
+      .asFunction();
+
+  /// Zero-copy view of the payload carried by [msg]: the published bytes, or
+  /// the in-memory representation of a value published with
+  /// `publish_value`.
+  ///
+  /// The buffer is shared with every other subscriber; it is valid only
+  /// until the message is freed and must not be written to.
+  Uint8List bytes(Pointer<BackendMsg> msg) =>
+      _getData(msg).asTypedList(_getSize(msg));
+}
+
+/// Client of the in-process topic bus (`fcb::bus()` in `bus.h`)
+/// through a library that exports `FCB_EXPORT_BUS_SYMBOLS`.
+///
+/// Native services publish to and subscribe to each other directly. Dart
+/// takes part only for the topics it subscribes to, each received as a
+/// [BusChannel]:
+///
+/// ```dart
+/// final bus = BusBridge('libbus.so');
+/// final colors = bus.subscribe('liba/color');
+/// colors.assignJob((msg) => paint(colors.bytes(msg)));
+/// pool.addService(colors);
+///
+/// bus.publish('ui/brightness', Uint8List.fromList([80]));
+/// ```
+///
+/// The bus is shared by every library in the process, so any library that
+/// exports the symbols can serve as the bridge.
+class BusBridge {
+  BusBridge(this.libname) : _lib = DynamicLibrary.open(libname);
+
+  /// Path to the shared library exporting the bus symbols.
+  final String libname;
+
+  final DynamicLibrary _lib;
+  final _channels = <BusChannel>[];
+
+  late final int Function(Pointer<Utf8>) _subscribe = _lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<Utf8>)>>('bus_subscribe')
+      .asFunction();
+  late final int Function(Pointer<Utf8>, Pointer<Uint8>, int) _publish = _lib
+      .lookup<
+          NativeFunction<
+              Uint32 Function(Pointer<Utf8>, Pointer<Uint8>, Uint32)>>(
+        'bus_publish',
+      )
+      .asFunction();
+
+  /// Channels created by [subscribe], in creation order.
+  List<BusChannel> get channels => List.unmodifiable(_channels);
+
+  /// A new service receiving [topic]. Start it (e.g. add it to a
+  /// `ServicePool`) to begin receiving.
+  BusChannel subscribe(String topic) {
+    final nativeTopic = topic.toNativeUtf8();
+    try {
+      final channel = BusChannel._(libname, _subscribe(nativeTopic), topic);
+      _channels.add(channel);
+      return channel;
+    } finally {
+      calloc.free(nativeTopic);
+    }
+  }
+
+  /// Publishes a copy of [bytes] to [topic] and returns how many
+  /// subscribers received it.
+  int publish(String topic, Uint8List bytes) {
+    final nativeTopic = topic.toNativeUtf8();
+    final data = calloc<Uint8>(bytes.length);
+    try {
+      data.asTypedList(bytes.length).setAll(0, bytes);
+      return _publish(nativeTopic, data, bytes.length);
+    } finally {
+      calloc.free(data);
+      calloc.free(nativeTopic);
+    }
+  }
+
+  /// Disposes every channel created by [subscribe].
+  void dispose() {
+    for (final ch in _channels) {
+      ch.dispose();
+    }
+    _channels.clear();
+  }
+}
@@ -0,0 +1,157 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// How a [FileStreamService] reads the file.
+enum FileStreamBackend {
+  /// Not started yet.
+  none,
+
+  /// Blocking `pread` on the native reader thread (io_uring unavailable).
+  pread,
+
+  /// io_uring reads.
+  ioUring,
+
+  /// io_uring reads into registered (pinned) buffers.
+  ioUringFixed,
+}
+
+typedef _ConfigureNative = Void Function(
+  Pointer<Utf8>,
+  Uint64,
+  Uint64,
+  Uint32,
+  Uint32,
+  Uint32,
+  Bool,
+);
+typedef _ConfigureDart = void Function(
+  Pointer<Utf8>,
+  int,
+  int,
+  int,
+  int,
+  int,
+  bool,
+);
+
+/// Streams a large file in chunks through a C++ `fcb::FileStream` (see
+/// `FCB_EXPORT_FILE_STREAM_SYMBOLS` in `file_stream.h`).
+///
+/// The file is read natively with io_uring (or `pread` where io_uring is
+/// unavailable), so nothing blocks the isolate and no byte lands on the Dart
+/// heap unless the job copies it. Chunks arrive in file order; each is a
+/// zero-copy view of a native buffer that is reused once the message is
+/// freed, so at most `buffers` chunks exist at a time and a slow consumer
+/// throttles the reads:
+///
+/// ```dart
+/// final rec = FileStreamService('libfilestream.so', '/data/run42.bin');
+/// rec.assignJob((msg) {
+///   parser.add(rec.bytes(msg));   // valid until the job returns
+///   if (rec.isLast(msg)) parser.close();
+/// });
+/// pool.addService(rec);           // starts the reader
+/// ```
+///
+/// The constructor opens the file and throws a [StateError] if it cannot.
+/// [offset] and [length] select a range (`length: 0` streams to the end).
+class FileStreamService extends Service {
+  FileStreamService(
+    super.libname,
+    String path, {
+    int offset = 0,
+    int length = 0,
+    int chunkSize = 1 << 20,
+    int readAhead = 4,
+    int buffers = 8,
+    bool useIoUring = true,
+  }) : super.exclusive() {
+    final nativePath = path.toNativeUtf8();
+    try {
+      lib
+          .lookup<NativeFunction<_ConfigureNative>>('file_stream_configure')
+          .asFunction<_ConfigureDart>()(
+        nativePath,
+        offset,
+        length,
+        chunkSize,
+        readAhead,
+        buffers,
+        useIoUring,
+      );
+      final error = lib
+          .lookup<NativeFunction<Pointer<Utf8> Function()>>('file_stream_open')
+          .asFunction<Pointer<Utf8> Function()>()();
+      if (error != nullptr) {
+        throw StateError('$libname: ${error.toDartString()}');
+      }
+    } catch (_) {
+      dispose();
+      rethrow;
+    } finally {
+      calloc.free(nativePath);
+    }
+  }
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'get_msg_bytes',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _getLen = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'get_msg_len',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _offset = lib
+      .lookup<NativeFunction<Uint64 Function(Pointer<BackendMsg>)>>(
+        'file_chunk_offset',
+      )
+      .asFunction();
+  late final bool Function(Pointer<BackendMsg>) _last = lib
+      .lookup<NativeFunction<Bool Function(Pointer<BackendMsg>)>>(
+        'file_chunk_last',
+      )
+      .asFunction();
+  late final int Function() _size = lib
+      .lookup<NativeFunction<Uint64 Function()>>('file_stream_size')
+      .asFunction();
+  late final int Function() _backend = lib
+      .lookup<NativeFunction<Uint32 Function()>>('file_stream_backend')
+      .asFunction();
+  late final Pointer<Utf8> Function() _error = lib
+      .lookup<NativeFunction<Pointer<Utf8> Function()>>('file_stream_error')
+      .asFunction();
+
+  /// Zero-copy view of the chunk carried by [msg].
+  ///
+  /// Valid only until the message is freed.
+  Uint8List bytes(Pointer<BackendMsg> msg) =>
+      _getBytes(msg).asTypedList(_getLen(msg));
+
+  /// File offset of the first byte of [msg].
+  int offset(Pointer<BackendMsg> msg) => _offset(msg);
+
+  /// Whether [msg] is the last chunk of the requested range.
+  ///
+  /// Every run that is not stopped ends with one; it is empty if the range
+  /// was empty or a read error ([error]) cut it short.
+  bool isLast(Pointer<BackendMsg> msg) => _last(msg);
+
+  /// Size of the file in bytes.
+  int get fileSize => _size();
+
+  /// How the current or last run read the file.
+  FileStreamBackend get backend => FileStreamBackend.values[_backend()];
+
+  /// The read error that ended the last run early, or `null`.
+  String? get error {
+    final text = _error();
+    return text == nullptr ? null : text.toDartString();
+  }
+}
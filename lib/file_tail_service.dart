@@ -0,0 +1,157 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+typedef _ConfigureNative = Bool Function(Uint32, Uint32, Bool);
+
+/// One batch of lines from a [FileTailService]: a view over the packed
+/// buffer built by the C++ `fcb::FileTail` (see `LineBatchHeader` in
+/// `file_tail.h`).
+///
+/// Nothing is decoded up front: [line] is a zero-copy view and `this[i]`
+/// decodes a single line on demand.
+class LineBatch {
+  /// Wraps a packed line-batch [buffer].
+  ///
+  /// Views taken from [FileTailService.bytes] are valid only until the
+  /// message is freed; keep `LineBatch(Uint8List.fromList(bytes))` instead.
+  LineBatch(this.buffer)
+      : file = _header(buffer).getUint32(0, Endian.host),
+        length = _header(buffer).getUint32(4, Endian.host),
+        fileOffset = _header(buffer).getUint64(16, Endian.host) {
+    final header = _header(buffer);
+    final bytesLen = header.getUint32(8, Endian.host);
+    final offsetsAt = header.getUint32(12, Endian.host);
+    _bytes = Uint8List.sublistView(buffer, _headerSize, _headerSize + bytesLen);
+    _starts = buffer.buffer.asUint32List(
+      buffer.offsetInBytes + offsetsAt,
+      length + 1,
+    );
+  }
+
+  static const _headerSize = 24;
+
+  static ByteData _header(Uint8List buffer) =>
+      ByteData.sublistView(buffer, 0, _headerSize);
+
+  /// The packed buffer.
+  final Uint8List buffer;
+
+  /// Index of the tailed path, in the order passed to [FileTailService].
+  final int file;
+
+  /// Number of lines in the batch.
+  final int length;
+
+  /// File offset of the first line.
+  final int fileOffset;
+
+  late final Uint8List _bytes;
+  late final Uint32List _starts;
+
+  /// Raw bytes of line [i], without its trailing `'\n'`.
+  Uint8List line(int i) {
+    final start = _starts[i];
+    var end = _starts[i + 1];
+    if (end > start && _bytes[end - 1] == 0x0A) end--;
+    return Uint8List.sublistView(_bytes, start, end);
+  }
+
+  /// Line [i] decoded as UTF-8 (malformed sequences are replaced).
+  String operator [](int i) => utf8.decode(line(i), allowMalformed: true);
+}
+
+/// A [Service] backed by a C++ `fcb::FileTail` (see
+/// `FCB_EXPORT_FILE_TAIL_SYMBOLS` in `file_tail.h`): tails growing log files
+/// and delivers their new lines in batches.
+///
+/// The native thread sleeps on inotify, reads new data in blocks of up to
+/// [block] bytes and splits it with a SIMD newline search, so Dart gets one
+/// message per block instead of one FFI call or String per line:
+///
+/// ```dart
+/// final tail = FileTailService('libtail.so', ['/var/log/app.log']);
+/// tail.assignJob((msg) {
+///   final batch = tail.lines(msg);
+///   for (var i = 0; i < batch.length; i++) {
+///     final line = batch.line(i);   // empty for a blank line
+///     if (line.isNotEmpty && line.first == 0x45) errors.add(batch[i]);
+///   }
+/// });
+/// pool.addService(tail);
+/// ```
+///
+/// Only lines written after the service starts are delivered unless
+/// [fromStart] is set. A line still being written is held back until its
+/// `'\n'` arrives; lines longer than [maxLine] are cut into pieces. Files that
+/// do not exist yet, and files rotated or recreated under the same path, are
+/// picked up from their start; a truncated file is read again from offset 0.
+class FileTailService extends Service {
+  FileTailService(
+    super.libname,
+    List<String> paths, {
+    int block = 1 << 20,
+    int maxLine = 1 << 20,
+    bool fromStart = false,
+  }) : super.exclusive() {
+    try {
+      final configured = lib
+          .lookup<NativeFunction<_ConfigureNative>>('file_tail_configure')
+          .asFunction<bool Function(int, int, bool)>()(
+        block,
+        maxLine,
+        fromStart,
+      );
+      if (!configured) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      final addPath = lib
+          .lookup<NativeFunction<Uint32 Function(Pointer<Utf8>)>>(
+            'file_tail_add_path',
+          )
+          .asFunction<int Function(Pointer<Utf8>)>();
+      for (final path in paths) {
+        final nativePath = path.toNativeUtf8();
+        try {
+          addPath(nativePath);
+        } finally {
+          calloc.free(nativePath);
+        }
+      }
+    } catch (_) {
+      dispose();
+      rethrow;
+    }
+  }
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'get_msg_bytes',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _getLen = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'get_msg_len',
+      )
+      .asFunction();
+  late final Pointer<Utf8> Function() _simdPath = lib
+      .lookup<NativeFunction<Pointer<Utf8> Function()>>('file_tail_simd_path')
+      .asFunction();
+
+  /// Zero-copy view of the packed batch carried by [msg].
+  ///
+  /// Valid only until the message is freed.
+  Uint8List bytes(Pointer<BackendMsg> msg) =>
+      _getBytes(msg).asTypedList(_getLen(msg));
+
+  /// The lines carried by [msg]; valid only until the message is freed.
+  LineBatch lines(Pointer<BackendMsg> msg) => LineBatch(bytes(msg));
+
+  /// The newline search in use: `avx2`, `sse2`, `neon` or `scalar`.
+  String get simdPath => _simdPath().toDartString();
+}
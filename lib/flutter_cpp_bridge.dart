@@ -1,11 +1,44 @@
 /// A Flutter package that simplifies calling C++ code via FFI.
 ///
-/// The three main building blocks are:
+/// The main building blocks are:
 /// - [Service]: base class to wrap a C++ shared library
 /// - [ServicePool]: manages multiple services with periodic polling
+/// - [ServiceRegistry]: lists the services loaded natively and builds them
 /// - [StandaloneService]: a self-starting service that runs independently
+/// - [BusBridge]: Dart's side of the in-process topic bus between services
+/// - [FileStreamService]: a large file streamed in chunks via io_uring
+/// - [FileTailService]: new lines of growing log files, in packed batches
+/// - [FrameService]: display-ready RGBA frames from a native pipeline
+/// - [HistoryService]: windowed reads from a native ring of recent samples
+/// - [JsonIngestService]: JSON parsed natively into typed POD records
+/// - [MappedFileService]: zero-copy random access to a memory-mapped file
+/// - [MemoryBudget]: a native memory bound shared by several services
+/// - [PostedBytesService]: byte buffers posted straight to a `ReceivePort`
+/// - [SerialIngestService]: serial / RS-485 ports framed natively
+/// - [TimeSeriesService]: decimated time-range queries on a native store
+/// - [UdpIngestService]: UDP datagrams received in batches with `recvmmsg`
+/// - [UnixIngestService]: local producers over SOCK_SEQPACKET, memfd payloads
+/// - [ZmqIngestService]: a ZMQ SUB / PULL / DISH feed configured from Dart
+/// - [ZmqDemux]: one ZMQ socket routed into several channel services
+/// - [ZmqPublisherService]: outbound ZMQ sent from a native thread
 library;
 
+export 'bus_service.dart';
+export 'file_stream_service.dart';
+export 'file_tail_service.dart';
+export 'frame_service.dart';
+export 'history_service.dart';
+export 'json_ingest_service.dart';
+export 'mapped_file_service.dart';
+export 'memory_budget.dart';
+export 'posted_bytes_service.dart';
+export 'serial_ingest_service.dart';
 export 'service.dart';
 export 'service_pool.dart';
+export 'service_registry.dart';
 export 'standalone_service.dart';
+export 'time_series_service.dart';
+export 'udp_ingest_service.dart';
+export 'unix_ingest_service.dart';
+export 'zmq_ingest_service.dart';
+export 'zmq_publisher_service.dart';
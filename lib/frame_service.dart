@@ -0,0 +1,72 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'service.dart';
+
+/// A [Service] whose messages are RGBA8888 frames produced by a C++
+/// `fcb::FrameQueue` (see `FCB_EXPORT_FRAME_SYMBOLS` in
+/// `frame_processing.h`).
+///
+/// The frames are already cropped, scaled and colour-converted natively, so
+/// they can be handed straight to the engine:
+///
+/// ```dart
+/// final camera = FrameService('libcamera.so');
+/// camera.assignJob((msg) {
+///   ui.decodeImageFromPixels(
+///     Uint8List.fromList(camera.pixels(msg)),   // copy: outlives the job
+///     camera.width(msg),
+///     camera.height(msg),
+///     ui.PixelFormat.rgba8888,
+///     (image) => frame.value = image,
+///     rowBytes: camera.stride(msg),
+///   );
+/// });
+/// ```
+class FrameService extends Service {
+  FrameService(super.libname) {
+    _getBytes = lib
+        .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+          'get_msg_bytes',
+        )
+        .asFunction();
+    _getLen = lib
+        .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+          'get_msg_len',
+        )
+        .asFunction();
+    width = lib
+        .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+          'get_frame_width',
+        )
+        .asFunction();
+    height = lib
+        .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+          'get_frame_height',
+        )
+        .asFunction();
+    stride = lib
+        .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+          'get_frame_stride',
+        )
+        .asFunction();
+  }
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes;
+  late final int Function(Pointer<BackendMsg>) _getLen;
+
+  /// Frame width in pixels.
+  late final int Function(Pointer<BackendMsg>) width;
+
+  /// Frame height in pixels.
+  late final int Function(Pointer<BackendMsg>) height;
+
+  /// Bytes per row.
+  late final int Function(Pointer<BackendMsg>) stride;
+
+  /// Zero-copy view of the RGBA pixels.
+  ///
+  /// Valid only for the duration of the [assignJob] callback.
+  Uint8List pixels(Pointer<BackendMsg> msg) =>
+      _getBytes(msg).asTypedList(_getLen(msg));
+}
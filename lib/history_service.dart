@@ -0,0 +1,123 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Mirror of the C++ `fcb::History<T>::View` struct filled by `read_view`.
+///
+/// Two contiguous segments of the native ring; [second] is empty
+/// ([secondCount] == 0) unless the requested window wraps around. Counts are
+/// in samples, not bytes.
+final class HistoryView extends Struct {
+  external Pointer<Void> first;
+
+  @Uint32()
+  external int firstCount;
+
+  external Pointer<Void> second;
+
+  @Uint32()
+  external int secondCount;
+
+  /// Sequence number of the first sample in [first].
+  @Uint64()
+  external int firstSeq;
+}
+
+/// A [Service] backed by a C++ `fcb::History<T>` (see
+/// `FCB_EXPORT_HISTORY_SYMBOLS`): a fixed-capacity native ring holding the
+/// last [capacity] samples.
+///
+/// Instead of accumulating every message in a Dart list, widgets pull exactly
+/// the window they render:
+///
+/// ```dart
+/// final svc = HistoryService('libsensor.so');
+/// svc.assignJob((_) => chart.markNeedsPaint());   // coalesced "new data"
+///
+/// // in paint():
+/// final view = svc.view(svc.endSeq - 500, 500);
+/// final a = view.first.cast<Float>().asTypedList(view.firstCount);
+/// final b = view.second.cast<Float>().asTypedList(view.secondCount);
+/// // … draw a then b …
+/// if (!svc.isIntact(view)) { /* writer lapped us: redraw next frame */ }
+/// ```
+///
+/// The message passed to [assignJob] is a pointer to a `uint64_t` holding
+/// [endSeq] at the time of the last push; read it with
+/// `msg.cast<Uint64>().value` if needed.
+class HistoryService extends Service {
+  HistoryService(super.libname) {
+    _beginSeq = lib
+        .lookup<NativeFunction<Uint64 Function()>>('history_begin_seq')
+        .asFunction();
+    _endSeq = lib
+        .lookup<NativeFunction<Uint64 Function()>>('history_end_seq')
+        .asFunction();
+    capacity = lib
+        .lookup<NativeFunction<Uint32 Function()>>('history_capacity')
+        .asFunction<int Function()>()();
+    sampleSize = lib
+        .lookup<NativeFunction<Uint32 Function()>>('history_sample_size')
+        .asFunction<int Function()>()();
+    _readRange = lib
+        .lookup<
+            NativeFunction<Uint32 Function(Uint64, Uint32, Pointer<Void>)>>(
+          'read_range',
+        )
+        .asFunction();
+    _readView = lib
+        .lookup<
+            NativeFunction<
+                Void Function(Uint64, Uint32, Pointer<HistoryView>)>>(
+          'read_view',
+        )
+        .asFunction();
+  }
+
+  late final int Function() _beginSeq;
+  late final int Function() _endSeq;
+  late final int Function(int, int, Pointer<Void>) _readRange;
+  late final void Function(int, int, Pointer<HistoryView>) _readView;
+  Pointer<HistoryView>? _view;
+
+  /// Ring size in samples.
+  late final int capacity;
+
+  /// `sizeof(T)` of the C++ sample type, in bytes.
+  late final int sampleSize;
+
+  /// Sequence number of the oldest sample still held by the ring.
+  int get beginSeq => _beginSeq();
+
+  /// One past the sequence number of the newest sample.
+  int get endSeq => _endSeq();
+
+  /// Copies up to [count] samples starting at [startSeq] into [out], which
+  /// must hold at least `count * sampleSize` bytes. A [startSeq] older than
+  /// [beginSeq] is clamped. Returns the number of samples copied.
+  int readRange(int startSeq, int count, Pointer<Void> out) =>
+      _readRange(startSeq < 0 ? 0 : startSeq, count, out);
+
+  /// Zero-copy window of up to [count] samples starting at [startSeq].
+  ///
+  /// The returned struct is reused by the next call. Its segments point into
+  /// the native ring and remain meaningful while [isIntact] is `true`.
+  HistoryView view(int startSeq, int count) {
+    final view = _view ??= calloc<HistoryView>();
+    _readView(startSeq < 0 ? 0 : startSeq, count, view);
+    return view.ref;
+  }
+
+  /// Whether the samples referenced by [view] have not been overwritten yet.
+  bool isIntact(HistoryView view) => beginSeq <= view.firstSeq;
+
+  @override
+  void dispose() {
+    super.dispose();
+    final view = _view;
+    if (view != null) calloc.free(view);
+    _view = null;
+  }
+}
@@ -0,0 +1,211 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Field types of a [JsonIngestService] mapping; mirrors the C++
+/// `fcb::JsonType` enum (json_ingest.h).
+enum JsonFieldType { boolean, int32, int64, float32, float64, string }
+
+/// One mapped field: where a JSON pointer's value lives in each record.
+class JsonField {
+  const JsonField._(this.pointer, this.index, this.type, this.offset);
+
+  /// The JSON pointer (RFC 6901) the field is read from, e.g. `/sensor/temp`.
+  final String pointer;
+
+  /// Position in the mapping; also the field's presence bit.
+  final int index;
+
+  final JsonFieldType type;
+
+  /// Byte offset within a record.
+  final int offset;
+}
+
+/// The records of one batch converted by a [JsonIngestService]: a view over
+/// the POD buffer built by the C++ `fcb::JsonIngest` (see `JsonBatchHeader`
+/// in `json_ingest.h`).
+///
+/// Getters return `null` when the document had no value of the field's type
+/// at its pointer.
+class JsonRecordBatch {
+  /// Wraps a POD batch [buffer].
+  ///
+  /// Views taken from [JsonIngestService.bytes] are valid only until the
+  /// message is freed; keep `JsonRecordBatch(Uint8List.fromList(bytes))`
+  /// instead.
+  JsonRecordBatch(Uint8List buffer)
+      : this._(buffer, ByteData.sublistView(buffer));
+
+  JsonRecordBatch._(this.buffer, this._data)
+      : length = _data.getUint32(0, Endian.host),
+        _recordSize = _data.getUint32(4, Endian.host),
+        _stringsAt = _data.getUint32(8, Endian.host);
+
+  static const _headerSize = 16;
+
+  /// The POD buffer.
+  final Uint8List buffer;
+
+  /// Number of records in the batch.
+  final int length;
+
+  final ByteData _data;
+  final int _recordSize;
+  final int _stringsAt;
+
+  int _at(int i, JsonField field) =>
+      _headerSize + i * _recordSize + field.offset;
+
+  /// Whether record [i] has a value for [field].
+  bool has(int i, JsonField field) {
+    final present = _data.getUint64(_headerSize + i * _recordSize, Endian.host);
+    return (present >> field.index) & 1 != 0;
+  }
+
+  /// A [JsonFieldType.boolean] field of record [i].
+  bool? getBool(int i, JsonField field) {
+    _check(field, JsonFieldType.boolean);
+    return has(i, field) ? _data.getUint8(_at(i, field)) != 0 : null;
+  }
+
+  /// A [JsonFieldType.int32] or [JsonFieldType.int64] field of record [i].
+  int? getInt(int i, JsonField field) {
+    if (field.type == JsonFieldType.int32) {
+      return has(i, field) ? _data.getInt32(_at(i, field), Endian.host) : null;
+    }
+    _check(field, JsonFieldType.int64);
+    return has(i, field) ? _data.getInt64(_at(i, field), Endian.host) : null;
+  }
+
+  /// A [JsonFieldType.float32] or [JsonFieldType.float64] field of record
+  /// [i].
+  double? getDouble(int i, JsonField field) {
+    if (field.type == JsonFieldType.float32) {
+      return has(i, field)
+          ? _data.getFloat32(_at(i, field), Endian.host)
+          : null;
+    }
+    _check(field, JsonFieldType.float64);
+    return has(i, field) ? _data.getFloat64(_at(i, field), Endian.host) : null;
+  }
+
+  /// A [JsonFieldType.string] field of record [i], decoded from UTF-8.
+  String? getString(int i, JsonField field) {
+    _check(field, JsonFieldType.string);
+    if (!has(i, field)) return null;
+    final at = _at(i, field);
+    final start = _stringsAt + _data.getUint32(at, Endian.host);
+    final end = start + _data.getUint32(at + 4, Endian.host);
+    return utf8.decode(Uint8List.sublistView(buffer, start, end));
+  }
+
+  static void _check(JsonField field, JsonFieldType type) {
+    if (field.type != type) {
+      throw ArgumentError.value(field.pointer, 'field', 'is ${field.type}');
+    }
+  }
+}
+
+/// A [Service] backed by a C++ `fcb::JsonIngest` (see
+/// `FCB_EXPORT_JSON_INGEST_SYMBOLS` in `json_ingest.h`): JSON from upstream
+/// producers is parsed with simdjson on the native worker thread and
+/// converted into fixed-size records, so the UI isolate never runs
+/// `jsonDecode`.
+///
+/// [fields] maps JSON pointers to the type each value is stored as; the
+/// mapping is sent to the library in the constructor, before the service is
+/// started:
+///
+/// ```dart
+/// final feed = JsonIngestService('libjsonfeed.so', {
+///   '/id': JsonFieldType.int64,
+///   '/sensor/temp': JsonFieldType.float64,
+///   '/sensor/name': JsonFieldType.string,
+/// });
+/// final temp = feed.field('/sensor/temp');
+/// feed.assignJob((msg) {
+///   final batch = feed.records(msg);
+///   for (var i = 0; i < batch.length; i++) {
+///     plot(batch.getDouble(i, temp));
+///   }
+/// });
+/// pool.addService(feed);
+/// ```
+///
+/// The constructor throws an [ArgumentError] if a pointer does not start
+/// with `/` or the mapping has more than 64 fields, and a [StateError] while
+/// an earlier wrapper of the same library is still running.
+class JsonIngestService extends Service {
+  JsonIngestService(super.libname, Map<String, JsonFieldType> fields)
+      : super.exclusive() {
+    try {
+      final cleared = lib
+          .lookup<NativeFunction<Bool Function()>>('json_ingest_clear_fields')
+          .asFunction<bool Function()>()();
+      if (!cleared) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      final addField = lib
+          .lookup<NativeFunction<Int32 Function(Pointer<Utf8>, Uint32)>>(
+            'json_ingest_add_field',
+          )
+          .asFunction<int Function(Pointer<Utf8>, int)>();
+      for (final entry in fields.entries) {
+        final nativePointer = entry.key.toNativeUtf8();
+        try {
+          final offset = addField(nativePointer, entry.value.index);
+          if (offset < 0) {
+            throw ArgumentError.value(entry.key, 'fields', 'cannot be mapped');
+          }
+          _fields[entry.key] =
+              JsonField._(entry.key, _fields.length, entry.value, offset);
+        } finally {
+          calloc.free(nativePointer);
+        }
+      }
+    } catch (_) {
+      dispose();
+      rethrow;
+    }
+  }
+
+  final _fields = <String, JsonField>{};
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'get_msg_bytes',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _getLen = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'get_msg_len',
+      )
+      .asFunction();
+  late final int Function() _errors = lib
+      .lookup<NativeFunction<Uint64 Function()>>('json_ingest_errors')
+      .asFunction();
+
+  /// The mapped field read from [pointer].
+  JsonField field(String pointer) =>
+      _fields[pointer] ??
+      (throw ArgumentError.value(pointer, 'pointer', 'is not mapped'));
+
+  /// Zero-copy view of the POD batch carried by [msg].
+  ///
+  /// Valid only until the message is freed.
+  Uint8List bytes(Pointer<BackendMsg> msg) =>
+      _getBytes(msg).asTypedList(_getLen(msg));
+
+  /// The records carried by [msg]; valid only until the message is freed.
+  JsonRecordBatch records(Pointer<BackendMsg> msg) =>
+      JsonRecordBatch(bytes(msg));
+
+  /// Documents that failed to parse so far.
+  int get errors => _errors();
+}
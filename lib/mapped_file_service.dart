@@ -0,0 +1,120 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Access pattern hint for a [MappedFileService] (C++
+/// `fcb::MappedFileAccess`, applied with `madvise`).
+enum MappedFileAccess {
+  /// Default kernel read-ahead.
+  normal,
+
+  /// Aggressive read-ahead; pages behind are dropped early (playback).
+  sequential,
+
+  /// No read-ahead (scrubbing, index lookups).
+  random,
+}
+
+typedef _ConfigureNative = Bool Function(Pointer<Utf8>, Bool, Uint32);
+typedef _ViewNative = Pointer<Uint8> Function(Uint64, Uint64);
+typedef _AdviseNative = Bool Function(Uint64, Uint64, Uint32);
+typedef _PrefetchNative = Void Function(Uint64, Uint64);
+
+/// Random access to a huge file through a C++ `fcb::MappedFile` (see
+/// `FCB_EXPORT_MAPPED_FILE_SYMBOLS` in `mapped_file.h`).
+///
+/// The file is memory-mapped once; [view] returns any region as a zero-copy
+/// [Uint8List], and only the pages actually read are loaded from disk. Tell
+/// the native prefetch thread where the UI goes next so those pages are
+/// already in the page cache when the frame is built:
+///
+/// ```dart
+/// final rec = MappedFileService('libmappedfile.so', '/data/run42.bin',
+///     access: MappedFileAccess.random);
+/// void showFrame(int index) {
+///   final bytes = rec.view(index * frameSize, frameSize);
+///   render(bytes);
+///   rec.prefetch((index + 1) * frameSize, 8 * frameSize);
+/// }
+/// // ...
+/// rec.dispose();   // unmaps: views must not be used afterwards
+/// ```
+///
+/// The constructor maps the file, then starts the prefetch thread; it throws
+/// a [StateError] if the file cannot be mapped.
+/// Set [populate] to fault the whole file in up front (`MAP_POPULATE`).
+class MappedFileService extends Service {
+  MappedFileService(
+    super.libname,
+    String path, {
+    bool populate = false,
+    MappedFileAccess access = MappedFileAccess.normal,
+  }) : super.exclusive() {
+    final nativePath = path.toNativeUtf8();
+    try {
+      final configured = lib
+          .lookup<NativeFunction<_ConfigureNative>>('mapped_file_configure')
+          .asFunction<bool Function(Pointer<Utf8>, bool, int)>()(
+        nativePath,
+        populate,
+        access.index,
+      );
+      if (!configured) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      final error = lib
+          .lookup<NativeFunction<Pointer<Utf8> Function()>>('mapped_file_open')
+          .asFunction<Pointer<Utf8> Function()>()();
+      if (error != nullptr) {
+        throw StateError('$libname: ${error.toDartString()}');
+      }
+      startService();
+    } catch (_) {
+      dispose();
+      rethrow;
+    } finally {
+      calloc.free(nativePath);
+    }
+  }
+
+  late final Pointer<Uint8> Function(int, int) _view = lib
+      .lookup<NativeFunction<_ViewNative>>('mapped_file_view')
+      .asFunction();
+  late final bool Function(int, int, int) _advise = lib
+      .lookup<NativeFunction<_AdviseNative>>('mapped_file_advise')
+      .asFunction();
+  late final void Function(int, int) _prefetch = lib
+      .lookup<NativeFunction<_PrefetchNative>>('mapped_file_prefetch')
+      .asFunction();
+  late final int Function() _size = lib
+      .lookup<NativeFunction<Uint64 Function()>>('mapped_file_size')
+      .asFunction();
+
+  /// Size of the mapped file in bytes.
+  int get length => _size();
+
+  /// Zero-copy view of [length] bytes at [offset].
+  ///
+  /// Throws a [RangeError] if the region is not inside the file. Valid until
+  /// [dispose].
+  Uint8List view(int offset, int length) {
+    final ptr = _view(offset, length);
+    if (ptr == nullptr) {
+      throw RangeError('$offset + $length is outside the $libname mapping');
+    }
+    return ptr.asTypedList(length);
+  }
+
+  /// Applies an access hint to a region (`length: 0` = to the end of the
+  /// file), or to the whole file by default.
+  bool advise(MappedFileAccess access, {int offset = 0, int length = 0}) =>
+      _advise(offset, length, access.index);
+
+  /// Asks the native prefetch thread to start loading a region. Returns
+  /// immediately; only the most recent requests are kept.
+  void prefetch(int offset, int length) => _prefetch(offset, length);
+}
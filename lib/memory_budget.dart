@@ -0,0 +1,64 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+/// Mirror of the C++ `fcb::MemoryBudget` struct (service_helpers.h).
+final class _NativeMemoryBudget extends Struct {
+  @Int64()
+  external int used;
+
+  @Int64()
+  external int limit;
+
+  @Uint32()
+  external int totalWeight;
+
+  @Uint64()
+  external int evicted;
+}
+
+/// A byte budget shared by the native queues of several services.
+///
+/// Each service is its own shared library, so the counters live in native
+/// memory owned by this object; every attached service (see
+/// [Service.attachMemoryBudget]) updates them as messages are queued and
+/// freed. When [usedBytes] exceeds [limitBytes], a service holding more than
+/// its weighted share applies its C++ `fcb::MemoryPolicy` (drop oldest,
+/// coalesce, or spill) to the messages it has not yet delivered.
+///
+/// [ServicePool] creates one when given `memoryBudgetBytes`.
+class MemoryBudget {
+  /// Allocates a budget of [limitBytes]; `0` means unlimited (accounting
+  /// only).
+  MemoryBudget(int limitBytes) {
+    _native.ref.limit = limitBytes;
+  }
+
+  final Pointer<_NativeMemoryBudget> _native = calloc<_NativeMemoryBudget>();
+
+  /// Address handed to the C `set_memory_budget` symbol.
+  Pointer<Void> get pointer => _native.cast();
+
+  /// The budget in bytes; may be changed at any time.
+  int get limitBytes => _native.ref.limit;
+  set limitBytes(int bytes) => _native.ref.limit = bytes;
+
+  /// Bytes currently held by the queues of all attached services.
+  int get usedBytes => _native.ref.used;
+
+  /// Sum of the weights of the attached services.
+  int get totalWeight => _native.ref.totalWeight;
+
+  /// Messages evicted so far by the attached services.
+  int get evicted => _native.ref.evicted;
+
+  /// Frees the native counters. Every service must have been detached (or
+  /// disposed) first.
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    calloc.free(_native);
+  }
+
+  bool _disposed = false;
+}
@@ -0,0 +1,71 @@
+import 'dart:ffi';
+import 'dart:isolate';
+import 'dart:typed_data';
+
+import 'service.dart';
+
+/// A byte-buffer [Service] backed by a C++ `fcb::PostedBytesQueue` (see
+/// `FCB_EXPORT_POSTED_BYTES_SYMBOLS` in `dart_port.h`).
+///
+/// [assignBytesJob] registers a [ReceivePort] with the C++ side, which then
+/// posts each message straight to it with `Dart_PostCObject`: no
+/// `get_next_message` / `free_message` round trip. Small payloads arrive as
+/// a copied [Uint8List]; large ones as an external [Uint8List] backed by the
+/// native buffer, which is returned to the native pool when garbage
+/// collected. Either way the job may keep the data beyond the callback.
+///
+/// ```dart
+/// final svc = PostedBytesService('libtelemetry.so');
+/// svc.assignBytesJob((bytes) => frames.add(Message(bytes)));
+/// pool.addService(svc);
+/// ```
+///
+/// The pointer-based [assignJob] keeps working: until a port is registered
+/// the C++ side falls back to its queue.
+class PostedBytesService extends Service {
+  PostedBytesService(super.libname) {
+    final initDartApi = lib
+        .lookup<NativeFunction<IntPtr Function(Pointer<Void>)>>(
+          'fcb_init_dart_api',
+        )
+        .asFunction<int Function(Pointer<Void>)>();
+    if (initDartApi(NativeApi.initializeApiDLData) != 0) {
+      throw StateError('$libname: Dart native API version mismatch');
+    }
+    _setMessagePort = lib
+        .lookup<NativeFunction<Void Function(Int64)>>('set_message_port')
+        .asFunction();
+  }
+
+  late final void Function(int) _setMessagePort;
+  ReceivePort? _port;
+
+  /// Registers [job] for every message posted by the C++ side.
+  ///
+  /// Only one bytes job may be active at a time; call [cancelBytesJob] first
+  /// to replace it.
+  void assignBytesJob(void Function(Uint8List) job) {
+    assert(_port == null, 'assignBytesJob called twice on the same Service');
+    final port = ReceivePort('$libname messages');
+    port.listen((message) => job(message as Uint8List));
+    _port = port;
+    _setMessagePort(port.sendPort.nativePort);
+    setConsumerActive(true);
+  }
+
+  /// Unregisters the port; the C++ side falls back to its queue.
+  void cancelBytesJob() {
+    final port = _port;
+    if (port == null) return;
+    _setMessagePort(0);
+    port.close();
+    _port = null;
+    setConsumerActive(false);
+  }
+
+  @override
+  void dispose() {
+    cancelBytesJob();
+    super.dispose();
+  }
+}
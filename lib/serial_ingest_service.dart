@@ -0,0 +1,211 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Parity of a [SerialIngestService] port; mirrors `fcb::SerialParity`.
+enum SerialParity { none, even, odd }
+
+/// Built-in framers of a [SerialIngestService]; mirrors `fcb::SerialFraming`
+/// (serial_ingest.h).
+enum SerialFraming {
+  /// Frames end with a delimiter byte (`'\n'` by default).
+  delimiter,
+
+  /// Frames start with their length (1, 2 or 4 bytes).
+  lengthPrefix,
+
+  /// COBS-encoded frames, each terminated by `0x00`.
+  cobs,
+
+  /// Every read is one frame; Dart does the framing.
+  raw,
+}
+
+typedef _ConfigureNative = Bool Function(
+  Pointer<Utf8>,
+  Uint32,
+  Uint8,
+  Uint8,
+  Uint8,
+  Bool,
+  Bool,
+);
+typedef _ConfigureDart = bool Function(
+  Pointer<Utf8>,
+  int,
+  int,
+  int,
+  int,
+  bool,
+  bool,
+);
+typedef _FramingNative = Void Function(Uint8, Uint8, Uint32, Bool, Uint32);
+typedef _FramingDart = void Function(int, int, int, bool, int);
+
+/// The frames of one batch received by a [SerialIngestService]: a view over
+/// the packed buffer built by the C++ `fcb::SerialIngest` (see
+/// `SerialBatchHeader` in `serial_ingest.h`).
+class SerialBatch {
+  /// Wraps a packed serial batch [buffer].
+  ///
+  /// Views taken from [SerialIngestService.bytes] are valid only until the
+  /// message is freed; keep `SerialBatch(Uint8List.fromList(bytes))`
+  /// instead.
+  SerialBatch(Uint8List buffer) : this._(buffer, ByteData.sublistView(buffer));
+
+  SerialBatch._(this.buffer, ByteData header)
+      : length = header.getUint32(0, Endian.host),
+        timestampNs = header.getInt64(8, Endian.host),
+        _starts = buffer.buffer.asUint32List(
+          buffer.offsetInBytes + header.getUint32(4, Endian.host),
+          header.getUint32(0, Endian.host) + 1,
+        );
+
+  static const _headerSize = 16;
+
+  /// The packed buffer.
+  final Uint8List buffer;
+
+  /// Number of frames in the batch.
+  final int length;
+
+  /// When the read that completed the batch returned, in nanoseconds since
+  /// the epoch.
+  final int timestampNs;
+
+  final Uint32List _starts;
+
+  /// Zero-copy view of frame [i].
+  Uint8List operator [](int i) => Uint8List.sublistView(
+        buffer,
+        _headerSize + _starts[i],
+        _headerSize + _starts[i + 1],
+      );
+}
+
+/// A [Service] backed by a C++ `fcb::SerialIngest` (see
+/// `FCB_EXPORT_SERIAL_INGEST_SYMBOLS` in `serial_ingest.h`): a serial port
+/// read in bursts by a native thread and cut into frames natively.
+///
+/// ```dart
+/// final panel = SerialIngestService('libserial.so', '/dev/ttyUSB0',
+///     baud: 57600, framing: SerialFraming.cobs, maxFrame: 512);
+/// panel.assignJob((msg) {
+///   final batch = panel.frames(msg);
+///   for (var i = 0; i < batch.length; i++) {
+///     decodeSensor(batch[i]);
+///   }
+/// });
+/// pool.addService(panel);
+/// ```
+///
+/// Each read waits for up to [vmin] bytes, or until the line has been quiet
+/// for [vtime] tenths of a second, so a burst arrives in one read and one
+/// message. Frames longer than [maxFrame], and corrupt ones, are dropped and
+/// counted in [dropped].
+///
+/// The port is opened and configured in the constructor, which throws a
+/// [StateError] carrying the system error if the device or a setting is
+/// rejected. If the device later disappears, it is reopened when it comes
+/// back.
+class SerialIngestService extends Service {
+  SerialIngestService(
+    super.libname,
+    String path, {
+    int baud = 115200,
+    int dataBits = 8,
+    SerialParity parity = SerialParity.none,
+    int stopBits = 1,
+    bool rtsCts = false,
+    bool rs485 = false,
+    int vmin = 255,
+    int vtime = 1,
+    int readSize = 4096,
+    SerialFraming framing = SerialFraming.delimiter,
+    int delimiter = 0x0A,
+    int lengthBytes = 2,
+    bool bigEndian = false,
+    int maxFrame = 4096,
+  }) : super.exclusive() {
+    final nativePath = path.toNativeUtf8();
+    try {
+      final configured = lib
+          .lookup<NativeFunction<_ConfigureNative>>('serial_ingest_configure')
+          .asFunction<_ConfigureDart>()(
+        nativePath,
+        baud,
+        dataBits,
+        parity.index,
+        stopBits,
+        rtsCts,
+        rs485,
+      );
+      if (!configured) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      lib
+          .lookup<NativeFunction<Void Function(Uint8, Uint8, Uint32)>>(
+            'serial_ingest_timing',
+          )
+          .asFunction<void Function(int, int, int)>()(vmin, vtime, readSize);
+      lib
+          .lookup<NativeFunction<_FramingNative>>('serial_ingest_framing')
+          .asFunction<_FramingDart>()(
+        framing.index,
+        delimiter,
+        lengthBytes,
+        bigEndian,
+        maxFrame,
+      );
+      final error = lib
+          .lookup<NativeFunction<Pointer<Utf8> Function()>>(
+            'serial_ingest_open',
+          )
+          .asFunction<Pointer<Utf8> Function()>()();
+      if (error != nullptr) {
+        throw StateError('$libname: ${error.toDartString()}');
+      }
+    } catch (_) {
+      dispose();
+      rethrow;
+    } finally {
+      calloc.free(nativePath);
+    }
+  }
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'get_msg_bytes',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _getLen = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'get_msg_len',
+      )
+      .asFunction();
+  late final int Function() _dropped = lib
+      .lookup<NativeFunction<Uint64 Function()>>('serial_ingest_dropped')
+      .asFunction();
+  late final int Function() _bytesRead = lib
+      .lookup<NativeFunction<Uint64 Function()>>('serial_ingest_bytes_read')
+      .asFunction();
+
+  /// Zero-copy view of the packed batch carried by [msg].
+  ///
+  /// Valid only until the message is freed.
+  Uint8List bytes(Pointer<BackendMsg> msg) =>
+      _getBytes(msg).asTypedList(_getLen(msg));
+
+  /// The frames carried by [msg]; valid only until the message is freed.
+  SerialBatch frames(Pointer<BackendMsg> msg) => SerialBatch(bytes(msg));
+
+  /// Frames dropped by the framer (oversized or corrupt) so far.
+  int get dropped => _dropped();
+
+  /// Bytes read from the port so far.
+  int get bytesRead => _bytesRead();
+}
@@ -1,7 +1,11 @@
 import 'dart:async';
 import 'dart:ffi';
 
+import 'package:ffi/ffi.dart';
 import 'package:flutter/foundation.dart';
+import 'package:flutter/scheduler.dart';
+
+import 'memory_budget.dart';
 
 /// Opaque type representing a message produced by a C++ service.
 ///
@@ -15,6 +19,122 @@ final class BackendMsg extends Opaque {}
 /// `set_message_callback`.
 typedef _NotifyNative = Void Function();
 
+/// Native signature of the optional `set_consumer_active` symbol.
+typedef _SetConsumerActiveNative = Void Function(Bool);
+
+/// Native signature of the optional `set_memory_budget` symbol.
+typedef _SetMemoryBudgetNative = Void Function(Pointer<Void>, Uint32);
+
+/// Native signature of the optional `get_service_stats` symbol.
+typedef _GetServiceStatsNative = Void Function(Pointer<Void>, Uint32);
+
+/// Native signature of `channel_set_memory_budget` and
+/// `channel_get_service_stats`.
+typedef _ChannelPointerIntNative = Void Function(Uint32, Pointer<Void>, Uint32);
+
+/// Native signature of the optional `set_watchdog` symbol.
+typedef _SetWatchdogNative = Void Function(Uint32, Uint32);
+
+/// Mirror of the C++ `fcb::ServiceStats` struct (service_helpers.h).
+final class _NativeServiceStats extends Struct {
+  @Int64()
+  external int bytesHeld;
+
+  @Uint64()
+  external int evicted;
+
+  @Uint64()
+  external int expired;
+
+  @Uint64()
+  external int lastSeq;
+
+  @Uint64()
+  external int ingestGaps;
+
+  @Uint64()
+  external int pending;
+
+  @Int64()
+  external int drainIdleMs;
+
+  @Int64()
+  external int beatIdleMs;
+
+  @Uint32()
+  external int alarms;
+
+  @Uint32()
+  external int reserved;
+}
+
+/// Counters reported by a service's native queue; see [Service.stats].
+@immutable
+class ServiceStats {
+  /// Creates a snapshot of the given counters.
+  const ServiceStats({
+    this.bytesHeld = 0,
+    this.evicted = 0,
+    this.expired = 0,
+    this.lastSeq = 0,
+    this.ingestGaps = 0,
+    this.pending = 0,
+    this.drainIdle = Duration.zero,
+    this.heartbeatIdle = Duration.zero,
+    this.alarms = 0,
+  });
+
+  /// [alarms] bit: Dart has a job assigned and messages are pending, but
+  /// none was taken within the stall limit (see [Service.watch]).
+  static const stalledConsumerAlarm = 1;
+
+  /// [alarms] bit: Dart has a job assigned, but the worker has neither
+  /// pushed nor sent a heartbeat within the heartbeat limit.
+  static const stuckWorkerAlarm = 2;
+
+  /// Bytes held by messages in the native queue, including those handed to
+  /// Dart but not yet freed.
+  final int bytesHeld;
+
+  /// Messages evicted by the service's memory policy.
+  final int evicted;
+
+  /// Messages dropped because their time-to-live ran out before delivery.
+  final int expired;
+
+  /// Sequence number given to the newest message (see
+  /// [Service.messageSeq]); `0` before the first one.
+  final int lastSeq;
+
+  /// Messages the upstream producer numbered but the service never
+  /// received (ZMQ high-water-mark drops, network loss, …).
+  final int ingestGaps;
+
+  /// Messages queued natively and not yet delivered to Dart.
+  final int pending;
+
+  /// Time since Dart last took a message, or since messages became pending
+  /// if that is later.
+  final Duration drainIdle;
+
+  /// Time since the native worker last pushed a message or sent a
+  /// heartbeat.
+  final Duration heartbeatIdle;
+
+  /// Watchdog alarms raised ([stalledConsumerAlarm], [stuckWorkerAlarm]);
+  /// always `0` unless the service is watched (see [Service.watch]).
+  final int alarms;
+
+  /// Messages queued natively but never delivered to Dart.
+  int get localDrops => evicted + expired;
+
+  /// Whether Dart is not keeping up: see [stalledConsumerAlarm].
+  bool get stalledConsumer => alarms & stalledConsumerAlarm != 0;
+
+  /// Whether the native worker has gone quiet: see [stuckWorkerAlarm].
+  bool get stuckWorker => alarms & stuckWorkerAlarm != 0;
+}
+
 /// Base class for a C++ shared-library service accessed through `dart:ffi`.
 ///
 /// A *service* is a shared library (`.so` / `.dll` / `.dylib`) that exports
@@ -59,7 +179,22 @@ typedef _NotifyNative = Void Function();
 /// });
 /// ```
 ///
-/// [freeMessage] is called automatically after the job returns.
+/// [freeMessage] is called automatically after the job returns. Jobs that
+/// need to `await` use [assignAsyncJob] instead.
+///
+/// ## Flow control
+///
+/// If the library exports the optional `void set_consumer_active(bool)`
+/// symbol (generated by `FCB_EXPORT_SYMBOLS`), the service is told `true`
+/// when a job is assigned and `false` when it is cancelled with [cancelJob]
+/// or the service is disposed. Producers can then pause expensive
+/// acquisition while nothing on the Dart side is listening.
+///
+/// ## Memory accounting
+///
+/// Libraries built with `FCB_EXPORT_SYMBOLS` also report the bytes held in
+/// their queue ([stats]), number every message ([messageSeq]) and can share
+/// a process-wide [MemoryBudget] with other services ([attachMemoryBudget]).
 ///
 /// ## Lifecycle
 ///
@@ -73,36 +208,191 @@ class Service {
   /// [libname] is the path passed to [DynamicLibrary.open] — typically just
   /// the file name (e.g. `"libaudio.so"`) when the library is bundled next to
   /// the executable.
-  Service(this.libname) {
+  Service(String libname) : this._(libname, null);
+
+  /// Creates a [Service] bound to channel [channel] of a library that hosts
+  /// several services (see `FCB_EXPORT_CHANNEL_SYMBOLS`), such as the
+  /// channels of a [ZmqDemux]. The `channel_*` symbols are bound instead of
+  /// the per-library ones; everything else behaves as for a plain [Service].
+  Service.channel(String libname, int channel) : this._(libname, channel);
+
+  /// Creates a [Service] for a wrapper that configures the library's one
+  /// native service (socket, path, …) after construction.
+  ///
+  /// Throws a [StateError] if that service is still running under another
+  /// wrapper, before this one takes the notification callback over. Checked
+  /// through the optional `service_running` symbol
+  /// (`FCB_EXPORT_SYMBOLS`); without it this is the plain constructor.
+  /// Once it returns the native side belongs to this wrapper, so a
+  /// constructor whose configuration then fails may [dispose] it.
+  Service.exclusive(String libname) : this._(libname, null, exclusive: true);
+
+  Service._(this.libname, this.channel, {bool exclusive = false}) {
     try {
       lib = DynamicLibrary.open(libname);
+      final ch = channel;
+
+      if (ch == null) {
+        startService = lib
+            .lookup<NativeFunction<Void Function()>>('start_service')
+            .asFunction<void Function()>();
 
-      startService = lib
-          .lookup<NativeFunction<Void Function()>>('start_service')
-          .asFunction<void Function()>();
-
-      stopService = lib
-          .lookup<NativeFunction<Void Function()>>('stop_service')
-          .asFunction<void Function()>();
-
-      getNextMessage = lib
-          .lookup<NativeFunction<Pointer<BackendMsg> Function()>>(
-            'get_next_message',
-          )
-          .asFunction<Pointer<BackendMsg> Function()>();
-
-      freeMessage = lib
-          .lookup<NativeFunction<Void Function(Pointer<BackendMsg>)>>(
-            'free_message',
-          )
-          .asFunction<void Function(Pointer<BackendMsg>)>();
-
-      _setMessageCallback = lib
-          .lookup<
-                  NativeFunction<
-                      Void Function(Pointer<NativeFunction<_NotifyNative>>)>>(
-              'set_message_callback')
-          .asFunction<void Function(Pointer<NativeFunction<_NotifyNative>>)>();
+        stopService = lib
+            .lookup<NativeFunction<Void Function()>>('stop_service')
+            .asFunction<void Function()>();
+
+        getNextMessage = lib
+            .lookup<NativeFunction<Pointer<BackendMsg> Function()>>(
+              'get_next_message',
+            )
+            .asFunction<Pointer<BackendMsg> Function()>();
+
+        freeMessage = lib
+            .lookup<NativeFunction<Void Function(Pointer<BackendMsg>)>>(
+              'free_message',
+            )
+            .asFunction<void Function(Pointer<BackendMsg>)>();
+
+        _setMessageCallback = lib
+            .lookup<
+                    NativeFunction<
+                        Void Function(Pointer<NativeFunction<_NotifyNative>>)>>(
+                'set_message_callback')
+            .asFunction<
+                void Function(Pointer<NativeFunction<_NotifyNative>>)>();
+      } else {
+        final start = lib
+            .lookup<NativeFunction<Void Function(Uint32)>>(
+              'channel_start_service',
+            )
+            .asFunction<void Function(int)>();
+        startService = () => start(ch);
+
+        final stop = lib
+            .lookup<NativeFunction<Void Function(Uint32)>>(
+              'channel_stop_service',
+            )
+            .asFunction<void Function(int)>();
+        stopService = () => stop(ch);
+
+        final next = lib
+            .lookup<NativeFunction<Pointer<BackendMsg> Function(Uint32)>>(
+              'channel_get_next_message',
+            )
+            .asFunction<Pointer<BackendMsg> Function(int)>();
+        getNextMessage = () => next(ch);
+
+        final free = lib
+            .lookup<
+                NativeFunction<Void Function(Uint32, Pointer<BackendMsg>)>>(
+              'channel_free_message',
+            )
+            .asFunction<void Function(int, Pointer<BackendMsg>)>();
+        freeMessage = (msg) => free(ch, msg);
+
+        final setCallback = lib
+            .lookup<
+                    NativeFunction<
+                        Void Function(
+                            Uint32, Pointer<NativeFunction<_NotifyNative>>)>>(
+                'channel_set_message_callback')
+            .asFunction<
+                void Function(int, Pointer<NativeFunction<_NotifyNative>>)>();
+        _setMessageCallback = (cb) => setCallback(ch, cb);
+      }
+
+      // Optional: hand-written services may not implement flow control.
+      final prefix = ch == null ? '' : 'channel_';
+      if (lib.providesSymbol('${prefix}set_consumer_active')) {
+        if (ch == null) {
+          _setConsumerActive = lib
+              .lookup<NativeFunction<_SetConsumerActiveNative>>(
+                'set_consumer_active',
+              )
+              .asFunction<void Function(bool)>();
+        } else {
+          final setActive = lib
+              .lookup<NativeFunction<Void Function(Uint32, Bool)>>(
+                'channel_set_consumer_active',
+              )
+              .asFunction<void Function(int, bool)>();
+          _setConsumerActive = (active) => setActive(ch, active);
+        }
+      }
+
+      if (lib.providesSymbol('${prefix}set_memory_budget')) {
+        if (ch == null) {
+          _setMemoryBudget = lib
+              .lookup<NativeFunction<_SetMemoryBudgetNative>>(
+                'set_memory_budget',
+              )
+              .asFunction<void Function(Pointer<Void>, int)>();
+        } else {
+          final setBudget = lib
+              .lookup<NativeFunction<_ChannelPointerIntNative>>(
+                'channel_set_memory_budget',
+              )
+              .asFunction<void Function(int, Pointer<Void>, int)>();
+          _setMemoryBudget = (budget, weight) => setBudget(ch, budget, weight);
+        }
+      }
+      if (lib.providesSymbol('${prefix}get_message_seq')) {
+        if (ch == null) {
+          _getMessageSeq = lib
+              .lookup<NativeFunction<Uint64 Function(Pointer<BackendMsg>)>>(
+                'get_message_seq',
+              )
+              .asFunction<int Function(Pointer<BackendMsg>)>();
+        } else {
+          final getSeq = lib
+              .lookup<
+                  NativeFunction<Uint64 Function(Uint32, Pointer<BackendMsg>)>>(
+                'channel_get_message_seq',
+              )
+              .asFunction<int Function(int, Pointer<BackendMsg>)>();
+          _getMessageSeq = (msg) => getSeq(ch, msg);
+        }
+      }
+      if (lib.providesSymbol('${prefix}get_service_stats')) {
+        if (ch == null) {
+          _getServiceStats = lib
+              .lookup<NativeFunction<_GetServiceStatsNative>>(
+                'get_service_stats',
+              )
+              .asFunction<void Function(Pointer<Void>, int)>();
+        } else {
+          final getStats = lib
+              .lookup<NativeFunction<_ChannelPointerIntNative>>(
+                'channel_get_service_stats',
+              )
+              .asFunction<void Function(int, Pointer<Void>, int)>();
+          _getServiceStats = (out, size) => getStats(ch, out, size);
+        }
+      }
+      if (lib.providesSymbol('${prefix}set_watchdog')) {
+        if (ch == null) {
+          _setWatchdog = lib
+              .lookup<NativeFunction<_SetWatchdogNative>>('set_watchdog')
+              .asFunction<void Function(int, int)>();
+        } else {
+          final setWatchdog = lib
+              .lookup<NativeFunction<Void Function(Uint32, Uint32, Uint32)>>(
+                'channel_set_watchdog',
+              )
+              .asFunction<void Function(int, int, int)>();
+          _setWatchdog = (stall, beat) => setWatchdog(ch, stall, beat);
+        }
+      }
+
+      if (exclusive &&
+          lib.providesSymbol('service_running') &&
+          lib
+              .lookup<NativeFunction<Bool Function()>>('service_running')
+              .asFunction<bool Function()>()()) {
+        throw StateError(
+          '$libname: still running; dispose the previous wrapper',
+        );
+      }
 
       // NativeCallable.listener is safe to call from any thread: the C++ worker
       // posts the notification and Dart schedules _onNotify on the event loop.
@@ -128,64 +418,308 @@ class Service {
   }
 
   /// Called on the Dart event loop each time the C++ side signals a new
-  /// message. Retrieves one message and pushes it onto [_messageController].
+  /// message. Retrieves one message and hands it to the job registered with
+  /// [assignJob] — synchronously, with no per-event stream allocation — or
+  /// [assignAsyncJob], or, if there is none, to the [messages] stream.
   ///
   /// One callback invocation = one message: C++ must call `cb()` exactly once
   /// per message pushed. A drain loop is intentionally avoided here because
-  /// [_messageController] delivers asynchronously — [freeMessage] would not be
-  /// called before the next [getNextMessage], causing an infinite loop on any
+  /// [messages] delivers asynchronously — [freeMessage] would not be called
+  /// before the next [getNextMessage], causing an infinite loop on any
   /// service whose [getNextMessage] does not return `nullptr` immediately after
   /// the first call.
   void _onNotify() {
     if (_disposed) return;
+    if (drainBudget != null && _job != null) {
+      // A budgeted drain resumes after the next frame; it will pick up the
+      // message this notification is about.
+      if (!_drainScheduled) _drain();
+      return;
+    }
+    final asyncJob = _asyncJob;
+    if (asyncJob != null && _inFlight >= _maxInFlight) {
+      // Window full: leave the message in the C++ queue and replay this
+      // notification when an in-flight job completes.
+      _owedNotifications++;
+      return;
+    }
     final msg = getNextMessage();
-    if (msg != nullptr) {
-      if (_messageController.hasListener) {
-        _messageController.add(msg);
-      } else {
-        // No listener registered: free immediately to avoid a C++ memory leak.
+    if (msg == nullptr) return;
+    final job = _job;
+    if (job != null) {
+      try {
+        job(msg);
+      } finally {
         freeMessage(msg);
       }
+    } else if (asyncJob != null) {
+      _runAsync(asyncJob, msg);
+    } else if (_messageController.hasListener) {
+      _messageController.add(msg);
+    } else {
+      // No consumer registered: free immediately to avoid a C++ memory leak.
+      freeMessage(msg);
+    }
+  }
+
+  /// Runs the synchronous job on queued messages until the queue is empty or
+  /// [drainBudget] is spent, then yields to the frame scheduler.
+  void _drain() {
+    final budget = drainBudget!.inMicroseconds;
+    _drainWatch
+      ..reset()
+      ..start();
+    while (!_disposed) {
+      final job = _job;
+      if (job == null) return;
+      final msg = getNextMessage();
+      if (msg == nullptr) return;
+      try {
+        job(msg);
+      } finally {
+        freeMessage(msg);
+      }
+      if (_drainWatch.elapsedMicroseconds >= budget) {
+        budgetHits++;
+        _scheduleDrainAfterFrame();
+        return;
+      }
+    }
+  }
+
+  /// Resumes the drain after the next frame. Without frames (no binding,
+  /// as in tests and background isolates, or frames disabled while the app
+  /// is hidden) it resumes from a timer instead, so the backlog keeps
+  /// draining; the same timer covers a frame that never comes.
+  void _scheduleDrainAfterFrame() {
+    _drainScheduled = true;
+    void resume() {
+      if (!_drainScheduled) return;
+      _drainScheduled = false;
+      _drainFallback?.cancel();
+      _drainFallback = null;
+      if (!_disposed && _job != null && drainBudget != null) _drain();
+    }
+
+    final scheduler = _schedulerBinding();
+    if (scheduler == null || !scheduler.framesEnabled) {
+      Timer.run(resume);
+      return;
     }
+    scheduler.addPostFrameCallback((_) => resume());
+    scheduler.ensureVisualUpdate();
+    _drainFallback = Timer(_frameTimeout, resume);
+  }
+
+  static const _frameTimeout = Duration(milliseconds: 100);
+
+  static SchedulerBinding? _schedulerBinding() {
+    try {
+      return SchedulerBinding.instance;
+    } on Object {
+      return null; // not initialized in this isolate
+    }
+  }
+
+  void _runAsync(
+    Future<void> Function(Pointer<BackendMsg>) job,
+    Pointer<BackendMsg> msg,
+  ) {
+    _inFlight++;
+    Future<void> pending;
+    try {
+      pending = job(msg);
+    } catch (e, st) {
+      pending = Future<void>.error(e, st);
+    }
+    // Errors propagate to the zone like a throwing synchronous job would.
+    pending.whenComplete(() {
+      freeMessage(msg);
+      _inFlight--;
+      if (_owedNotifications > 0 && !_disposed) {
+        _owedNotifications--;
+        _onNotify();
+      }
+    });
   }
 
   /// Registers [job] as the handler invoked for every message emitted by this
   /// service.
   ///
-  /// [job] receives a non-null [Pointer<BackendMsg>]. [freeMessage] is called
-  /// automatically once [job] returns.
+  /// [job] receives a non-null [Pointer<BackendMsg>] and runs synchronously
+  /// inside the notification callback. [freeMessage] is called automatically
+  /// once [job] returns (or throws).
   @nonVirtual
   void assignJob(void Function(Pointer<BackendMsg>) job) {
     assert(!_disposed, 'assignJob called on a disposed Service');
     assert(
-      _subscriptions.isEmpty,
+      _job == null && _asyncJob == null,
       'assignJob called twice on the same Service — '
-      'each message pointer would be freed twice (double-free)',
+      'call cancelJob() first to replace the job',
+    );
+    _job = job;
+    _updateConsumer();
+  }
+
+  /// Registers an asynchronous [job] invoked for every message emitted by
+  /// this service.
+  ///
+  /// Each message is freed when the [Future] returned by [job] completes, so
+  /// the job may `await` (a decode isolate, I/O, …) while reading from the
+  /// pointer. Up to [maxInFlight] messages are processed concurrently; further
+  /// messages wait in the C++ queue until a slot frees up, which preserves
+  /// the start order and applies backpressure to the native side.
+  @nonVirtual
+  void assignAsyncJob(
+    Future<void> Function(Pointer<BackendMsg>) job, {
+    int maxInFlight = 4,
+  }) {
+    assert(!_disposed, 'assignAsyncJob called on a disposed Service');
+    assert(maxInFlight > 0, 'maxInFlight must be positive');
+    assert(
+      _job == null && _asyncJob == null,
+      'assignAsyncJob called twice on the same Service — '
+      'call cancelJob() first to replace the job',
     );
-    _subscriptions.add(_messageStream.listen((message) {
-      job(message);
-      freeMessage(message);
-    }));
+    _asyncJob = job;
+    _maxInFlight = maxInFlight;
+    _updateConsumer();
+  }
+
+  /// Cancels the job registered with [assignJob] or [assignAsyncJob].
+  /// In-flight async jobs still free their message when they complete.
+  /// If nothing listens to
+  /// [messages] either, tells the C++ side that nobody is consuming any more
+  /// (`set_consumer_active(false)`).
+  ///
+  /// Messages that arrive while no job is assigned are freed immediately.
+  /// A new job may be assigned afterwards.
+  @nonVirtual
+  void cancelJob() {
+    if (_disposed) return;
+    _job = null;
+    _asyncJob = null;
+    _updateConsumer();
+    // Messages held back by a full async window would never be notified
+    // again: drain them now (freed, or handed to [messages] listeners).
+    final owed = _owedNotifications;
+    _owedNotifications = 0;
+    for (var i = 0; i < owed; i++) {
+      _onNotify();
+    }
+  }
+
+  /// Broadcast stream of raw message pointers, for consumers that want
+  /// `Stream` composition (`StreamBuilder`, transformers, …).
+  ///
+  /// Messages are only emitted while no job is assigned with [assignJob],
+  /// one event-loop turn after the notification. Each listener receives the
+  /// same pointer, so exactly one of them must call [freeMessage] on it.
+  /// Prefer [assignJob], which is cheaper and handles [freeMessage].
+  Stream<Pointer<BackendMsg>> get messages => _messageController.stream;
+
+  void _updateConsumer() => _setConsumerActive?.call(
+        _job != null || _asyncJob != null || _messageController.hasListener,
+      );
+
+  /// Forwards [active] to the optional C `set_consumer_active` symbol; a
+  /// no-op when the library does not export it.
+  ///
+  /// [assignJob] and [cancelJob] call this already. Subclasses that deliver
+  /// messages through their own channel use it to report their consumer.
+  @protected
+  void setConsumerActive(bool active) => _setConsumerActive?.call(active);
+
+  /// Attaches the native queue to [budget] with the given [weight] (its
+  /// share of the budget is proportional to it), or detaches it when
+  /// [budget] is `null`. Returns `false` if the library does not export
+  /// `set_memory_budget`.
+  ///
+  /// [dispose] detaches the service, after which [budget] may be disposed.
+  bool attachMemoryBudget(MemoryBudget? budget, {int weight = 1}) {
+    assert(weight > 0, 'weight must be positive');
+    final setBudget = _setMemoryBudget;
+    if (setBudget == null || _disposed) return false;
+    setBudget(budget?.pointer ?? nullptr, budget == null ? 0 : weight);
+    return true;
+  }
+
+  /// Sequence number the native queue gave [msg] (1, 2, …), or `0` if the
+  /// library does not export `get_message_seq`. A jump between two
+  /// consecutive messages means messages were dropped locally; see
+  /// [ServiceStats.localDrops] and [ServiceStats.ingestGaps].
+  int messageSeq(Pointer<BackendMsg> msg) => _getMessageSeq?.call(msg) ?? 0;
+
+  /// Current counters of the native queue; all zero if the library does not
+  /// export `get_service_stats`.
+  ServiceStats get stats {
+    final getStats = _getServiceStats;
+    if (getStats == null || _disposed) return const ServiceStats();
+    final native = calloc<_NativeServiceStats>();
+    try {
+      getStats(native.cast(), sizeOf<_NativeServiceStats>());
+      return ServiceStats(
+        bytesHeld: native.ref.bytesHeld,
+        evicted: native.ref.evicted,
+        expired: native.ref.expired,
+        lastSeq: native.ref.lastSeq,
+        ingestGaps: native.ref.ingestGaps,
+        pending: native.ref.pending,
+        drainIdle: Duration(milliseconds: native.ref.drainIdleMs),
+        heartbeatIdle: Duration(milliseconds: native.ref.beatIdleMs),
+        alarms: native.ref.alarms,
+      );
+    } finally {
+      calloc.free(native);
+    }
+  }
+
+  /// Has the native watchdog (`fcb::watchdog()` in `watchdog.h`)
+  /// raise an alarm when messages are pending but none was taken for
+  /// [stall], and when the worker neither pushed nor sent a heartbeat for
+  /// [heartbeat], while a job is assigned. A `null` limit disables that
+  /// alarm; with both `null` the service is no longer watched.
+  ///
+  /// Raised alarms are read from [stats] ([ServiceStats.alarms]), which is
+  /// cheap enough to poll from a UI timer. Returns `false` if the library
+  /// does not export `set_watchdog` (`FCB_EXPORT_WATCHDOG_SYMBOLS`).
+  ///
+  /// ```dart
+  /// svc.watch(
+  ///   stall: const Duration(seconds: 2),
+  ///   heartbeat: const Duration(seconds: 5),
+  /// );
+  /// ```
+  bool watch({Duration? stall, Duration? heartbeat}) {
+    final setWatchdog = _setWatchdog;
+    if (setWatchdog == null || _disposed) return false;
+    int ms(Duration? d) =>
+        d == null ? 0 : d.inMilliseconds.clamp(1, 0xFFFFFFFF);
+    setWatchdog(ms(stall), ms(heartbeat));
+    return true;
   }
 
   /// Stops the service and releases the native callback.
   ///
-  /// Calls the C++ `stop_service` function, cancels all stream subscriptions,
-  /// closes the [StreamController], and closes the [NativeCallable], allowing
-  /// the Dart isolate to exit cleanly. Safe to call multiple times.
+  /// Calls the C++ `stop_service` function, drops the job, closes the
+  /// [messages] stream, and closes the [NativeCallable], allowing the Dart
+  /// isolate to exit cleanly. Safe to call multiple times.
   void dispose() {
     if (_disposed) return;
     _disposed = true;
+    _setConsumerActive?.call(false);
+    // The worker may still push after stop_service(); it must not touch a
+    // MemoryBudget that the owner frees once this returns.
+    _setMemoryBudget?.call(nullptr, 0);
     stopService();
     // Nullify the C++ callback pointer before closing the NativeCallable.
     // stop_service() only sets a flag; the worker thread may still call
     // notify_cb() while the Dart side is tearing down. Passing nullptr makes
     // the C++ guard (if (notify_cb) notify_cb()) a safe no-op from that point.
     _setMessageCallback(nullptr);
-    for (final sub in _subscriptions) {
-      sub.cancel();
-    }
-    _subscriptions.clear();
+    _job = null;
+    _asyncJob = null;
+    _drainFallback?.cancel();
     _messageController.close();
     _finalizer.detach(this);
     _callable?.close();
@@ -195,16 +729,28 @@ class Service {
   @protected
   final String libname;
 
+  /// Channel index within [libname] for services created with
+  /// [Service.channel]; `null` for a whole-library service.
+  final int? channel;
+
   /// The opened [DynamicLibrary]. Available to subclasses for binding
   /// additional native functions.
   @protected
   late DynamicLibrary lib;
 
-  /// Broadcast stream of raw message pointers drained from the C++ queue.
+  /// Time budget for draining the queue on each notification, or `null`.
   ///
-  /// Only non-null pointers are emitted. Prefer [assignJob] over listening
-  /// to this stream directly, as [assignJob] also handles [freeMessage].
-  Stream<Pointer<BackendMsg>> get _messageStream => _messageController.stream;
+  /// With `null` (the default) each notification delivers exactly one
+  /// message. With a budget (such as 2 ms), a notification makes the
+  /// [assignJob] job drain the queue until it is empty or the budget has
+  /// elapsed; the remainder is drained after the next frame (or from a timer
+  /// while no frames are produced) so a large backlog cannot monopolise the
+  /// UI isolate. Ignored by [assignAsyncJob]
+  /// and [messages].
+  Duration? drainBudget;
+
+  /// How many times a drain stopped because [drainBudget] was exhausted.
+  int budgetHits = 0;
 
   /// Bound to the C `start_service()` function.
   late void Function() startService;
@@ -221,11 +767,26 @@ class Service {
   static final _finalizer =
       Finalizer<NativeCallable<_NotifyNative>>((c) => c.close());
 
-  final StreamController<Pointer<BackendMsg>> _messageController =
-      StreamController<Pointer<BackendMsg>>.broadcast();
+  late final StreamController<Pointer<BackendMsg>> _messageController =
+      StreamController<Pointer<BackendMsg>>.broadcast(
+    onListen: _updateConsumer,
+    onCancel: _updateConsumer,
+  );
   late void Function(Pointer<NativeFunction<_NotifyNative>>)
       _setMessageCallback;
+  void Function(bool)? _setConsumerActive;
+  void Function(Pointer<Void>, int)? _setMemoryBudget;
+  void Function(Pointer<Void>, int)? _getServiceStats;
+  int Function(Pointer<BackendMsg>)? _getMessageSeq;
+  void Function(int, int)? _setWatchdog;
   NativeCallable<_NotifyNative>? _callable;
   bool _disposed = false;
-  final List<StreamSubscription<Pointer<BackendMsg>>> _subscriptions = [];
+  void Function(Pointer<BackendMsg>)? _job;
+  Future<void> Function(Pointer<BackendMsg>)? _asyncJob;
+  int _maxInFlight = 1;
+  int _inFlight = 0;
+  int _owedNotifications = 0;
+  final Stopwatch _drainWatch = Stopwatch();
+  bool _drainScheduled = false;
+  Timer? _drainFallback;
 }
@@ -1,3 +1,4 @@
+import 'memory_budget.dart';
 import 'service.dart';
 
 /// Manages a collection of [Service] instances.
@@ -19,8 +20,49 @@ import 'service.dart';
 /// // No startPolling() needed — messages are delivered on demand.
 /// ```
 ///
+/// Pass [drainBudget] to give every added service without its own
+/// [Service.drainBudget] a time-budgeted drain; [budgetHits] reports how often
+/// services had to yield to the frame scheduler.
+///
+/// Pass [memoryBudgetBytes] to bound the native memory held in the queues of
+/// all services together (see [MemoryBudget]); [addService] takes each
+/// service's weight. [bytesHeld] and [evicted] report memory pressure for
+/// diagnostics, with or without a budget.
+///
 /// Call [dispose] when the pool is no longer needed to stop all services.
 class ServicePool {
+  /// Creates an empty pool. [drainBudget] becomes the default
+  /// [Service.drainBudget] of services added later; a non-null
+  /// [memoryBudgetBytes] creates the pool's [memoryBudget].
+  ServicePool({this.drainBudget, int? memoryBudgetBytes})
+      : memoryBudget =
+            memoryBudgetBytes == null ? null : MemoryBudget(memoryBudgetBytes);
+
+  /// Default [Service.drainBudget] for services added to this pool.
+  final Duration? drainBudget;
+
+  /// Sum of [Service.budgetHits] over the services in this pool.
+  int get budgetHits =>
+      _services.fold(0, (sum, service) => sum + service.budgetHits);
+
+  /// Memory budget shared by the services of this pool, if any.
+  final MemoryBudget? memoryBudget;
+
+  /// Bytes held in the native queues of the services in this pool.
+  int get bytesHeld =>
+      _services.fold(0, (sum, service) => sum + service.stats.bytesHeld);
+
+  /// Messages evicted by the memory policies of the services in this pool.
+  int get evicted =>
+      _services.fold(0, (sum, service) => sum + service.stats.evicted);
+
+  /// Services in this pool with a watchdog alarm raised (see
+  /// [Service.watch] and [ServiceStats.alarms]).
+  List<Service> get alarmed => [
+        for (final service in _services)
+          if (service.stats.alarms != 0) service,
+      ];
+
   /// Stops all registered services and releases their native callbacks.
   ///
   /// Safe to call multiple times.
@@ -30,18 +72,26 @@ class ServicePool {
     for (final service in _services) {
       service.dispose();
     }
+    memoryBudget?.dispose();
   }
 
   /// Adds [newService] to the pool and calls its `start_service` function.
+  /// With a [memoryBudget], the service is attached to it with
+  /// [memoryWeight].
   ///
   /// Returns `true` on success.
-  bool addService(Service newService) {
+  bool addService(Service newService, {int memoryWeight = 1}) {
     assert(!_disposed, 'addService called on a disposed ServicePool');
     assert(
       !_services.contains(newService),
       'addService called with a Service already in the pool — '
       'startService() would be called twice, spawning a second worker thread',
     );
+    newService.drainBudget ??= drainBudget;
+    final budget = memoryBudget;
+    if (budget != null) {
+      newService.attachMemoryBudget(budget, weight: memoryWeight);
+    }
     newService.startService();
     _services.add(newService);
     return true;
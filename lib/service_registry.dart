@@ -0,0 +1,159 @@
+import 'dart:convert';
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+import 'standalone_service.dart';
+
+/// One service registered natively (see `FCB_REGISTER_SERVICE` in
+/// `service_registry.h`); mirrors `fcb::ServiceInfo`.
+class ServiceInfo {
+  ServiceInfo._fromJson(Map<String, dynamic> json)
+      : name = json['name'] as String,
+        library = json['library'] as String,
+        kind = json['kind'] as String,
+        messageType = json['message_type'] as String,
+        capabilities = List.unmodifiable(json['capabilities'] as List),
+        channel = (json['channel'] as int) < 0 ? null : json['channel'] as int,
+        running = json['running'] as bool,
+        hasConsumer = json['consumer'] as bool;
+
+  /// Unique name of the service in the process.
+  final String name;
+
+  /// Path the hosting library was loaded from; pass it to the [Service]
+  /// constructor.
+  final String library;
+
+  /// `queue`, `bytes`, `current`, `history`, `standalone`, or a kind chosen
+  /// by the library (`FCB_REGISTER_SERVICE_AS`).
+  final String kind;
+
+  /// C++ type of the messages, e.g. `liba_message_t`; empty if unknown.
+  final String messageType;
+
+  final List<String> capabilities;
+
+  /// Channel index for [Service.channel], or `null` for a whole-library
+  /// service.
+  final int? channel;
+
+  /// Whether `start_service` has run and the service has not been stopped
+  /// since, when the registry was read.
+  final bool running;
+
+  /// Whether a Dart job was assigned, when the registry was read.
+  final bool hasConsumer;
+
+  @override
+  String toString() => '$name ($kind, $library)';
+}
+
+/// Builds the [Service] for a registered service.
+typedef ServiceFactory = Service Function(ServiceInfo info);
+
+/// Dart side of the native service registry (`fcb::registry()` in
+/// `service_registry.h`): services register themselves when their library is
+/// loaded, so the app can list them and construct [Service] objects from
+/// what is actually there instead of hardcoding library names.
+///
+/// [libraries] are opened in order (e.g. from a deployment manifest); the
+/// registry is shared by all of them and read with a single native call.
+/// [factories] builds the typed wrapper of a service, looked up by service
+/// name first, then by kind:
+///
+/// ```dart
+/// final registry = ServiceRegistry(
+///   ['liba.so', 'libmessagezmq.so'],
+///   factories: {
+///     'liba': (info) => LibAService(info.library),
+///     'zmq_ingest': (info) => LibMessageZmqService(libname: info.library),
+///   },
+/// );
+/// for (final info in registry.withCapability('color')) {
+///   pool.addService(registry.create(info.name));
+/// }
+/// ```
+///
+/// Without a factory, a service is built as a plain [Service] (bound to its
+/// channel, if any), or as a [StandaloneService] for the `standalone` kind.
+///
+/// The constructor throws an [ArgumentError] if no library in [libraries]
+/// registers a service.
+class ServiceRegistry {
+  ServiceRegistry(
+    Iterable<String> libraries, {
+    this.factories = const {},
+  }) {
+    for (final libname in libraries) {
+      final lib = DynamicLibrary.open(libname);
+      if (_query == null && lib.providesSymbol('fcb_registry_json')) {
+        _query = lib
+            .lookup<NativeFunction<Pointer<Utf8> Function()>>(
+              'fcb_registry_json',
+            )
+            .asFunction();
+        _free = lib
+            .lookup<NativeFunction<Void Function(Pointer<Utf8>)>>(
+              'fcb_registry_free',
+            )
+            .asFunction();
+      }
+    }
+    if (_query == null) {
+      throw ArgumentError.value(
+        libraries,
+        'libraries',
+        'none registers a service (FCB_REGISTER_SERVICE)',
+      );
+    }
+  }
+
+  /// Wrapper constructors, by service name or kind.
+  final Map<String, ServiceFactory> factories;
+
+  Pointer<Utf8> Function()? _query;
+  late final void Function(Pointer<Utf8>) _free;
+
+  /// Every registered service, in registration order, with its current
+  /// state.
+  List<ServiceInfo> services() {
+    final json = _query!();
+    if (json == nullptr) throw StateError('fcb_registry_json failed');
+    try {
+      return [
+        for (final entry in jsonDecode(json.toDartString()) as List)
+          ServiceInfo._fromJson(entry as Map<String, dynamic>),
+      ];
+    } finally {
+      _free(json);
+    }
+  }
+
+  /// The service registered as [name], or `null`.
+  ServiceInfo? find(String name) {
+    for (final info in services()) {
+      if (info.name == name) return info;
+    }
+    return null;
+  }
+
+  /// The services that declared [capability].
+  List<ServiceInfo> withCapability(String capability) => [
+        for (final info in services())
+          if (info.capabilities.contains(capability)) info,
+      ];
+
+  /// A new [Service] for the service registered as [name].
+  Service create(String name) {
+    final info = find(name) ??
+        (throw ArgumentError.value(name, 'name', 'is not registered'));
+    final factory = factories[info.name] ?? factories[info.kind];
+    if (factory != null) return factory(info);
+    final channel = info.channel;
+    if (channel != null) return Service.channel(info.library, channel);
+    if (info.kind == 'standalone') return StandaloneService(info.library);
+    return Service(info.library);
+  }
+}
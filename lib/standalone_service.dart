@@ -31,4 +31,10 @@ class StandaloneService extends Service {
   StandaloneService(super.libname) {
     startService();
   }
+
+  /// Like [Service.exclusive]: throws a [StateError] instead of starting if
+  /// another wrapper's service is still running.
+  StandaloneService.exclusive(super.libname) : super.exclusive() {
+    startService();
+  }
 }
@@ -0,0 +1,83 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'service.dart';
+
+/// A [Service] backed by a C++ `fcb::TimeSeries<V>` (see
+/// `FCB_EXPORT_TIME_SERIES_SYMBOLS` in `time_series.h`): a time-indexed
+/// native store answering range queries.
+///
+/// [query] returns immediately with a request id. The query runs on a native
+/// thread; its decimated answer arrives as an ordinary message through
+/// [assignJob]:
+///
+/// ```dart
+/// final svc = TimeSeriesService('librecording.so');
+/// svc.assignJob((msg) {
+///   if (svc.resultId(msg) != latestRequest) return;   // stale answer
+///   final t = svc.resultTimes(msg);
+///   final v = svc.resultValues(msg).cast<Float>().asTypedList(t.length);
+///   chart.update(t, v);   // copy what must outlive the callback
+/// });
+/// latestRequest = svc.query(t0, t1, 2000);
+/// ```
+class TimeSeriesService extends Service {
+  TimeSeriesService(super.libname) {
+    _size = lib
+        .lookup<NativeFunction<Uint64 Function()>>('ts_size')
+        .asFunction();
+    _query = lib
+        .lookup<NativeFunction<Uint64 Function(Int64, Int64, Uint32)>>(
+          'ts_query',
+        )
+        .asFunction();
+    resultId = lib
+        .lookup<NativeFunction<Uint64 Function(Pointer<BackendMsg>)>>(
+          'ts_result_id',
+        )
+        .asFunction();
+    _resultCount = lib
+        .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+          'ts_result_count',
+        )
+        .asFunction();
+    _resultTimes = lib
+        .lookup<NativeFunction<Pointer<Int64> Function(Pointer<BackendMsg>)>>(
+          'ts_result_times',
+        )
+        .asFunction();
+    resultValues = lib
+        .lookup<NativeFunction<Pointer<Void> Function(Pointer<BackendMsg>)>>(
+          'ts_result_values',
+        )
+        .asFunction();
+  }
+
+  late final int Function() _size;
+  late final int Function(int, int, int) _query;
+  late final int Function(Pointer<BackendMsg>) _resultCount;
+  late final Pointer<Int64> Function(Pointer<BackendMsg>) _resultTimes;
+
+  /// Id of the query answered by a result message.
+  late final int Function(Pointer<BackendMsg>) resultId;
+
+  /// Pointer to the result values (`V[]`, [resultCount] entries); cast it to
+  /// the native type matching `V`.
+  late final Pointer<Void> Function(Pointer<BackendMsg>) resultValues;
+
+  /// Number of samples currently stored.
+  int get size => _size();
+
+  /// Requests samples with `t0 <= t < t1`, decimated to at most [maxPoints]
+  /// (min/max per time bucket; `0` = no decimation). Returns the request id.
+  int query(int t0, int t1, int maxPoints) => _query(t0, t1, maxPoints);
+
+  /// Number of samples in a result message.
+  int resultCount(Pointer<BackendMsg> msg) => _resultCount(msg);
+
+  /// Zero-copy view of the result timestamps.
+  ///
+  /// Valid only for the duration of the [assignJob] callback.
+  Int64List resultTimes(Pointer<BackendMsg> msg) =>
+      _resultTimes(msg).asTypedList(_resultCount(msg));
+}
@@ -0,0 +1,185 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Mirror of the C++ `fcb::UdpDatagram` index entry (udp_ingest.h).
+final class _UdpDatagram extends Struct {
+  @Uint32()
+  external int offset;
+
+  @Uint32()
+  external int length;
+
+  @Int64()
+  external int timestampNs;
+}
+
+typedef _ConfigureNative = Bool Function(
+  Pointer<Utf8>,
+  Uint16,
+  Pointer<Utf8>,
+  Int32,
+  Uint32,
+  Uint32,
+  Bool,
+  Bool,
+);
+typedef _ConfigureDart = bool Function(
+  Pointer<Utf8>,
+  int,
+  Pointer<Utf8>,
+  int,
+  int,
+  int,
+  bool,
+  bool,
+);
+
+/// The datagrams of one batch received by a [UdpIngestService].
+///
+/// Views are zero-copy and valid only until the message is freed.
+class UdpBatchView {
+  UdpBatchView._(this.length, this._data, this._index);
+
+  /// Number of datagrams in the batch.
+  final int length;
+
+  final Pointer<Uint8> _data;
+  final Pointer<_UdpDatagram> _index;
+
+  // Offsets grow with the index, so the last entry bounds the buffer.
+  late final Uint8List _bytes = length == 0
+      ? Uint8List(0)
+      : _data.asTypedList(
+          _index[length - 1].offset + _index[length - 1].length,
+        );
+
+  /// Zero-copy view of datagram [i].
+  Uint8List operator [](int i) {
+    final entry = _index[i];
+    final start = entry.offset;
+    return Uint8List.sublistView(_bytes, start, start + entry.length);
+  }
+
+  /// Kernel receive time of datagram [i] in nanoseconds since the epoch, or
+  /// `0` unless the service was created with `timestamps: true`.
+  int timestampNs(int i) => _index[i].timestampNs;
+}
+
+/// A [Service] backed by a C++ `fcb::UdpIngest` (see
+/// `FCB_EXPORT_UDP_INGEST_SYMBOLS` in `udp_ingest.h`), configured from Dart.
+///
+/// The native ingest thread receives up to [batchSize] datagrams per
+/// `recvmmsg` call into a pooled buffer and queues them as one message, so
+/// the per-datagram cost on the Dart side is a view, not an FFI round trip:
+///
+/// ```dart
+/// final feed = UdpIngestService('libudp.so', port: 9000, timestamps: true);
+/// feed.assignJob((msg) {
+///   final batch = feed.batch(msg);
+///   for (var i = 0; i < batch.length; i++) {
+///     handle(batch[i], batch.timestampNs(i));
+///   }
+/// });
+/// pool.addService(feed);
+/// ```
+///
+/// The socket is bound in the constructor, which throws a [StateError]
+/// carrying the system error if the address or an option is rejected.
+/// Datagrams longer than [maxDatagram] are cut short and counted in
+/// [truncated]. With [gro], the kernel coalesces datagrams of the same flow
+/// and the batch index splits them again; slots are then 64 KiB, so prefer a
+/// smaller [batchSize].
+class UdpIngestService extends Service {
+  UdpIngestService(
+    super.libname, {
+    required int port,
+    String address = '0.0.0.0',
+    String? group,
+    int? receiveBufferSize,
+    int batchSize = 64,
+    int maxDatagram = 2048,
+    bool gro = false,
+    bool timestamps = false,
+  }) : super.exclusive() {
+    final nativeAddress = address.toNativeUtf8();
+    final nativeGroup = group?.toNativeUtf8() ?? nullptr;
+    try {
+      final configured = lib
+          .lookup<NativeFunction<_ConfigureNative>>('udp_ingest_configure')
+          .asFunction<_ConfigureDart>()(
+        nativeAddress,
+        port,
+        nativeGroup,
+        receiveBufferSize ?? -1,
+        batchSize,
+        maxDatagram,
+        gro,
+        timestamps,
+      );
+      if (!configured) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      final error = lib
+          .lookup<NativeFunction<Pointer<Utf8> Function()>>('udp_ingest_open')
+          .asFunction<Pointer<Utf8> Function()>()();
+      if (error != nullptr) {
+        throw StateError('$libname: ${error.toDartString()}');
+      }
+    } catch (_) {
+      dispose();
+      rethrow;
+    } finally {
+      calloc.free(nativeAddress);
+      if (nativeGroup != nullptr) calloc.free(nativeGroup);
+    }
+  }
+
+  late final int Function(Pointer<BackendMsg>) _count = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'udp_batch_count',
+      )
+      .asFunction();
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _data = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'udp_batch_data',
+      )
+      .asFunction();
+  late final Pointer<_UdpDatagram> Function(Pointer<BackendMsg>) _index = lib
+      .lookup<
+          NativeFunction<
+              Pointer<_UdpDatagram> Function(Pointer<BackendMsg>)>>(
+        'udp_batch_index',
+      )
+      .asFunction();
+  late final int Function() _localPort = lib
+      .lookup<NativeFunction<Uint16 Function()>>('udp_ingest_local_port')
+      .asFunction();
+  late final int Function() _truncated = lib
+      .lookup<NativeFunction<Uint64 Function()>>('udp_ingest_truncated')
+      .asFunction();
+  late final Pointer<Utf8> Function() _error = lib
+      .lookup<NativeFunction<Pointer<Utf8> Function()>>('udp_ingest_error')
+      .asFunction();
+
+  /// The datagrams carried by [msg].
+  UdpBatchView batch(Pointer<BackendMsg> msg) =>
+      UdpBatchView._(_count(msg), _data(msg), _index(msg));
+
+  /// The bound port; useful when created with `port: 0`.
+  int get localPort => _localPort();
+
+  /// Datagrams cut short because they were longer than `maxDatagram`.
+  int get truncated => _truncated();
+
+  /// Why the ingest thread stopped on its own (the socket could not be
+  /// opened or polled), or `null`.
+  String? get error {
+    final text = _error();
+    return text == nullptr ? null : text.toDartString();
+  }
+}
@@ -0,0 +1,92 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+typedef _ConfigureNative = Bool Function(Pointer<Utf8>, Uint32, Bool);
+
+/// A [Service] backed by a C++ `fcb::UnixIngest` (see
+/// `FCB_EXPORT_UNIX_INGEST_SYMBOLS` in `unix_ingest.h`): a UNIX
+/// `SOCK_SEQPACKET` server that local producer processes connect to.
+///
+/// Small messages arrive inline; large ones arrive as sealed memfds that the
+/// service maps, so [bytes] is zero-copy in both cases and the mapping goes
+/// away when the message is freed:
+///
+/// ```dart
+/// final local = UnixIngestService('libunixingest.so', '@telemetry');
+/// local.assignJob((msg) => decoder.add(local.bytes(msg)));
+/// pool.addService(local);
+/// ```
+///
+/// A [path] starting with `@` names an abstract socket (no file is created).
+/// The constructor binds the socket and throws a [StateError] if it cannot.
+/// Inline packets longer than [maxInline] and unsealed memfds (when
+/// [requireSeals] is set) are dropped and counted in [rejected].
+class UnixIngestService extends Service {
+  UnixIngestService(
+    super.libname,
+    String path, {
+    int maxInline = 65536,
+    bool requireSeals = true,
+  }) : super.exclusive() {
+    final nativePath = path.toNativeUtf8();
+    try {
+      final configured = lib
+          .lookup<NativeFunction<_ConfigureNative>>('unix_ingest_configure')
+          .asFunction<bool Function(Pointer<Utf8>, int, bool)>()(
+        nativePath,
+        maxInline,
+        requireSeals,
+      );
+      if (!configured) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      final error = lib
+          .lookup<NativeFunction<Pointer<Utf8> Function()>>('unix_ingest_open')
+          .asFunction<Pointer<Utf8> Function()>()();
+      if (error != nullptr) {
+        throw StateError('$libname: ${error.toDartString()}');
+      }
+    } catch (_) {
+      dispose();
+      rethrow;
+    } finally {
+      calloc.free(nativePath);
+    }
+  }
+
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>) _getBytes = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Pointer<BackendMsg>)>>(
+        'get_msg_bytes',
+      )
+      .asFunction();
+  late final int Function(Pointer<BackendMsg>) _getLen = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'get_msg_len',
+      )
+      .asFunction();
+  late final bool Function(Pointer<BackendMsg>) _mapped = lib
+      .lookup<NativeFunction<Bool Function(Pointer<BackendMsg>)>>(
+        'unix_msg_mapped',
+      )
+      .asFunction();
+  late final int Function() _rejected = lib
+      .lookup<NativeFunction<Uint64 Function()>>('unix_ingest_rejected')
+      .asFunction();
+
+  /// Zero-copy view of the payload of [msg].
+  ///
+  /// Valid only until the message is freed.
+  Uint8List bytes(Pointer<BackendMsg> msg) =>
+      _getBytes(msg).asTypedList(_getLen(msg));
+
+  /// Whether [msg] arrived as a passed memfd rather than inline.
+  bool isMapped(Pointer<BackendMsg> msg) => _mapped(msg);
+
+  /// Oversized inline packets and rejected memfds so far.
+  int get rejected => _rejected();
+}
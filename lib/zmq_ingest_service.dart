@@ -0,0 +1,279 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Socket types accepted by a C++ `fcb::ZmqIngest` service.
+enum ZmqSocketType {
+  /// `ZMQ_SUB`: receives from publishers; [ZmqIngestService] topics are
+  /// subscription prefixes.
+  sub(2),
+
+  /// `ZMQ_PULL`: receives from a `PUSH` pipeline; topics are ignored.
+  pull(7),
+
+  /// `ZMQ_DISH`: receives from `RADIO` sockets (UDP multicast capable);
+  /// topics are groups. Needs a libzmq built with the draft API.
+  dish(15);
+
+  const ZmqSocketType(this.value);
+
+  /// The libzmq constant.
+  final int value;
+}
+
+typedef _ConfigureNative = Bool Function(Int32, Int32, Int32, Bool);
+typedef _AddEndpointNative = Void Function(Pointer<Utf8>, Bool);
+typedef _AddTopicNative = Uint32 Function(Pointer<Uint8>, Uint32);
+typedef _FrameDataNative = Pointer<Uint8> Function(Pointer<BackendMsg>, Uint32);
+typedef _FrameSizeNative = Uint32 Function(Pointer<BackendMsg>, Uint32);
+
+/// Sends the socket configuration through the `<prefix>_configure`,
+/// `_add_endpoint` and `_add_topic` / `_add_channel` symbols, then opens the
+/// socket with `<prefix>_open`. Returns what `addTopic` returned per topic.
+///
+/// Configuring clears the endpoints and topics of an earlier wrapper; it is
+/// refused while that wrapper's service is still running.
+List<int> _configureSocket(
+  DynamicLibrary lib,
+  String libname,
+  String prefix, {
+  required String addTopicSymbol,
+  required List<String> endpoints,
+  required ZmqSocketType type,
+  required List<String> topics,
+  required bool bind,
+  required int? receiveHighWaterMark,
+  required int? receiveBufferSize,
+  required bool conflate,
+}) {
+  final configured = lib
+      .lookup<NativeFunction<_ConfigureNative>>('${prefix}_configure')
+      .asFunction<bool Function(int, int, int, bool)>()(
+    type.value,
+    receiveHighWaterMark ?? -1,
+    receiveBufferSize ?? -1,
+    conflate,
+  );
+  if (!configured) {
+    throw StateError('$libname: still running; dispose the previous wrapper');
+  }
+  final addEndpoint = lib
+      .lookup<NativeFunction<_AddEndpointNative>>('${prefix}_add_endpoint')
+      .asFunction<void Function(Pointer<Utf8>, bool)>();
+  for (final endpoint in endpoints) {
+    final native = endpoint.toNativeUtf8();
+    try {
+      addEndpoint(native, bind);
+    } finally {
+      calloc.free(native);
+    }
+  }
+  final addTopic = lib
+      .lookup<NativeFunction<_AddTopicNative>>(addTopicSymbol)
+      .asFunction<int Function(Pointer<Uint8>, int)>();
+  final results = <int>[];
+  for (final topic in topics) {
+    final bytes = utf8.encode(topic);
+    final native = calloc<Uint8>(bytes.length + 1);
+    try {
+      native.asTypedList(bytes.length).setAll(0, bytes);
+      final result = addTopic(native, bytes.length);
+      if (result == 0xFFFFFFFF) {
+        throw StateError('$libname: cannot add "$topic" while running');
+      }
+      results.add(result);
+    } finally {
+      calloc.free(native);
+    }
+  }
+  final error = lib
+      .lookup<NativeFunction<Pointer<Utf8> Function()>>('${prefix}_open')
+      .asFunction<Pointer<Utf8> Function()>()();
+  if (error != nullptr) throw StateError('$libname: ${error.toDartString()}');
+  return results;
+}
+
+/// Zero-copy accessors for services whose messages are C++ `fcb::ZmqBatch`
+/// (one ZMQ message with all its frames).
+mixin ZmqFrames on Service {
+  late final int Function(Pointer<BackendMsg>) _frameCount = lib
+      .lookup<NativeFunction<Uint32 Function(Pointer<BackendMsg>)>>(
+        'zmq_ingest_frame_count',
+      )
+      .asFunction();
+  late final Pointer<Uint8> Function(Pointer<BackendMsg>, int) _frameData =
+      lib
+          .lookup<NativeFunction<_FrameDataNative>>('zmq_ingest_frame_data')
+          .asFunction();
+  late final int Function(Pointer<BackendMsg>, int) _frameSize = lib
+      .lookup<NativeFunction<_FrameSizeNative>>('zmq_ingest_frame_size')
+      .asFunction();
+
+  /// Number of frames in [msg] (1 unless the sender used multipart).
+  int frameCount(Pointer<BackendMsg> msg) => _frameCount(msg);
+
+  /// Zero-copy view of frame [index] of [msg].
+  ///
+  /// Valid only until the message is freed.
+  Uint8List frame(Pointer<BackendMsg> msg, int index) =>
+      _frameData(msg, index).asTypedList(_frameSize(msg, index));
+
+  /// Zero-copy view of the last frame, the payload.
+  Uint8List payload(Pointer<BackendMsg> msg) =>
+      frame(msg, _frameCount(msg) - 1);
+}
+
+/// A [Service] backed by a C++ `fcb::ZmqIngest` (see
+/// `FCB_EXPORT_ZMQ_INGEST_SYMBOLS` in `zmq_ingest.h`), configured from Dart.
+///
+/// The socket is created and connected in the constructor, which throws a
+/// [StateError] carrying the libzmq error if an option or endpoint is
+/// rejected. Each message is one ZMQ message with all its frames:
+///
+/// ```dart
+/// final feed = ZmqIngestService(
+///   'libfeed.so',
+///   endpoints: ['tcp://10.0.0.2:5556', 'ipc:///tmp/local'],
+///   topics: ['imu.', 'gps.'],
+///   receiveHighWaterMark: 10000,
+/// );
+/// feed.assignJob((msg) {
+///   final topic = utf8.decode(feed.frame(msg, 0));   // multipart envelope
+///   handle(topic, feed.payload(msg));
+/// });
+/// pool.addService(feed);
+/// ```
+///
+/// Set [conflate] for latest-only feeds (libzmq keeps one message per
+/// connection; it does not apply to multipart messages).
+class ZmqIngestService extends Service with ZmqFrames {
+  ZmqIngestService(
+    super.libname, {
+    required List<String> endpoints,
+    ZmqSocketType type = ZmqSocketType.sub,
+    List<String> topics = const [''],
+    bool bind = false,
+    int? receiveHighWaterMark,
+    int? receiveBufferSize,
+    bool conflate = false,
+  }) : super.exclusive() {
+    try {
+      _configureSocket(
+        lib,
+        libname,
+        'zmq_ingest',
+        addTopicSymbol: 'zmq_ingest_add_topic',
+        endpoints: endpoints,
+        type: type,
+        topics: topics,
+        bind: bind,
+        receiveHighWaterMark: receiveHighWaterMark,
+        receiveBufferSize: receiveBufferSize,
+        conflate: conflate,
+      );
+    } catch (_) {
+      dispose();
+      rethrow;
+    }
+  }
+
+  late final Pointer<Utf8> Function() _error = lib
+      .lookup<NativeFunction<Pointer<Utf8> Function()>>('zmq_ingest_error')
+      .asFunction();
+
+  /// Why the ingest thread stopped on its own (the socket could not be
+  /// opened or polled), or `null`.
+  String? get error {
+    final text = _error();
+    return text == nullptr ? null : text.toDartString();
+  }
+}
+
+/// One channel of a [ZmqDemux]: a [Service] bound with [Service.channel].
+class ZmqDemuxChannel extends Service with ZmqFrames {
+  ZmqDemuxChannel._(super.libname, super.channel, this.topic)
+      : super.channel();
+
+  /// The topic prefix this channel was created for, or `null` for a channel
+  /// routed natively.
+  final String? topic;
+}
+
+/// Client of a C++ `fcb::ZmqDemux` (see `FCB_EXPORT_ZMQ_DEMUX_SYMBOLS` in
+/// `zmq_demux.h`): one ZMQ socket and reader thread feeding several
+/// [ZmqDemuxChannel] services.
+///
+/// Each entry of `topics` becomes a channel receiving the messages whose
+/// first frame starts with it; the socket subscribes to exactly those
+/// prefixes. Libraries that route natively (e.g. by FlatBuffers
+/// `payload_type`) declare their channels in C++ and leave `topics` empty.
+///
+/// ```dart
+/// final hub = ZmqDemux(
+///   'libhub.so',
+///   endpoints: ['tcp://10.0.0.2:5556'],
+///   topics: ['imu.', 'gps.', 'battery'],
+/// );
+/// final imu = hub.channel('imu.');
+/// imu.assignJob((msg) => samples.add(decodeImu(imu.payload(msg))));
+/// for (final ch in hub.channels) {
+///   pool.addService(ch);   // the reader runs while any channel is started
+/// }
+/// ```
+class ZmqDemux {
+  ZmqDemux(
+    this.libname, {
+    required List<String> endpoints,
+    ZmqSocketType type = ZmqSocketType.sub,
+    List<String> topics = const [],
+    bool bind = false,
+    int? receiveHighWaterMark,
+    int? receiveBufferSize,
+    bool conflate = false,
+  }) {
+    final lib = DynamicLibrary.open(libname);
+    final indices = _configureSocket(
+      lib,
+      libname,
+      'zmq_demux',
+      addTopicSymbol: 'zmq_demux_add_channel',
+      endpoints: endpoints,
+      type: type,
+      topics: topics,
+      bind: bind,
+      receiveHighWaterMark: receiveHighWaterMark,
+      receiveBufferSize: receiveBufferSize,
+      conflate: conflate,
+    );
+    final count = lib
+        .lookup<NativeFunction<Uint32 Function()>>('zmq_demux_channel_count')
+        .asFunction<int Function()>()();
+    final topicOf = <int, String>{
+      for (var i = 0; i < topics.length; i++) indices[i]: topics[i],
+    };
+    channels = List.unmodifiable([
+      for (var i = 0; i < count; i++) ZmqDemuxChannel._(libname, i, topicOf[i]),
+    ]);
+  }
+
+  /// Path to the shared library hosting the hub.
+  final String libname;
+
+  /// All channels, in index order.
+  late final List<ZmqDemuxChannel> channels;
+
+  /// The channel created for [topic].
+  ZmqDemuxChannel channel(String topic) =>
+      channels.firstWhere((ch) => ch.topic == topic);
+
+  /// Disposes every channel; the reader stops with the last one.
+  void dispose() {
+    for (final ch in channels) {
+      ch.dispose();
+    }
+  }
+}
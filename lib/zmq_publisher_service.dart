@@ -0,0 +1,177 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'service.dart';
+
+/// Socket types accepted by a C++ `fcb::ZmqPublisher`.
+enum ZmqPublishSocketType {
+  /// `ZMQ_PUB`: fan-out to subscribers; the first frame is the topic.
+  pub(1),
+
+  /// `ZMQ_PUSH`: load-balanced pipeline to `PULL` sockets.
+  push(8),
+
+  /// `ZMQ_RADIO`: to `DISH` sockets (UDP multicast capable). Needs a libzmq
+  /// built with the draft API.
+  radio(14);
+
+  const ZmqPublishSocketType(this.value);
+
+  /// The libzmq constant.
+  final int value;
+}
+
+typedef _ConfigureNative = Bool Function(Int32, Int32, Int32, Uint32);
+typedef _AddEndpointNative = Void Function(Pointer<Utf8>, Bool);
+typedef _SendNative = Bool Function(Pointer<Uint8>, Uint32, Bool);
+
+/// Outbound ZMQ from Dart, backed by a C++ `fcb::ZmqPublisher` (see
+/// `FCB_EXPORT_ZMQ_PUBLISH_SYMBOLS` in `zmq_publish.h`).
+///
+/// Sending never touches the socket on the calling isolate: buffers are
+/// queued to a native sender thread, which hands them to libzmq without
+/// copying. For zero copies end to end, write the message straight into a
+/// buffer from [reserve]:
+///
+/// ```dart
+/// final out = ZmqPublisherService(
+///   'libcommands.so',
+///   endpoints: ['tcp://*:5557'],
+///   bind: true,
+/// );
+/// out.send(utf8.encode('motor.'), more: true);     // topic frame
+/// final buf = out.reserve(builder.size);
+/// buf.asTypedList(builder.size).setAll(0, builder.buffer);
+/// out.sendReserved(buf, builder.size);
+/// ```
+///
+/// [send] accepts a [Uint8List] from the Dart heap and pays one `memcpy`
+/// into a pooled native buffer, since Dart heap memory cannot be lent to a
+/// native thread.
+///
+/// The native queue holds at most `maxQueued` parts; when it is full a
+/// message is rejected as a whole ([send] returns false and [dropped]
+/// grows) rather than blocking the UI thread.
+///
+/// The sender thread starts once the socket is open; [dispose] stops it.
+class ZmqPublisherService extends Service {
+  ZmqPublisherService(
+    super.libname, {
+    required List<String> endpoints,
+    ZmqPublishSocketType type = ZmqPublishSocketType.pub,
+    bool bind = false,
+    int? sendHighWaterMark,
+    int? sendBufferSize,
+    int maxQueued = 4096,
+  }) : super.exclusive() {
+    try {
+      final configured = lib
+          .lookup<NativeFunction<_ConfigureNative>>('zmq_publish_configure')
+          .asFunction<bool Function(int, int, int, int)>()(
+        type.value,
+        sendHighWaterMark ?? -1,
+        sendBufferSize ?? -1,
+        maxQueued,
+      );
+      if (!configured) {
+        throw StateError('$libname: still running; dispose the previous '
+            'wrapper');
+      }
+      final addEndpoint = lib
+          .lookup<NativeFunction<_AddEndpointNative>>(
+            'zmq_publish_add_endpoint',
+          )
+          .asFunction<void Function(Pointer<Utf8>, bool)>();
+      for (final endpoint in endpoints) {
+        final native = endpoint.toNativeUtf8();
+        try {
+          addEndpoint(native, bind);
+        } finally {
+          calloc.free(native);
+        }
+      }
+      final error = lib
+          .lookup<NativeFunction<Pointer<Utf8> Function()>>('zmq_publish_open')
+          .asFunction<Pointer<Utf8> Function()>()();
+      if (error != nullptr) {
+        throw StateError('$libname: ${error.toDartString()}');
+      }
+      startService();
+    } catch (_) {
+      dispose();
+      rethrow;
+    }
+  }
+
+  late final Pointer<Uint8> Function(int) _reserve = lib
+      .lookup<NativeFunction<Pointer<Uint8> Function(Uint32)>>(
+        'zmq_publish_reserve',
+      )
+      .asFunction();
+  late final void Function(Pointer<Uint8>) _recycle = lib
+      .lookup<NativeFunction<Void Function(Pointer<Uint8>)>>(
+        'zmq_publish_recycle',
+      )
+      .asFunction();
+  late final bool Function(Pointer<Uint8>, int, bool) _send = lib
+      .lookup<NativeFunction<_SendNative>>('zmq_publish_send')
+      .asFunction();
+  late final int Function() _sent = lib
+      .lookup<NativeFunction<Uint64 Function()>>('zmq_publish_sent')
+      .asFunction();
+  late final int Function() _dropped = lib
+      .lookup<NativeFunction<Uint64 Function()>>('zmq_publish_dropped')
+      .asFunction();
+
+  /// A native buffer of at least [size] bytes from the publisher's pool, or
+  /// [nullptr] if [size] is above 2 GiB or allocation failed. A failure
+  /// drops the multipart message in progress: its earlier parts are not sent.
+  ///
+  /// Hand it to [sendReserved], or back to [recycle] if unused.
+  Pointer<Uint8> reserve(int size) => _reserve(size);
+
+  /// Returns an unsent [reserve]d buffer to the pool.
+  void recycle(Pointer<Uint8> buffer) => _recycle(buffer);
+
+  /// Queues the first [length] bytes of a [reserve]d buffer without copying.
+  ///
+  /// Ownership passes to the publisher in all cases: do not touch [buffer]
+  /// afterwards. Set [more] on every part of a multipart message but the
+  /// last. Returns false if the message was rejected.
+  bool sendReserved(Pointer<Uint8> buffer, int length, {bool more = false}) =>
+      _send(buffer, length, more);
+
+  /// Copies [data] into a pooled buffer and queues it.
+  ///
+  /// Returns false if the message was rejected.
+  bool send(Uint8List data, {bool more = false}) {
+    final buffer = _reserve(data.length);
+    if (buffer == nullptr) return false;
+    buffer.asTypedList(data.length).setAll(0, data);
+    return _send(buffer, data.length, more);
+  }
+
+  /// Queues [parts] as one multipart message.
+  ///
+  /// Returns false if the message was rejected or a part could not be
+  /// reserved; no part of it is sent then.
+  bool sendMultipart(List<Uint8List> parts) {
+    var ok = true;
+    for (var i = 0; i < parts.length; i++) {
+      final buffer = _reserve(parts[i].length);
+      // The publisher dropped the earlier parts; the message ends here.
+      if (buffer == nullptr) return false;
+      buffer.asTypedList(parts[i].length).setAll(0, parts[i]);
+      ok = _send(buffer, parts[i].length, i + 1 < parts.length) && ok;
+    }
+    return ok;
+  }
+
+  /// Parts handed to libzmq so far.
+  int get sent => _sent();
+
+  /// Parts rejected (queue full, not open) or failed by libzmq.
+  int get dropped => _dropped();
+}
@@ -0,0 +1,31 @@
+// Tiny timing harness shared by the benchmarks in this directory.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace fcb_bench {
+
+// Keeps the optimiser from discarding a computed value.
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs fn() `iters` times after one warm-up call, repeats 5 times and prints
+// the best time per iteration.  Returns it in nanoseconds.
+template<typename Fn>
+inline double measure(const char* name, int iters, Fn&& fn) {
+    fn();
+    double best = 1e300;
+    for (int rep = 0; rep < 5; ++rep) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iters; ++i) fn();
+        std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - t0;
+        best = std::min(best, dt.count() / iters);
+    }
+    std::printf("%-44s %12.1f us/iter\n", name, best / 1e3);
+    return best;
+}
+
+} // namespace fcb_bench
@@ -0,0 +1,65 @@
+// Fan-out cost of fcb::BusTopic: one 4 KiB message published to 1–32
+// callback subscribers, against copying the buffer for each subscriber.
+// Also times queue subscribers (the path BusBridge channels take to Dart)
+// while publishers on other threads share the topic.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/bus.h"
+
+#include <string>
+
+namespace {
+
+constexpr size_t kPayload = 4096;
+constexpr int    kMsgs    = 20000;
+
+} // namespace
+
+int main() {
+    const fcb::BytesMsg payload(kPayload, 0x5a);
+    for (unsigned subs : {1u, 8u, 32u}) {
+        fcb::BusTopic topic("bench");
+        std::atomic<uint64_t> sum{0};
+        std::vector<fcb::BusSubscription> held;
+        for (unsigned i = 0; i < subs; ++i)
+            held.push_back(topic.subscribe([&sum](const fcb::BusMessage& m) {
+                sum.fetch_add(m.data()[m.size() - 1], std::memory_order_relaxed);
+            }));
+
+        std::string name = "bus publish, " + std::to_string(subs) + " subscribers";
+        double ns = fcb_bench::measure(name.c_str(), kMsgs, [&] {
+            topic.publish_copy(payload.data(), payload.size());
+        });
+        std::printf("    %10.0f msg/s, %6.1f ns per delivery\n", 1e9 / ns, ns / subs);
+
+        name = "copy per subscriber, " + std::to_string(subs) + " subscribers";
+        std::vector<fcb::BytesMsg> copies(subs);
+        fcb_bench::measure(name.c_str(), kMsgs, [&] {
+            for (auto& c : copies) {
+                c.assign(payload.begin(), payload.end());
+                fcb_bench::do_not_optimize(c.data());
+            }
+        });
+        fcb_bench::do_not_optimize(sum.load());
+    }
+
+    // Four publisher threads into eight started queues, drained as Dart would.
+    fcb::BusTopic topic("bench/queues");
+    std::vector<std::unique_ptr<fcb::Queue<fcb::BusMessage>>> queues;
+    std::vector<fcb::BusSubscription> held;
+    for (int i = 0; i < 8; ++i) {
+        queues.emplace_back(new fcb::Queue<fcb::BusMessage>);
+        held.push_back(topic.subscribe(*queues.back()));
+    }
+    fcb_bench::measure("bus 4 publishers -> 8 queues, 20k msgs", 1, [&] {
+        std::vector<std::thread> pubs;
+        for (int t = 0; t < 4; ++t)
+            pubs.emplace_back([&] {
+                for (int i = 0; i < kMsgs / 4; ++i)
+                    topic.publish_copy(payload.data(), payload.size());
+            });
+        for (auto& p : pubs) p.join();
+        for (auto& q : queues)
+            while (void* m = q->next()) q->release(m);
+    });
+    return 0;
+}
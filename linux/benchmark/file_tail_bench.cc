@@ -0,0 +1,53 @@
+// Newline search used by fcb::FileTail to split a block into lines:
+// for_each_newline() (AVX2 / SSE2 / NEON) against a memchr loop, on 4 MiB of
+// log-like text with short and long lines.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/file_tail.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+std::vector<uint8_t> make_text(size_t bytes, size_t avg_line) {
+    std::vector<uint8_t> text(bytes);
+    std::srand(42);
+    size_t next = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        if (i == next) {
+            text[i] = '\n';
+            next = i + 1 + size_t(std::rand()) % (2 * avg_line);
+        } else {
+            text[i] = uint8_t(' ' + std::rand() % 90);
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    for (size_t avg : {40, 120, 2000}) {
+        const std::vector<uint8_t> text = make_text(4 << 20, avg);
+        uint64_t simd_sum = 0, scalar_sum = 0;
+        std::string name = std::string("for_each_newline ") + fcb::newline_simd_path() +
+                           " ~" + std::to_string(avg) + " B lines";
+        double simd = fcb_bench::measure(name.c_str(), 20, [&] {
+            uint64_t sum = 0;
+            fcb::for_each_newline(text.data(), text.size(), [&](size_t i) { sum += i; });
+            simd_sum = sum;
+        });
+        name = "memchr loop ~" + std::to_string(avg) + " B lines";
+        double scalar = fcb_bench::measure(name.c_str(), 20, [&] {
+            uint64_t sum = 0;
+            auto fn = [&](size_t i) { sum += i; };
+            fcb::detail::newlines_scalar(text.data(), 0, text.size(), fn);
+            scalar_sum = sum;
+        });
+        std::printf("    %6.2f GB/s vs %6.2f GB/s%s\n", text.size() / simd,
+                    text.size() / scalar, simd_sum != scalar_sum ? "  (MISMATCH)" : "");
+        ok &= simd_sum == scalar_sum;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+// Per-kernel benchmarks for flutter_cpp_bridge/frame_processing.h on a
+// 1920×1080 NV12 / I420 frame.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/frame_processing.h"
+
+#include <random>
+#include <string>
+
+using namespace fcb::frame;
+
+int main() {
+    constexpr uint32_t W = 1920, H = 1080;
+    std::mt19937 gen(42);
+    std::vector<uint8_t> y(W * H), uv(W * H / 2), u(W * H / 4), v(W * H / 4);
+    for (auto* plane : {&y, &uv, &u, &v})
+        for (auto& b : *plane) b = static_cast<uint8_t>(gen());
+
+    YuvImage nv12{YuvLayout::NV12, W, H, y.data(), uv.data(), nullptr, W, W};
+    YuvImage i420{YuvLayout::I420, W, H, y.data(), u.data(), v.data(), W, W / 2};
+    std::vector<uint8_t> rgba(size_t(W) * H * 4), small(1280 * 720 * 4), cut(640 * 360 * 4);
+
+    std::printf("colour-conversion path: %s\n", simd_path());
+
+    fcb_bench::measure("nv12_to_rgba scalar 1080p", 20, [&] {
+        yuv_to_rgba_scalar(nv12, rgba.data(), W * 4);
+        fcb_bench::do_not_optimize(rgba[0]);
+    });
+    fcb_bench::measure("nv12_to_rgba simd 1080p", 20, [&] {
+        yuv_to_rgba(nv12, rgba.data(), W * 4);
+        fcb_bench::do_not_optimize(rgba[0]);
+    });
+    fcb_bench::measure("i420_to_rgba scalar 1080p", 20, [&] {
+        yuv_to_rgba_scalar(i420, rgba.data(), W * 4);
+        fcb_bench::do_not_optimize(rgba[0]);
+    });
+    fcb_bench::measure("i420_to_rgba simd 1080p", 20, [&] {
+        yuv_to_rgba(i420, rgba.data(), W * 4);
+        fcb_bench::do_not_optimize(rgba[0]);
+    });
+    fcb_bench::measure("crop_rgba 640x360", 200, [&] {
+        crop_rgba(rgba.data(), W * 4, {320, 180, 640, 360}, cut.data(), 640 * 4);
+        fcb_bench::do_not_optimize(cut[0]);
+    });
+    fcb_bench::measure("scale_bilinear_rgba 1080p -> 720p", 20, [&] {
+        scale_bilinear_rgba(rgba.data(), W, H, W * 4, small.data(), 1280, 720, 1280 * 4);
+        fcb_bench::do_not_optimize(small[0]);
+    });
+
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hw; threads *= 2) {
+        Pipeline pipe({{0, 0, 0, 0}, 1280, 720, threads});
+        fcb::FrameMsg out;
+        std::string name = "pipeline nv12 1080p -> rgba 720p, " +
+                           std::to_string(threads) + " thr";
+        fcb_bench::measure(name.c_str(), 20, [&] {
+            pipe.process(nv12, out);
+            fcb_bench::do_not_optimize(out.pixels[0]);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Worker-side cost of fcb::JsonIngest: simdjson parse plus conversion to POD
+// records, per message, for a small document, a large one and an NDJSON
+// batch.  benchmark/json_decode_benchmark.dart measures the Dart side on
+// the same documents (jsonDecode vs reading the POD records).
+//
+// Needs simdjson: configure with -DFCB_BENCH_SIMDJSON=ON.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/json_ingest.h"
+
+#include <string>
+
+namespace {
+
+// Same generator as json_decode_benchmark.dart.
+std::string make_doc(int i, int samples) {
+    std::string s = "{\"id\":" + std::to_string(i) + ",\"ok\":" + (i % 2 ? "false" : "true") +
+                    ",\"sensor\":{\"name\":\"probe-" + std::to_string(i % 16) +
+                    "\",\"temp\":" + std::to_string(20 + i % 10) + ".5,\"samples\":[";
+    for (int k = 0; k < samples; ++k) {
+        if (k) s += ',';
+        s += std::to_string(k % 1000) + ".25";
+    }
+    return s + "]}}";
+}
+
+} // namespace
+
+int main() {
+    struct Case { const char* name; int docs; int samples; };
+    const Case cases[] = {{"1 doc, 4 samples", 1, 4},
+                          {"1 doc, 500 samples", 1, 500},
+                          {"64 docs NDJSON, 4 samples", 64, 4}};
+    bool ok = true;
+    for (const Case& c : cases) {
+        std::string json;
+        for (int i = 0; i < c.docs; ++i) json += make_doc(i, c.samples) + "\n";
+
+        fcb::JsonIngest svc;
+        svc.mapping.add("/id", fcb::JsonType::Int64);
+        svc.mapping.add("/ok", fcb::JsonType::Bool);
+        svc.mapping.add("/sensor/temp", fcb::JsonType::Float64);
+        svc.mapping.add("/sensor/name", fcb::JsonType::String);
+        svc.mapping.add("/sensor/samples/0", fcb::JsonType::Float64);
+
+        fcb::BytesMsg input(json.begin(), json.end());
+        input.reserve(input.size() + simdjson::SIMDJSON_PADDING);
+        uint32_t records = 0;
+        std::string name = std::string("json_ingest ") + c.name + " (" +
+                           std::to_string(json.size()) + " B)";
+        double ns = fcb_bench::measure(name.c_str(), 2000, [&] {
+            std::optional<fcb::BytesMsg> out = svc.convert(input);
+            records = out ? reinterpret_cast<const fcb::JsonBatchHeader*>(out->data())->count : 0;
+            fcb_bench::do_not_optimize(out);
+        });
+        std::printf("    %8.0f ns/message %8.2f GB/s%s\n", ns, json.size() / ns,
+                    records != uint32_t(c.docs) || svc.errors() ? "  (MISMATCH)" : "");
+        ok &= records == uint32_t(c.docs) && svc.errors() == 0;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+// Throughput of fcb::ParallelStage with a CPU-heavy transform, from 1 to 32
+// pool threads.  Results are checked to come out in submission order.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/parallel_stage.h"
+
+#include <cmath>
+#include <string>
+
+namespace {
+
+// ~50 µs of floating-point work per message, standing in for a decode / FFT.
+std::optional<uint64_t> heavy(uint64_t& seq) {
+    double acc = double(seq);
+    for (int i = 0; i < 20000; ++i) acc = std::sin(acc) + 1.0000001 * i;
+    fcb_bench::do_not_optimize(acc);
+    return seq;
+}
+
+} // namespace
+
+int main() {
+    constexpr int kItems = 4000;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("hardware threads: %u\n", hw);
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        uint64_t expected = 0;
+        bool ordered = true;
+        std::string name = "parallel_stage " + std::to_string(threads) + " thr, " +
+                           std::to_string(kItems) + " msgs";
+        double ns = fcb_bench::measure(name.c_str(), 1, [&] {
+            expected = 0;
+            fcb::ParallelStage<uint64_t, uint64_t> stage(threads, heavy,
+                [&](uint64_t&& v) { ordered &= (v == expected++); });
+            for (uint64_t i = 0; i < kItems; ++i) stage.submit(i);
+            stage.drain();
+        });
+        std::printf("    %10.0f msg/s%s\n", kItems / (ns / 1e9),
+                    ordered ? "" : "  (ORDER VIOLATION)");
+        if (!ordered) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Throughput of fcb::SerialIngest on a pty pair standing in for a serial
+// port: a writer thread sends delimited, length-prefixed and COBS frames to
+// the master side in chunks, and the consumer counts frames and batches.
+// Every frame carries its sequence number, so loss and reordering show up
+// as a mismatch.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/serial_ingest.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+struct Result {
+    uint64_t frames  = 0;
+    uint64_t batches = 0;
+    uint64_t bad     = 0;
+};
+
+// A 24-byte payload: the sequence number in decimal, padded with letters.
+std::string payload(uint64_t seq) {
+    std::string s = std::to_string(seq);
+    s.resize(24, 'x');
+    return s;
+}
+
+std::string encode(fcb::SerialFraming framing, const std::string& p) {
+    switch (framing) {
+    case fcb::SerialFraming::LengthPrefix:
+        return std::string(1, char(p.size())) + std::string(1, '\0') + p;
+    case fcb::SerialFraming::Cobs: {   // payloads have no zeros: one block
+        std::string out(1, char(p.size() + 1));
+        return out + p + std::string(1, '\0');
+    }
+    default:
+        return p + "\n";
+    }
+}
+
+Result run(fcb::SerialFraming framing, uint64_t count) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::perror("posix_openpt");
+        std::exit(1);
+    }
+    termios tio;
+    tcgetattr(master, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(master, TCSANOW, &tio);
+
+    fcb::SerialIngest svc;
+    svc.config.path    = ptsname(master);
+    svc.config.framing = framing;
+    if (!svc.open()) { std::printf("open: %s\n", svc.error().c_str()); std::exit(1); }
+    svc.stop_flag.store(false);
+    std::thread ingest([&svc] { fcb::SerialIngest::run(svc); });
+
+    std::thread writer([&] {
+        std::string chunk;
+        for (uint64_t i = 0; i < count; ++i) {
+            chunk += encode(framing, payload(i));
+            if (chunk.size() >= 1024 || i + 1 == count) {
+                for (size_t at = 0; at < chunk.size();) {
+                    ssize_t n = write(master, chunk.data() + at, chunk.size() - at);
+                    if (n < 0) { std::perror("write"); return; }
+                    at += size_t(n);
+                }
+                chunk.clear();
+            }
+        }
+    });
+
+    Result r;
+    uint64_t idle = 0;
+    while (r.frames < count && idle < 20000) {
+        void* p = svc.next();
+        if (!p) { ++idle; std::this_thread::sleep_for(std::chrono::microseconds(50)); continue; }
+        idle = 0;
+        const auto* msg = static_cast<const fcb::BytesMsg*>(p);
+        fcb::SerialBatchHeader h;
+        std::memcpy(&h, msg->data(), sizeof h);
+        const auto* starts = reinterpret_cast<const uint32_t*>(msg->data() + h.offsets_at);
+        for (uint32_t i = 0; i < h.count; ++i) {
+            const char* f = reinterpret_cast<const char*>(msg->data() + sizeof h + starts[i]);
+            r.bad += std::string(f, starts[i + 1] - starts[i]) != payload(r.frames);
+            ++r.frames;
+        }
+        ++r.batches;
+        svc.release(p);
+    }
+    writer.join();
+    svc.request_stop();
+    ingest.join();
+    ::close(master);
+    return r;
+}
+
+} // namespace
+
+int main() {
+    struct Case { const char* name; fcb::SerialFraming framing; };
+    const Case cases[] = {{"delimiter", fcb::SerialFraming::Delimiter},
+                          {"length prefix", fcb::SerialFraming::LengthPrefix},
+                          {"COBS", fcb::SerialFraming::Cobs}};
+    const uint64_t count = 200000;
+    bool ok = true;
+    for (const Case& c : cases) {
+        Result r;
+        std::string name = std::string("serial_ingest pty ") + c.name;
+        double ns = fcb_bench::measure(name.c_str(), 1, [&] { r = run(c.framing, count); });
+        std::printf("    %10.0f frames/s %6.1f frames/message%s\n", r.frames / (ns / 1e9),
+                    r.batches ? double(r.frames) / r.batches : 0.0,
+                    r.bad || r.frames != count ? "  (MISMATCH)" : "");
+        ok &= r.bad == 0 && r.frames == count;
+    }
+    return ok ? 0 : 1;
+}
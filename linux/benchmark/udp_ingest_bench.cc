@@ -0,0 +1,117 @@
+// Loopback throughput of fcb::UdpIngest: a sender thread blasts numbered
+// datagrams with sendmmsg() (optionally as UDP_SEGMENT super-packets, which
+// the receiver's UDP_GRO keeps coalesced), the ingest thread batches them
+// with recvmmsg(), and a consumer drains the queue as Dart would.  Every
+// received datagram is checked against its sequence number.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/udp_ingest.h"
+
+#include <string>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103   // <linux/udp.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kPayload = 64;
+constexpr uint32_t kSegments = 32;   // datagrams per UDP_SEGMENT send
+
+struct Result {
+    uint64_t received = 0;
+    uint64_t corrupt  = 0;
+    double   seconds  = 0;
+};
+
+Result run(uint64_t count, bool gro, uint32_t batch) {
+    fcb::UdpIngest svc;
+    svc.config.address = "127.0.0.1";
+    svc.config.rcvbuf  = 8 << 20;   // capped by net.core.rmem_max
+    svc.config.batch   = batch;
+    svc.config.gro     = gro;
+    svc.config.max_datagram = gro ? 65535 : kPayload;
+    if (!svc.open()) { std::printf("open: %s\n", svc.error().c_str()); std::exit(1); }
+    const uint16_t port = svc.local_port();
+
+    svc.stop_flag.store(false);
+    std::thread ingest([&svc] { fcb::UdpIngest::run(svc); });
+
+    Result r;
+    std::atomic<bool> sent_all{false};
+    std::thread consumer([&] {
+        uint64_t idle = 0;
+        while (!sent_all.load() || idle < 2000) {
+            void* p = svc.next();
+            if (!p) { ++idle; std::this_thread::sleep_for(std::chrono::microseconds(50)); continue; }
+            idle = 0;
+            auto* b = static_cast<fcb::UdpBatch*>(p);
+            for (size_t i = 0; i < b->size(); ++i) {
+                uint64_t seq;
+                std::memcpy(&seq, b->datagram(i), sizeof seq);
+                r.corrupt += b->length(i) != kPayload || seq >= count;
+            }
+            r.received += b->size();
+            svc.release(p);
+        }
+    });
+
+    int tx = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_port   = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &to.sin_addr);
+    connect(tx, reinterpret_cast<sockaddr*>(&to), sizeof to);
+    if (gro) {
+        int seg = kPayload;
+        setsockopt(tx, IPPROTO_UDP, UDP_SEGMENT, &seg, sizeof seg);
+    }
+
+    const uint32_t per_send = gro ? kSegments : 1;
+    std::vector<uint8_t> buf(64 * per_send * kPayload);
+    std::vector<iovec>   iov(64);
+    std::vector<mmsghdr> msgs(64);
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t seq = 0; seq < count;) {
+        uint32_t n = 0;
+        for (; n < 64 && seq < count; ++n) {
+            uint8_t* at = buf.data() + n * per_send * kPayload;
+            uint32_t k = 0;
+            for (; k < per_send && seq < count; ++k, ++seq)
+                std::memcpy(at + k * kPayload, &seq, sizeof seq);
+            iov[n]  = {at, k * kPayload};
+            msgs[n] = mmsghdr{};
+            msgs[n].msg_hdr.msg_iov    = &iov[n];
+            msgs[n].msg_hdr.msg_iovlen = 1;
+        }
+        if (sendmmsg(tx, msgs.data(), n, 0) < 0) { std::perror("sendmmsg"); break; }
+    }
+    sent_all.store(true);
+    consumer.join();
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    // The consumer waits ~0.1 s of silence before returning.
+    r.seconds = std::max(r.seconds - 0.1, 1e-9);
+    close(tx);
+    svc.request_stop();
+    ingest.join();
+    return r;
+}
+
+} // namespace
+
+int main() {
+    constexpr uint64_t kCount = 2000000;
+    bool ok = true;
+    for (bool gro : {false, true}) {
+        for (uint32_t batch : {1u, 16u, 64u}) {
+            if (gro && batch == 1) continue;
+            Result r = run(kCount, gro, batch);
+            std::string name = std::string("udp_ingest ") + (gro ? "gro, " : "") +
+                               "batch " + std::to_string(batch);
+            std::printf("%-44s %12.0f dgram/s  %6.2f%% received%s\n", name.c_str(),
+                        r.received / r.seconds, 100.0 * r.received / kCount,
+                        r.corrupt ? "  (CORRUPT)" : "");
+            ok &= r.corrupt == 0;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// Throughput of fcb::UnixIngest over a SOCK_SEQPACKET socket, driven by
+// fcb::UnixClient from a producer thread: inline packets for small
+// payloads, passed memfds for large ones.  The consumer checks the first and
+// last byte of every payload, as Dart reading the view would fault it in.
+#include "bench_util.h"
+#include "flutter_cpp_bridge/unix_ingest.h"
+
+#include <string>
+
+namespace {
+
+struct Result {
+    uint64_t received = 0;
+    uint64_t bad      = 0;
+};
+
+Result run(size_t size, bool memfd, uint64_t count) {
+    fcb::UnixIngest svc;
+    svc.config.path = "@fcb-unix-ingest-bench";
+    if (!svc.open()) { std::printf("open: %s\n", svc.error().c_str()); std::exit(1); }
+    svc.stop_flag.store(false);
+    std::thread ingest([&svc] { fcb::UnixIngest::run(svc); });
+
+    std::thread producer([&] {
+        fcb::UnixClient client;
+        if (!client.connect(svc.config.path)) { std::perror("connect"); return; }
+        std::vector<uint8_t> payload(size);
+        for (uint64_t i = 0; i < count; ++i) {
+            payload.front() = payload.back() = uint8_t(i);
+            if (!(memfd ? client.send_memfd(payload.data(), size)
+                        : client.send_inline(payload.data(), size))) {
+                std::perror("send");
+                return;
+            }
+        }
+    });
+
+    Result r;
+    uint64_t idle = 0;
+    while (r.received < count && idle < 20000) {
+        void* p = svc.next();
+        if (!p) { ++idle; std::this_thread::sleep_for(std::chrono::microseconds(50)); continue; }
+        idle = 0;
+        auto* m = static_cast<fcb::UnixMsg*>(p);
+        const uint8_t want = uint8_t(r.received);
+        r.bad += m->size() != size || m->data()[0] != want || m->data()[size - 1] != want;
+        ++r.received;
+        svc.release(p);
+    }
+    producer.join();
+    svc.request_stop();
+    ingest.join();
+    return r;
+}
+
+} // namespace
+
+int main() {
+    struct Case { size_t size; bool memfd; uint64_t count; };
+    const Case cases[] = {
+        {256, false, 200000},    {16 << 10, false, 50000},
+        {64 << 10, true, 20000}, {1 << 20, true, 2000}, {16 << 20, true, 200},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        Result r;
+        std::string name = "unix_ingest " + std::to_string(c.size) + " B " +
+                           (c.memfd ? "memfd" : "inline");
+        double ns = fcb_bench::measure(name.c_str(), 1, [&] { r = run(c.size, c.memfd, c.count); });
+        const double s = ns / 1e9;
+        std::printf("    %10.0f msg/s %8.2f GB/s%s\n", r.received / s,
+                    r.received * double(c.size) / s / 1e9,
+                    r.bad || r.received != c.count ? "  (MISMATCH)" : "");
+        ok &= r.bad == 0 && r.received == c.count;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+// Cost of the watchdog: one Watchdog::scan() over 16–1024 watched services,
+// and what the bookkeeping it relies on adds to Queue::push() + next().
+#include "bench_util.h"
+#include "flutter_cpp_bridge/watchdog.h"
+
+#include <string>
+
+namespace {
+
+constexpr int kMsgs = 100000;
+
+} // namespace
+
+int main() {
+    for (unsigned n : {16u, 128u, 1024u}) {
+        fcb::Watchdog wd;
+        wd.set_period(3600 * 1000);   // keep its thread out of the way
+        std::vector<std::unique_ptr<fcb::Queue<int>>> svcs;
+        for (unsigned i = 0; i < n; ++i) {
+            svcs.emplace_back(new fcb::Queue<int>);
+            svcs.back()->mark_started();
+            svcs.back()->set_consumer(true);
+            svcs.back()->push(int(i));
+            wd.watch(*svcs.back(), 2000, 5000, "svc" + std::to_string(i));
+        }
+
+        std::string name = "watchdog scan, " + std::to_string(n) + " services";
+        double ns = fcb_bench::measure(name.c_str(), 1000, [&] {
+            fcb_bench::do_not_optimize(wd.scan());
+        });
+        std::printf("    %8.1f ns per service\n", ns / n);
+        svcs.clear();   // unwatched by ~ServiceBase
+    }
+
+    // The clock reads and stores push() and next() now do for the watchdog.
+    fcb::Queue<int> q;
+    q.mark_started();
+    fcb_bench::measure("queue push + next + release, 100k msgs", 1, [&] {
+        for (int i = 0; i < kMsgs; ++i) {
+            q.push(i);
+            q.release(q.next());
+        }
+    });
+    fcb_bench::measure("coarse_now_ns(), 100k reads", 1, [&] {
+        for (int i = 0; i < kMsgs; ++i) fcb_bench::do_not_optimize(fcb::coarse_now_ns());
+    });
+    return 0;
+}
@@ -0,0 +1,403 @@
+// flutter_cpp_bridge/bus.h
+//
+// In-process topic bus between services: fcb::bus(), shared by every
+// service library in the process, and fcb::BusBridge, which exposes topics
+// to Dart as channel services.
+//
+// Requirements: C++17; libdl (link with ${CMAKE_DL_LIBS} on glibc older
+// than 2.34), through fcb::process_instance().
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/bus.h"
+//
+//   static fcb::BusBridge g_bridge;
+//
+//   FCB_EXPORT_BUS_SYMBOLS(g_bridge)
+//
+// On the Dart side, use BusBridge (bus_service.dart).
+//
+
+#pragma once
+#include "process_shared.h"
+#include "service_helpers.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+
+namespace fcb {
+
+// ── Bus ──────────────────────────────────────────────────────────────────────
+// In-process topic bus: services publish to named topics and other services
+// subscribe natively, so composing services never involves the UI thread.
+//
+//   • a message is built once and shared by every subscriber: BusMessage
+//     holds a reference-counted, immutable buffer (bytes or a typed value);
+//   • fan-out is lock-free: publish() walks a fixed array of subscriber
+//     slots with atomic loads; only subscribe/unsubscribe take a lock;
+//   • a subscriber is a callback, run on the publishing thread (keep it
+//     short: copy what you need or push it to your own queue), or a
+//     Queue<BusMessage>, e.g. a BusBridge channel read by Dart;
+//   • fcb::bus() is one instance per process, shared by every service
+//     library even though Dart loads each of them with RTLD_LOCAL.
+//
+//   // liba: publisher
+//   static fcb::BusTopic& colors = fcb::bus().topic("liba/color");
+//   if (colors.has_subscribers()) colors.publish_value(Color{r, g, b});
+//
+//   // libb: subscriber, kept for as long as it should receive
+//   static fcb::BusSubscription g_sub = fcb::bus().topic("liba/color")
+//       .subscribe([](const fcb::BusMessage& m) {
+//           if (const Color* c = m.as<Color>()) g_svc.push(mix(*c));
+//       });
+//
+// Typed values are matched by typeid, so both sides must be built from the
+// same type definition.
+class BusMessage {
+public:
+    BusMessage() = default;
+
+    // Takes ownership of a byte buffer.
+    static BusMessage bytes(BytesMsg buf) {
+        auto p = std::make_shared<const BytesMsg>(std::move(buf));
+        return BusMessage(p, p->data(), p->size(), nullptr);
+    }
+    static BusMessage copy(const void* data, size_t size) {
+        const auto* b = static_cast<const uint8_t*>(data);
+        return bytes(BytesMsg(b, b + size));
+    }
+    // A typed value; data()/size() expose its object representation, which
+    // Dart can read when T is trivially copyable.
+    template<typename T>
+    static BusMessage value(T v) {
+        auto p = std::make_shared<const T>(std::move(v));
+        return BusMessage(p, p.get(), sizeof(T), &typeid(T));
+    }
+
+    const uint8_t* data() const noexcept { return static_cast<const uint8_t*>(_data); }
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return !_data; }
+
+    // The value if this message was built by value<T>(), else nullptr.
+    template<typename T>
+    const T* as() const noexcept {
+        return _type && *_type == typeid(T) ? static_cast<const T*>(_data) : nullptr;
+    }
+
+private:
+    BusMessage(std::shared_ptr<const void> hold, const void* data, size_t size,
+               const std::type_info* type)
+        : _hold(std::move(hold)), _data(data), _size(size), _type(type) {}
+
+    std::shared_ptr<const void> _hold;
+    const void*                 _data = nullptr;
+    size_t                      _size = 0;
+    const std::type_info*       _type = nullptr;
+};
+
+// Each queue holding a message accounts the shared buffer in full.
+inline size_t message_bytes(const BusMessage& m) noexcept {
+    return sizeof(BusMessage) + m.size();
+}
+
+class BusTopic;
+
+// Keeps a subscription alive; unsubscribes when destroyed or reset().
+// Empty (false) if the topic had no free slot.
+class BusSubscription {
+public:
+    BusSubscription() = default;
+    BusSubscription(BusSubscription&& o) noexcept
+        : _topic(std::exchange(o._topic, nullptr)), _sink(std::exchange(o._sink, nullptr)) {}
+    BusSubscription& operator=(BusSubscription&& o) noexcept {
+        if (this != &o) {
+            reset();
+            _topic = std::exchange(o._topic, nullptr);
+            _sink  = std::exchange(o._sink, nullptr);
+        }
+        return *this;
+    }
+    ~BusSubscription() { reset(); }
+
+    explicit operator bool() const noexcept { return _sink != nullptr; }
+
+    // Unsubscribes.  Once it returns the callback is not running and will
+    // not be called again, so must not be called from the callback itself.
+    inline void reset();
+
+private:
+    friend class BusTopic;
+    struct Sink;
+    BusSubscription(BusTopic* topic, Sink* sink) : _topic(topic), _sink(sink) {}
+
+    BusTopic* _topic = nullptr;
+    Sink*     _sink  = nullptr;
+};
+
+struct BusSubscription::Sink {
+    std::function<void(const BusMessage&)> fn;
+    std::atomic<bool>     active{true};
+    std::atomic<uint32_t> inflight{0};   // publishers inside fn
+    bool                  idle = false;  // reusable; under the topic's _mtx
+};
+
+class BusTopic {
+public:
+    static constexpr uint32_t kMaxSubscribers = 64;
+    using Callback = std::function<void(const BusMessage&)>;
+
+    explicit BusTopic(std::string name) : _name(std::move(name)) {}
+    BusTopic(const BusTopic&) = delete;
+    BusTopic& operator=(const BusTopic&) = delete;
+
+    const std::string& name() const noexcept { return _name; }
+
+    // Delivers m to every subscriber on the calling thread and returns how
+    // many received it.  Never blocks on other publishers or on
+    // (un)subscribing; queue subscribers take their queue's lock to push.
+    size_t publish(const BusMessage& m) {
+        _published.fetch_add(1, std::memory_order_relaxed);
+        size_t n = 0;
+        const uint32_t used = _used.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < used; ++i) {
+            Sink* s = _slots[i].load(std::memory_order_acquire);
+            if (!s) continue;
+            // Pairs with _unsubscribe(): either it sees us in flight and
+            // waits, or we see active == false and skip the sink.
+            s->inflight.fetch_add(1, std::memory_order_seq_cst);
+            if (s->active.load(std::memory_order_seq_cst)) {
+                s->fn(m);
+                ++n;
+            }
+            s->inflight.fetch_sub(1, std::memory_order_release);
+        }
+        return n;
+    }
+    size_t publish_bytes(BytesMsg buf) { return publish(BusMessage::bytes(std::move(buf))); }
+    size_t publish_copy(const void* data, size_t size) {
+        return publish(BusMessage::copy(data, size));
+    }
+    template<typename T>
+    size_t publish_value(T v) { return publish(BusMessage::value(std::move(v))); }
+
+    // Lets publishers skip building messages nobody receives.
+    bool has_subscribers() const noexcept {
+        return _subscribers.load(std::memory_order_relaxed) > 0;
+    }
+    uint32_t subscribers() const noexcept {
+        return _subscribers.load(std::memory_order_relaxed);
+    }
+    uint64_t published() const noexcept { return _published.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] BusSubscription subscribe(Callback fn) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        uint32_t i = 0;
+        while (i < kMaxSubscribers && _slots[i].load(std::memory_order_relaxed)) ++i;
+        if (i == kMaxSubscribers) return {};
+        // Sinks are never freed (a publisher may still hold a pointer it
+        // loaded before the slot was cleared), but an idle one is reused
+        // once no publisher is inside it: a late publisher then either sees
+        // it inactive or delivers to the new callback of the same topic.
+        Sink* s = nullptr;
+        for (const auto& p : _sinks) {
+            if (p->idle && p->inflight.load(std::memory_order_seq_cst) == 0) {
+                s = p.get();
+                break;
+            }
+        }
+        if (!s) {
+            _sinks.emplace_back(new Sink);
+            s = _sinks.back().get();
+        }
+        s->idle = false;
+        s->fn   = std::move(fn);
+        s->active.store(true, std::memory_order_seq_cst);   // after fn
+        _slots[i].store(s, std::memory_order_release);
+        if (i >= _used.load(std::memory_order_relaxed))
+            _used.store(i + 1, std::memory_order_release);
+        _subscribers.fetch_add(1, std::memory_order_relaxed);
+        return BusSubscription(this, s);
+    }
+
+    // Pushes every message into q while q is started (not stopped()).
+    [[nodiscard]] BusSubscription subscribe(Queue<BusMessage>& q) {
+        return subscribe([&q](const BusMessage& m) { if (!q.stopped()) q.push(m); });
+    }
+
+private:
+    friend class BusSubscription;
+    using Sink = BusSubscription::Sink;
+
+    void _unsubscribe(Sink* s) {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            s->active.store(false, std::memory_order_seq_cst);
+            for (uint32_t i = 0; i < kMaxSubscribers; ++i)
+                if (_slots[i].load(std::memory_order_relaxed) == s)
+                    _slots[i].store(nullptr, std::memory_order_relaxed);
+            _subscribers.fetch_sub(1, std::memory_order_relaxed);
+        }
+        // Outside the lock: a callback in flight may itself (un)subscribe.
+        while (s->inflight.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+        s->fn = nullptr;
+        std::lock_guard<std::mutex> lk(_mtx);
+        s->idle = true;
+    }
+
+    const std::string               _name;
+    std::atomic<Sink*>              _slots[kMaxSubscribers]{};
+    std::atomic<uint32_t>           _used{0};   // slots [0, _used) may be set
+    std::atomic<uint32_t>           _subscribers{0};
+    std::atomic<uint64_t>           _published{0};
+    std::mutex                      _mtx;
+    std::vector<std::unique_ptr<Sink>> _sinks;
+};
+
+inline void BusSubscription::reset() {
+    if (_sink) _topic->_unsubscribe(_sink);
+    _topic = nullptr;
+    _sink  = nullptr;
+}
+
+// Topics by name.  A topic is created on first use and lives as long as the
+// bus, so BusTopic references may be kept.
+class Bus {
+public:
+    BusTopic& topic(std::string_view name) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        auto it = _topics.find(name);
+        if (it == _topics.end())
+            it = _topics.emplace(std::string(name),
+                                 std::make_unique<BusTopic>(std::string(name))).first;
+        return *it->second;
+    }
+
+    std::vector<std::string> topics() const {
+        std::lock_guard<std::mutex> lk(_mtx);
+        std::vector<std::string> names;
+        for (const auto& t : _topics) names.push_back(t.first);
+        return names;
+    }
+
+private:
+    mutable std::mutex _mtx;
+    std::map<std::string, std::unique_ptr<BusTopic>, std::less<>> _topics;
+};
+
+} // namespace fcb
+
+// Every library built with this header exports a candidate instance (`used`
+// keeps the symbol even where calls are inlined); all of them adopt the one
+// of the earliest loaded library (see fcb::bus()).  The version suffix
+// changes whenever the layout of fcb::Bus does.
+FCB_EXPORT __attribute__((used)) inline void* fcb_bus_v1() {
+    static fcb::Bus* b = new fcb::Bus;   // never destroyed: outlives every user
+    return b;
+}
+
+namespace fcb {
+
+// The process-wide bus.
+inline Bus& bus() {
+    static Bus* const instance = static_cast<Bus*>(process_instance("fcb_bus_v1", fcb_bus_v1));
+    return *instance;
+}
+
+// Topics exposed to Dart as channels (FCB_EXPORT_BUS_SYMBOLS).  A channel
+// is subscribed while it is started, so stopped channels cost publishers
+// nothing.
+class BusBridge {
+public:
+    using Channel = Queue<BusMessage>;
+
+    // Uses fcb::bus() unless given another bus; resolved on first add(), not
+    // while the library is being loaded.
+    explicit BusBridge(Bus* b = nullptr) : _bus(b) {}
+    BusBridge(const BusBridge&) = delete;
+    BusBridge& operator=(const BusBridge&) = delete;
+
+    // Adds a channel for topic; returns its index.
+    uint32_t add(std::string_view topic) {
+        BusTopic& t = _target().topic(topic);
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        _topics.push_back(&t);
+        _subs.emplace_back();
+        _channels.emplace_back(new Channel);
+        _channels.back()->stop_flag.store(true, std::memory_order_relaxed);
+        return size() - 1;
+    }
+
+    // Publishes a copy of data on the bridge's bus (bus_publish from Dart).
+    size_t publish(std::string_view topic, const void* data, size_t size) {
+        return _target().topic(topic).publish_copy(data, size);
+    }
+
+    uint32_t size() const noexcept { return static_cast<uint32_t>(_channels.size()); }
+    Channel& channel(uint32_t i) noexcept { return *_channels[i]; }
+    BusTopic& topic(uint32_t i) noexcept { return *_topics[i]; }
+
+    // False if the topic already has BusTopic::kMaxSubscribers subscribers.
+    bool start_channel(uint32_t i) {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        Channel& ch = channel(i);
+        if (!ch.stopped()) return true;
+        ch.mark_started();
+        _subs[i] = _topics[i]->subscribe(ch);
+        if (!_subs[i]) ch.stop_flag.store(true, std::memory_order_relaxed);
+        return bool(_subs[i]);
+    }
+
+    void stop_channel(uint32_t i) {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        Channel& ch = channel(i);
+        if (ch.stopped()) return;
+        ch.request_stop();
+        _subs[i].reset();
+    }
+
+private:
+    Bus& _target() {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        if (!_bus) _bus = &bus();
+        return *_bus;
+    }
+
+    Bus*                                  _bus;
+    std::vector<BusTopic*>                _topics;
+    std::vector<BusSubscription>          _subs;
+    std::vector<std::unique_ptr<Channel>> _channels;
+    std::mutex                            _life_mtx;
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_BUS_SYMBOLS ───────────────────────────────────────────────────
+// FCB_EXPORT_CHANNEL_SYMBOLS for the channels of an fcb::BusBridge, plus:
+//
+//   bus_subscribe(topic)             →  uint32_t     new channel index
+//   bus_publish(topic, data, len)    →  uint32_t     subscribers reached
+//   bus_msg_data(msg)                →  const uint8_t*
+//   bus_msg_size(msg)                →  uint32_t
+//
+// bus_publish copies the bytes, so Dart may free them on return.
+//
+// On the Dart side, use BusBridge (bus_service.dart).
+//
+#define FCB_EXPORT_BUS_SYMBOLS(bridge)                                              \
+    FCB_EXPORT_CHANNEL_SYMBOLS((bridge).channel, (bridge).start_channel,            \
+                               (bridge).stop_channel)                               \
+    FCB_EXPORT uint32_t bus_subscribe(const char* topic) { return (bridge).add(topic); } \
+    FCB_EXPORT uint32_t bus_publish(const char* topic, const uint8_t* data,         \
+                                    uint32_t len) {                                 \
+        return static_cast<uint32_t>((bridge).publish(topic, data, len));           \
+    }                                                                               \
+    FCB_EXPORT const uint8_t* bus_msg_data(void* msg) {                             \
+        return static_cast<fcb::BusMessage*>(msg)->data();                          \
+    }                                                                               \
+    FCB_EXPORT uint32_t bus_msg_size(void* msg) {                                   \
+        return static_cast<uint32_t>(static_cast<fcb::BusMessage*>(msg)->size());   \
+    }
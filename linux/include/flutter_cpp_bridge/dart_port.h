@@ -0,0 +1,172 @@
+// flutter_cpp_bridge/dart_port.h
+//
+// Inline delivery for byte-buffer services: instead of notify → Dart calls
+// get_next_message() → Dart calls free_message() (one port post plus two FFI
+// calls per message), the worker posts the message itself to a Dart
+// ReceivePort with Dart_PostCObject.
+//
+//   • payloads up to inline_max bytes go as kTypedData — the VM copies them
+//     into the Dart heap and the native buffer is recycled immediately;
+//   • larger payloads go as kExternalTypedData — zero-copy; the finalizer
+//     returns the buffer to the service's BytesPool once Dart drops the last
+//     reference, so Dart may keep the Uint8List beyond the callback.
+//
+// Until Dart registers a port (PostedBytesService.assignBytesJob), push()
+// falls back to the regular queue, so pointer-based assignJob keeps working.
+//
+// Requirements: C++17, and the Dart SDK's dynamically-linked API shim:
+// add "<flutter>/bin/cache/dart-sdk/include" to the include path and compile
+// "<flutter>/bin/cache/dart-sdk/include/dart_api_dl.c" into the library
+// (see README, "CMake — Dart native API").
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/dart_port.h"
+//
+//   static fcb::PostedBytesQueue g_svc;
+//
+//   static void worker(fcb::PostedBytesQueue& svc) {
+//       while (svc.wait_for_consumer()) {
+//           fcb::BytesMsg buf = svc.pool.acquire(64 * 1024);   // recycled
+//           fill(buf);
+//           svc.push(std::move(buf));
+//       }
+//   }
+//
+//   FCB_EXPORT_POSTED_BYTES_SYMBOLS(g_svc, worker)
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include "dart_api_dl.h"
+
+namespace fcb {
+
+// ── BytesPool ────────────────────────────────────────────────────────────────
+// Free list of byte buffers so that steady-state producers do not hit the
+// allocator.  acquire() hands out an empty buffer with at least `reserve`
+// bytes of capacity; recycle() takes one back (up to max_cached buffers).
+class BytesPool {
+public:
+    explicit BytesPool(size_t max_cached = 64) : _max_cached(max_cached) {}
+
+    BytesMsg acquire(size_t reserve = 0) {
+        BytesMsg buf;
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            if (!_free.empty()) { buf = std::move(_free.back()); _free.pop_back(); }
+        }
+        buf.clear();
+        buf.reserve(reserve);
+        return buf;
+    }
+
+    void recycle(BytesMsg&& buf) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_free.size() < _max_cached) _free.push_back(std::move(buf));
+    }
+
+private:
+    std::mutex            _mtx;
+    std::vector<BytesMsg> _free;
+    size_t                _max_cached;
+};
+
+// ── PostedBytesQueue ─────────────────────────────────────────────────────────
+struct PostedBytesQueue : BytesQueue {
+    std::atomic<Dart_Port> port{ILLEGAL_PORT};
+    size_t                 inline_max = 4096;
+    BytesPool              pool;
+
+    // Both BytesQueue::push overloads post when a port is set; the TTL only
+    // applies to messages that fall back to the queue.
+    void push(BytesMsg msg) { push(std::move(msg), default_ttl); }
+
+    void push(BytesMsg msg, ttl_type ttl) {
+        Dart_Port p = port.load(std::memory_order_acquire);
+        if (p != ILLEGAL_PORT && post(p, msg)) return;
+        BytesQueue::push(std::move(msg), ttl);
+    }
+
+    // Returns false (msg untouched) if the port is closed or the Dart API
+    // has not been initialised.
+    bool post(Dart_Port p, BytesMsg& msg) {
+        if (Dart_PostCObject_DL == nullptr) return false;
+        Dart_CObject obj;
+        if (msg.size() <= inline_max) {
+            obj.type = Dart_CObject_kTypedData;
+            obj.value.as_typed_data.type   = Dart_TypedData_kUint8;
+            obj.value.as_typed_data.length = static_cast<intptr_t>(msg.size());
+            obj.value.as_typed_data.values = msg.data();
+            if (!Dart_PostCObject_DL(p, &obj)) return false;
+            _note_posted(0);
+            pool.recycle(std::move(msg));   // the VM copied it
+            return true;
+        }
+        const size_t bytes = message_bytes(msg);
+        auto* peer = new Peer{this, std::move(msg), bytes};
+        obj.type = Dart_CObject_kExternalTypedData;
+        obj.value.as_external_typed_data.type     = Dart_TypedData_kUint8;
+        obj.value.as_external_typed_data.length   = static_cast<intptr_t>(peer->buf.size());
+        obj.value.as_external_typed_data.data     = peer->buf.data();
+        obj.value.as_external_typed_data.peer     = peer;
+        obj.value.as_external_typed_data.callback = &PostedBytesQueue::_finalize;
+        if (Dart_PostCObject_DL(p, &obj)) {
+            _note_posted(static_cast<int64_t>(bytes));   // held until finalised
+            return true;
+        }
+        msg = std::move(peer->buf);         // not transferred: caller keeps it
+        delete peer;
+        return false;
+    }
+
+private:
+    struct Peer {
+        PostedBytesQueue* owner;
+        BytesMsg          buf;
+        size_t            bytes;
+    };
+
+    // A posted message takes a sequence number and stamps push and drain
+    // (it is in Dart already), so the registry and the watchdog see the
+    // same activity as for queued ones.  `held` bytes stay accounted, budget
+    // included, until the finalizer runs.
+    void _note_posted(int64_t held) {
+        std::lock_guard<std::mutex> lk(mtx);
+        last_seq.store(last_seq.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        if (held) _account(held);
+        const uint64_t depth = _q.size() - _out;
+        _note_push(depth);
+        _note_drain(depth);
+    }
+
+    static void _finalize(void* /*isolate_callback_data*/, void* peer) {
+        auto* p = static_cast<Peer*>(peer);
+        {
+            std::lock_guard<std::mutex> lk(p->owner->mtx);
+            p->owner->_account(-static_cast<int64_t>(p->bytes));
+        }
+        p->owner->pool.recycle(std::move(p->buf));
+        delete p;
+    }
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_POSTED_BYTES_SYMBOLS ──────────────────────────────────────────
+// FCB_EXPORT_BYTES_SYMBOLS plus the two symbols used by PostedBytesService:
+//
+//   fcb_init_dart_api(void* data)  →  intptr_t  Dart_InitializeApiDL result
+//                                               (0 on success)
+//   set_message_port(int64_t port) →  void      ILLEGAL_PORT (0) = use queue
+//
+#define FCB_EXPORT_POSTED_BYTES_SYMBOLS(svc, worker_fn)                             \
+    FCB_EXPORT_BYTES_SYMBOLS(svc, worker_fn)                                        \
+    FCB_EXPORT intptr_t fcb_init_dart_api(void* data) {                             \
+        return Dart_InitializeApiDL(data);                                          \
+    }                                                                               \
+    FCB_EXPORT void set_message_port(int64_t port) {                                \
+        (svc).port.store(port, std::memory_order_release);                          \
+    }
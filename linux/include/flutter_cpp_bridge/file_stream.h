@@ -0,0 +1,516 @@
+// flutter_cpp_bridge/file_stream.h
+//
+// Streams a large file (multi-gigabyte recordings) to Dart in fixed-size
+// chunks, so Dart never reads it synchronously or copies it onto its heap.
+//
+//   • the reader thread reads into a fixed set of page-aligned buffers,
+//     registered with io_uring (IORING_OP_READ_FIXED) when the kernel
+//     allows it;
+//   • up to config.read_ahead reads are in flight; completed chunks are
+//     queued in file order, each one a zero-copy view of its buffer (read it
+//     with get_msg_bytes / get_msg_len like any byte-buffer service);
+//   • a buffer is only reused once Dart frees its chunk, so config.buffers
+//     bounds memory and a slow consumer throttles the submissions;
+//   • without io_uring (old kernel, seccomp, io_uring_disabled) the reader
+//     falls back to pread() on the same buffers.  Regular files are always
+//     "ready" for epoll, so readiness polling would add nothing over a
+//     blocking pread on the reader thread.
+//
+// io_uring is driven through raw syscalls (<linux/io_uring.h>); liburing is
+// not needed.
+//
+// Requirements: C++17, Linux.
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/file_stream.h"
+//
+//   static fcb::FileStream g_svc;
+//
+//   FCB_EXPORT_FILE_STREAM_SYMBOLS(g_svc)
+//
+// On the Dart side, use FileStreamService (file_stream_service.dart).
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace fcb {
+
+// ── IoUring ──────────────────────────────────────────────────────────────────
+// Minimal io_uring wrapper over the raw syscalls: one submission and one
+// completion ring, enough for a single reader thread.
+class IoUring {
+public:
+    IoUring() = default;
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+    ~IoUring() { close(); }
+
+    // Returns false (errno set) if io_uring is unavailable.
+    bool init(unsigned entries) {
+        io_uring_params p{};
+        _fd = int(syscall(__NR_io_uring_setup, entries, &p));
+        if (_fd < 0) return false;
+        _sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        _cq_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        if (p.features & IORING_FEAT_SINGLE_MMAP) _sq_len = _cq_len = std::max(_sq_len, _cq_len);
+        _sq = mmap(nullptr, _sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   _fd, IORING_OFF_SQ_RING);
+        if (_sq == MAP_FAILED) { _sq = nullptr; return _fail(); }
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+            _cq = _sq;
+        } else {
+            _cq = mmap(nullptr, _cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       _fd, IORING_OFF_CQ_RING);
+            if (_cq == MAP_FAILED) { _cq = nullptr; return _fail(); }
+        }
+        _sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, _sqes_len, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return _fail();
+        _sqes = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<uint8_t*>(_sq);
+        auto* cq = static_cast<uint8_t*>(_cq);
+        _sq_head  = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        _sq_tail  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        _sq_mask  = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        _cq_head  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        _cq_tail  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        _cq_mask  = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        _cqes     = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        _entries  = p.sq_entries;
+        return true;
+    }
+
+    void close() noexcept {
+        if (_sqes) munmap(_sqes, _sqes_len);
+        if (_cq && _cq != _sq) munmap(_cq, _cq_len);
+        if (_sq) munmap(_sq, _sq_len);
+        if (_fd >= 0) ::close(_fd);
+        _sqes = nullptr;
+        _sq = _cq = nullptr;
+        _fd = -1;
+    }
+
+    bool     ok() const noexcept      { return _fd >= 0; }
+    unsigned entries() const noexcept { return _entries; }
+
+    bool register_buffers(const iovec* iov, unsigned n) noexcept {
+        return syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS, iov, n) == 0;
+    }
+
+    // Queues a read; submitted by the next enter().  buf_index < 0 reads
+    // into an unregistered buffer.
+    void prep_read(int fd, void* buf, unsigned len, uint64_t offset, int buf_index,
+                   uint64_t user_data) noexcept {
+        unsigned tail = *_sq_tail;
+        unsigned i    = tail & _sq_mask;
+        io_uring_sqe& sqe = _sqes[i];
+        std::memset(&sqe, 0, sizeof sqe);
+        sqe.opcode    = buf_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe.fd        = fd;
+        sqe.addr      = reinterpret_cast<uint64_t>(buf);
+        sqe.len       = len;
+        sqe.off       = offset;
+        sqe.buf_index = uint16_t(buf_index >= 0 ? buf_index : 0);
+        sqe.user_data = user_data;
+        _sq_array[i]  = i;
+        __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Submits the queued reads and waits for at least `wait` completions.
+    int enter(unsigned wait) noexcept {
+        int rc;
+        do {
+            // Reads not consumed by an interrupted call stay in the ring.
+            const unsigned n = *_sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+            rc = int(syscall(__NR_io_uring_enter, _fd, n, wait,
+                             wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+        } while (rc < 0 && errno == EINTR);
+        return rc;
+    }
+
+    // Calls fn(user_data, res) for every available completion.
+    template<typename Fn>
+    unsigned reap(Fn&& fn) {
+        unsigned head = *_cq_head, n = 0;
+        const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head, ++n) {
+            const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+            fn(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        return n;
+    }
+
+private:
+    bool _fail() noexcept {
+        int e = errno;
+        close();
+        errno = e;
+        return false;
+    }
+
+    int           _fd = -1;
+    void*         _sq = nullptr;
+    void*         _cq = nullptr;
+    size_t        _sq_len = 0, _cq_len = 0, _sqes_len = 0;
+    io_uring_sqe* _sqes = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+    unsigned*     _sq_head = nullptr;
+    unsigned*     _sq_tail = nullptr;
+    unsigned*     _sq_array = nullptr;
+    unsigned*     _cq_head = nullptr;
+    unsigned*     _cq_tail = nullptr;
+    unsigned      _sq_mask = 0, _cq_mask = 0, _entries = 0;
+};
+
+// ── FileChunk ────────────────────────────────────────────────────────────────
+// Buffers of one streaming run.  Shared by the reader and the chunks it
+// queued, so a restart never pulls memory out from under Dart.
+struct FileStreamBuffers {
+    uint8_t*                 memory = nullptr;
+    size_t                   chunk  = 0;
+    uint32_t                 count  = 0;
+    std::mutex               mtx;
+    std::condition_variable  cv;
+    std::vector<uint32_t>    free;   // indices of reusable buffers
+
+    FileStreamBuffers(size_t chunk_size, uint32_t n) : chunk(chunk_size), count(n) {
+        memory = static_cast<uint8_t*>(std::aligned_alloc(4096, chunk * n));
+        if (memory)
+            for (uint32_t i = n; i-- > 0;) free.push_back(i);
+    }
+    ~FileStreamBuffers() { std::free(memory); }
+
+    uint8_t* at(uint32_t i) const noexcept { return memory + i * chunk; }
+
+    void give_back(uint32_t i) {
+        { std::lock_guard<std::mutex> lk(mtx); free.push_back(i); }
+        cv.notify_one();
+    }
+};
+
+// One chunk of the file, in a buffer returned to the reader when freed.
+// The empty chunk that ends a range early (see FileStream) has no buffer.
+class FileChunk {
+public:
+    static constexpr uint32_t kNoBuffer = UINT32_MAX;
+
+    FileChunk(std::shared_ptr<FileStreamBuffers> bufs, uint32_t index, uint64_t offset,
+              uint32_t length, bool last)
+        : _bufs(std::move(bufs)), _index(index), _length(length), _last(last),
+          _offset(offset) {}
+    FileChunk(FileChunk&&) noexcept = default;
+    FileChunk& operator=(FileChunk&& o) noexcept {
+        if (this != &o) {
+            _give_back();
+            _bufs = std::move(o._bufs);
+            _index = o._index; _length = o._length; _last = o._last; _offset = o._offset;
+        }
+        return *this;
+    }
+    FileChunk(const FileChunk&) = delete;
+    FileChunk& operator=(const FileChunk&) = delete;
+    ~FileChunk() { _give_back(); }
+
+    const uint8_t* data() const noexcept {
+        return _index == kNoBuffer ? _bufs->memory : _bufs->at(_index);
+    }
+    uint32_t       size() const noexcept   { return _length; }
+    uint64_t       offset() const noexcept { return _offset; }
+    bool           last() const noexcept   { return _last; }
+
+private:
+    void _give_back() {
+        if (_bufs && _index != kNoBuffer) _bufs->give_back(_index);
+        _bufs.reset();
+    }
+
+    std::shared_ptr<FileStreamBuffers> _bufs;
+    uint32_t _index, _length;
+    bool     _last;
+    uint64_t _offset;
+};
+
+inline size_t message_bytes(const FileChunk& c) noexcept {
+    return sizeof(c) + c.size();
+}
+
+struct FileStreamConfig {
+    std::string path;
+    uint64_t    offset     = 0;         // first byte to stream
+    uint64_t    length     = 0;         // 0 = to the end of the file
+    uint32_t    chunk_size = 1 << 20;   // rounded up to 4 KiB
+    uint32_t    read_ahead = 4;         // reads in flight
+    uint32_t    buffers    = 8;         // in flight + queued + held by Dart
+    bool        io_uring   = true;      // false forces the pread fallback
+};
+
+// ── FileStream ───────────────────────────────────────────────────────────────
+struct FileStream : Queue<FileChunk> {
+    enum class Backend : uint8_t { None, Pread, IoUring, IoUringFixed };
+
+    // Edited from Dart (file_stream_* symbols) before start_service().
+    FileStreamConfig config;
+
+    ~FileStream() { close(); }
+
+    // Opens config.path.  Called from Dart before starting so that a missing
+    // file is reported synchronously.  Returns false and sets error() on
+    // failure.
+    bool open() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_fd >= 0) ::close(_fd);
+        _error.clear();
+        _fd = ::open(config.path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if (_fd < 0 || fstat(_fd, &st) != 0) return _fail("open " + config.path);
+        _size = uint64_t(st.st_size);
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    // Empty unless open() or the last run failed.
+    std::string error() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _error;
+    }
+
+    uint64_t file_size() const noexcept { return _size; }
+    Backend  backend() const noexcept   { return _backend.load(std::memory_order_relaxed); }
+
+    // Body of the reader thread started by FCB_EXPORT_FILE_STREAM_SYMBOLS.
+    // Streams the configured range once, then returns.  Unless stopped, the
+    // last chunk queued has last() set — an empty one if the range is empty
+    // or a read error ended it after its other chunks were queued — and the
+    // service is marked finished, so that the watchdog does not take the
+    // ended reader for a stuck one.
+    static void run(FileStream& svc) {
+        if (svc._fd >= 0 || svc.open()) svc._stream();
+        if (!svc.stopped()) svc.mark_finished();
+    }
+
+private:
+    struct Read {
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    void _stream() {
+        const FileStreamConfig cfg = config;
+        const size_t   chunk = (std::max<size_t>(cfg.chunk_size, 1) + 4095) & ~size_t(4095);
+        const uint32_t n     = std::max<uint32_t>(cfg.buffers, 1);
+        const uint32_t ahead = std::min(std::max<uint32_t>(cfg.read_ahead, 1), n);
+        auto bufs = std::make_shared<FileStreamBuffers>(chunk, n);
+        if (!bufs->memory) { _set_error("buffers: out of memory"); return; }
+
+        IoUring ring;
+        Backend backend = Backend::Pread;
+        if (cfg.io_uring && ring.init(ahead)) {
+            std::vector<iovec> iov(n);
+            for (uint32_t i = 0; i < n; ++i) iov[i] = {bufs->at(i), chunk};
+            // Registration pins the buffers; RLIMIT_MEMLOCK may refuse it.
+            backend = ring.register_buffers(iov.data(), n) ? Backend::IoUringFixed
+                                                           : Backend::IoUring;
+        }
+        _backend.store(backend, std::memory_order_relaxed);
+        // IORING_OP_READ is 5.6+ (READ_FIXED 5.1+): on older kernels a ring
+        // without registered buffers fails every read with EINVAL.
+        const bool op_read = backend == Backend::IoUring;
+
+        uint64_t end = cfg.length ? cfg.offset + cfg.length : _size;
+        end = std::min(end, _size);
+        uint64_t next = cfg.offset, emit = cfg.offset;
+        uint32_t inflight = 0, queued = 0;   // queued: in the ring
+        bool     ended = false;              // a chunk with last() queued
+        std::vector<Read>             reads(n);
+        std::map<uint64_t, uint32_t>  done;   // offset → buffer, waiting for order
+        std::vector<std::pair<uint32_t, int>> completed;
+
+        auto complete = [&](uint32_t idx, int res) {
+            --inflight;
+            Read& r = reads[idx];
+            if (res < 0) {
+                errno = -res;
+                _set_error("read " + cfg.path);
+                end = std::min(end, r.offset);
+            } else if (uint32_t(res) < r.length) {
+                end = std::min(end, r.offset + uint32_t(res));   // file shrank
+            }
+            r.length = res < 0 ? 0 : uint32_t(res);
+            if (r.offset < end) done.emplace(r.offset, idx);
+            else                bufs->give_back(idx);
+        };
+
+        while (!stopped()) {
+            // Submit while a buffer is free and the read-ahead allows it.
+            uint32_t idx;
+            while (inflight < ahead && next < end && _take(*bufs, idx)) {
+                const uint32_t len = uint32_t(std::min<uint64_t>(chunk, end - next));
+                reads[idx] = {next, len};
+                ++inflight;
+                if (backend == Backend::Pread) {
+                    completed.emplace_back(idx, _pread(bufs->at(idx), len, next));
+                } else {
+                    ring.prep_read(_fd, bufs->at(idx), len, next,
+                                   backend == Backend::IoUringFixed ? int(idx) : -1, idx);
+                    ++queued;
+                }
+                next += len;
+            }
+
+            if (queued > 0) {
+                if (ring.enter(1) < 0) {
+                    _set_error("io_uring_enter");
+                    break;
+                }
+                ring.reap([&](uint64_t user, int res) {
+                    --queued;
+                    const uint32_t i = uint32_t(user);
+                    if (res == -EINVAL && op_read) {   // redo it, and the rest, with pread
+                        backend = Backend::Pread;
+                        _backend.store(backend, std::memory_order_relaxed);
+                        res = _pread(bufs->at(i), reads[i].length, reads[i].offset);
+                    }
+                    complete(i, res);
+                });
+            }
+            for (auto& c : completed) complete(c.first, c.second);
+            completed.clear();
+
+            // Queue completed chunks in file order.
+            for (auto it = done.begin(); it != done.end() && it->first == emit;
+                 it = done.erase(it)) {
+                const Read& r = reads[it->second];
+                emit += r.length;
+                ended = emit >= end;
+                push(FileChunk(bufs, it->second, r.offset, r.length, ended));
+            }
+            if (emit >= end && inflight == 0) {
+                if (!ended)
+                    push(FileChunk(bufs, FileChunk::kNoBuffer, emit, 0, true));
+                break;
+            }
+
+            // All buffers queued or held by Dart: wait for one to come back.
+            if (inflight == 0) {
+                std::unique_lock<std::mutex> lk(bufs->mtx);
+                bufs->cv.wait_for(lk, std::chrono::milliseconds(100),
+                                  [&] { return !bufs->free.empty() || stopped(); });
+                heartbeat();   // alive while Dart holds the buffers (Watchdog)
+            }
+        }
+        // Drain reads still in flight before the ring and buffers go away.
+        while (queued > 0 && ring.enter(1) >= 0)
+            ring.reap([&](uint64_t user, int) { --queued; bufs->give_back(uint32_t(user)); });
+        for (auto& d : done) bufs->give_back(d.second);
+    }
+
+    int _pread(void* buf, uint32_t len, uint64_t offset) const noexcept {
+        const ssize_t got = pread(_fd, buf, len, off_t(offset));
+        return got < 0 ? -errno : int(got);
+    }
+
+    static bool _take(FileStreamBuffers& bufs, uint32_t& idx) {
+        std::lock_guard<std::mutex> lk(bufs.mtx);
+        if (bufs.free.empty()) return false;
+        idx = bufs.free.back();
+        bufs.free.pop_back();
+        return true;
+    }
+
+    void _set_error(const std::string& what) {
+        const int e = errno;
+        std::lock_guard<std::mutex> lk(_mtx);
+        _error = what + ": " + std::strerror(e);
+    }
+
+    bool _fail(const std::string& what) {
+        _error = what + ": " + std::strerror(errno);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    std::mutex           _mtx;     // _fd lifecycle and _error
+    int                  _fd = -1;
+    uint64_t             _size = 0;
+    std::string          _error;
+    std::atomic<Backend> _backend{Backend::None};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_FILE_STREAM_SYMBOLS ───────────────────────────────────────────
+// Mandatory symbols for an fcb::FileStream service (its reader thread is the
+// worker), the byte-buffer accessors and the streaming API:
+//
+//   file_stream_configure(path, offset, length, chunk_size, read_ahead,
+//                         buffers, io_uring)        →  void
+//   file_stream_open()       →  const char*  nullptr, or the error text
+//   file_stream_size()       →  uint64_t     size of the opened file
+//   file_stream_backend()    →  uint32_t     0 none yet, 1 pread, 2 io_uring,
+//                                            3 io_uring + registered buffers
+//   file_stream_error()      →  const char*  nullptr, or the read error
+//   get_msg_bytes(msg) / get_msg_len(msg)   zero-copy view of a chunk
+//   file_chunk_offset(msg)   →  uint64_t     file offset of the chunk
+//   file_chunk_last(msg)     →  bool         last chunk of the range
+//
+#define FCB_EXPORT_FILE_STREAM_SYMBOLS(svc)                                         \
+    FCB_EXPORT_SYMBOLS(svc, fcb::FileStream::run)                                   \
+    FCB_EXPORT void file_stream_configure(const char* path, uint64_t offset,        \
+                                          uint64_t length, uint32_t chunk_size,     \
+                                          uint32_t read_ahead, uint32_t buffers,    \
+                                          bool io_uring) {                          \
+        (svc).config.path       = path;                                             \
+        (svc).config.offset     = offset;                                           \
+        (svc).config.length     = length;                                           \
+        (svc).config.chunk_size = chunk_size;                                       \
+        (svc).config.read_ahead = read_ahead;                                       \
+        (svc).config.buffers    = buffers;                                          \
+        (svc).config.io_uring   = io_uring;                                         \
+    }                                                                               \
+    FCB_EXPORT const char* file_stream_open() {                                     \
+        static thread_local std::string error;                                      \
+        if ((svc).open()) return nullptr;                                           \
+        error = (svc).error();                                                      \
+        return error.c_str();                                                       \
+    }                                                                               \
+    FCB_EXPORT uint64_t file_stream_size() { return (svc).file_size(); }            \
+    FCB_EXPORT uint32_t file_stream_backend() {                                     \
+        return static_cast<uint32_t>((svc).backend());                              \
+    }                                                                               \
+    FCB_EXPORT const char* file_stream_error() {                                    \
+        static thread_local std::string error;                                      \
+        error = (svc).error();                                                      \
+        return error.empty() ? nullptr : error.c_str();                             \
+    }                                                                               \
+    FCB_EXPORT const uint8_t* get_msg_bytes(fcb::FileChunk* msg) { return msg->data(); } \
+    FCB_EXPORT uint32_t get_msg_len(fcb::FileChunk* msg) { return msg->size(); }    \
+    FCB_EXPORT uint64_t file_chunk_offset(fcb::FileChunk* msg) { return msg->offset(); } \
+    FCB_EXPORT bool file_chunk_last(fcb::FileChunk* msg) { return msg->last(); }
@@ -0,0 +1,358 @@
+// flutter_cpp_bridge/file_tail.h
+//
+// Tails growing log files and delivers their new lines to Dart in batches,
+// replacing worker loops that poll the file size on a timer.
+//
+//   • inotify wakes the tail thread when a file is written, moved, deleted
+//     or truncated, so an idle file costs nothing;
+//   • new data is read from the last offset in large blocks, directly into
+//     the message buffer;
+//   • lines are split with SIMD (AVX2 / SSE2 / NEON) newline search;
+//   • each block is one message — a packed LineBatch: a header, the raw
+//     bytes, then one uint32 start offset per line — so Dart builds its list
+//     lazily from a single buffer, with no FFI call or String per line;
+//   • a line still being written (no '\n' yet) is carried over to the next
+//     batch; rotated or recreated files are reopened from the start, and a
+//     truncated file is read again from offset 0.
+//
+// Requirements: C++17, Linux (inotify).
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/file_tail.h"
+//
+//   static fcb::FileTail g_svc;
+//
+//   FCB_EXPORT_FILE_TAIL_SYMBOLS(g_svc)
+//
+// On the Dart side, use FileTailService (file_tail_service.dart).
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#  include <immintrin.h>
+#  define FCB_TAIL_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define FCB_TAIL_NEON 1
+#endif
+
+namespace fcb {
+
+// ── LineBatch layout ─────────────────────────────────────────────────────────
+// A message is one BytesMsg laid out as:
+//
+//   LineBatchHeader
+//   bytes[bytes_len]                raw file bytes, '\n' included
+//   padding to 4 bytes
+//   uint32_t starts[count + 1]      at offsets_at; line i is
+//                                   bytes[starts[i], starts[i + 1])
+//
+// Offsets are relative to `bytes`.  A line cut by max_line has no '\n', so
+// its successor starts right after it; Dart trims a trailing '\n' instead of
+// assuming one.
+struct LineBatchHeader {
+    uint32_t file;          // index of the path (add order)
+    uint32_t count;         // lines in the batch
+    uint32_t bytes_len;
+    uint32_t offsets_at;    // from the start of the message
+    uint64_t file_offset;   // file offset of bytes[0]
+};
+static_assert(sizeof(LineBatchHeader) == 24, "LineBatchHeader layout is shared with Dart");
+
+namespace detail {
+
+// Calls fn(i) for the index of every '\n' in p[from, n).
+template<typename Fn>
+inline void newlines_scalar(const uint8_t* p, size_t from, size_t n, Fn& fn) {
+    const uint8_t* at = p + from;
+    const uint8_t* end = p + n;
+    while (at < end) {
+        auto* nl = static_cast<const uint8_t*>(std::memchr(at, '\n', size_t(end - at)));
+        if (!nl) return;
+        fn(size_t(nl - p));
+        at = nl + 1;
+    }
+}
+
+#if defined(FCB_TAIL_X86)
+template<typename Fn>
+__attribute__((target("avx2")))
+inline size_t newlines_avx2(const uint8_t* p, size_t n, Fn& fn) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    // 64 bytes per step; blocks without a newline (long lines) cost one test.
+    for (; i + 64 <= n; i += 64) {
+        __m256i a = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), nl);
+        __m256i b = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 32)), nl);
+        if (_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_or_si256(a, b))) continue;
+        uint64_t mask = uint64_t(uint32_t(_mm256_movemask_epi8(a))) |
+                        uint64_t(uint32_t(_mm256_movemask_epi8(b))) << 32;
+        for (; mask; mask &= mask - 1) fn(i + size_t(__builtin_ctzll(mask)));
+    }
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+        for (; mask; mask &= mask - 1) fn(i + size_t(__builtin_ctz(mask)));
+    }
+    return i;
+}
+
+template<typename Fn>
+inline size_t newlines_sse2(const uint8_t* p, size_t n, Fn& fn) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+        for (; mask; mask &= mask - 1) fn(i + size_t(__builtin_ctz(mask)));
+    }
+    return i;
+}
+
+inline bool tail_has_avx2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+#endif
+
+#if defined(FCB_TAIL_NEON)
+// Narrowing shift packs the 16 byte-compare results into 4 bits each.
+template<typename Fn>
+inline size_t newlines_neon(const uint8_t* p, size_t n, Fn& fn) {
+    const uint8x16_t nl = vdupq_n_u8('\n');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(p + i), nl);
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        mask &= 0x8888888888888888ull;   // one bit per matching byte
+        for (; mask; mask &= mask - 1) fn(i + size_t(__builtin_ctzll(mask) >> 2));
+    }
+    return i;
+}
+#endif
+
+} // namespace detail
+
+// Calls fn(i) for the index of every '\n' in p[0, n), in order.
+template<typename Fn>
+inline void for_each_newline(const uint8_t* p, size_t n, Fn&& fn) {
+    size_t i = 0;
+#if defined(FCB_TAIL_X86)
+    i = detail::tail_has_avx2() ? detail::newlines_avx2(p, n, fn)
+                                : detail::newlines_sse2(p, n, fn);
+#elif defined(FCB_TAIL_NEON)
+    i = detail::newlines_neon(p, n, fn);
+#endif
+    detail::newlines_scalar(p, i, n, fn);
+}
+
+// Which newline search for_each_newline() uses on this machine.
+inline const char* newline_simd_path() {
+#if defined(FCB_TAIL_X86)
+    return detail::tail_has_avx2() ? "avx2" : "sse2";
+#elif defined(FCB_TAIL_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+struct FileTailConfig {
+    std::vector<std::string> paths;
+    uint32_t block      = 1 << 20;   // bytes read per batch
+    uint32_t max_line   = 1 << 20;   // longer lines are cut
+    bool     from_start = false;     // false: only lines written from now on
+};
+
+// ── FileTail ─────────────────────────────────────────────────────────────────
+struct FileTail : BytesQueue {
+    // Edited from Dart (file_tail_* symbols) before start_service().
+    FileTailConfig config;
+
+    // Body of the tail thread started by FCB_EXPORT_FILE_TAIL_SYMBOLS.
+    static void run(FileTail& svc) { svc._tail(); }
+
+private:
+    struct File {
+        std::string path;
+        int         fd = -1;
+        int         wd = -1;
+        uint64_t    offset = 0;   // next byte to read
+        BytesMsg    carry;        // incomplete last line
+        uint64_t    carry_at = 0; // file offset of carry[0]
+    };
+
+    void _tail() {
+        int in = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (in < 0) return;
+        std::vector<File> files(config.paths.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            files[i].path = config.paths[i];
+            _open(in, files[i], !config.from_start);
+        }
+        alignas(inotify_event) char events[4096];
+        pollfd pfd{in, POLLIN, 0};
+
+        while (!stopped()) {
+            for (uint32_t i = 0; i < files.size(); ++i) _drain(i, files[i]);
+            // The timeout retries files that do not exist yet.
+            int rc = poll(&pfd, 1, 500);
+            heartbeat();   // alive while the files are quiet (Watchdog)
+            if (rc < 0 && errno != EINTR) break;
+            if (rc > 0) {
+                ssize_t len;
+                while ((len = read(in, events, sizeof events)) > 0) {
+                    for (char* at = events; at < events + len;) {
+                        auto* ev = reinterpret_cast<inotify_event*>(at);
+                        at += sizeof(inotify_event) + ev->len;
+                        if (!(ev->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB)))
+                            continue;
+                        for (uint32_t i = 0; i < files.size(); ++i) {
+                            if (files[i].wd != ev->wd) continue;
+                            // While we hold it open, unlinking only shows up
+                            // as IN_ATTRIB with no links left.
+                            struct stat st;
+                            if ((ev->mask & IN_ATTRIB) && fstat(files[i].fd, &st) == 0 &&
+                                st.st_nlink > 0)
+                                continue;
+                            _drain(i, files[i]);   // what was written before
+                            _close(in, files[i]);
+                        }
+                    }
+                }
+            }
+            for (auto& f : files)
+                if (f.fd < 0) _open(in, f, false);
+        }
+        for (auto& f : files) _close(in, f);
+        ::close(in);
+    }
+
+    // Opens f.path (a rotated file is read from its start).
+    void _open(int in, File& f, bool at_end) {
+        f.fd = ::open(f.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (f.fd < 0) return;
+        f.wd = inotify_add_watch(in, f.path.c_str(),
+                                 IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+        struct stat st;
+        f.offset = at_end && fstat(f.fd, &st) == 0 ? uint64_t(st.st_size) : 0;
+        f.carry.clear();
+        f.carry_at = f.offset;
+    }
+
+    void _close(int in, File& f) {
+        if (f.wd >= 0) inotify_rm_watch(in, f.wd);
+        if (f.fd >= 0) ::close(f.fd);
+        f.fd = f.wd = -1;
+    }
+
+    // Reads everything past f.offset, one batch per block.
+    void _drain(uint32_t index, File& f) {
+        if (f.fd < 0) return;
+        const size_t head  = sizeof(LineBatchHeader);
+        const size_t block = std::max<uint32_t>(config.block, 64);
+        while (!stopped()) {
+            struct stat st;
+            if (fstat(f.fd, &st) != 0) return;
+            const uint64_t size = uint64_t(st.st_size);
+            if (size < f.offset) {   // truncated: start over
+                f.offset = 0;
+                f.carry.clear();
+                f.carry_at = 0;
+            }
+            const size_t want = size_t(std::min<uint64_t>(block, size - f.offset));
+            if (want == 0) return;
+            const size_t avail = f.carry.size() + want;
+            BytesMsg msg;
+            // Room for the offsets of ~16-byte lines without reallocating.
+            msg.reserve(head + avail + 4 + (avail / 16 + 2) * sizeof(uint32_t));
+            msg.resize(head + avail);
+            std::memcpy(msg.data() + head, f.carry.data(), f.carry.size());
+            ssize_t got = pread(f.fd, msg.data() + head + f.carry.size(), want,
+                                off_t(f.offset));
+            if (got <= 0) return;
+            f.offset += uint64_t(got);
+            _emit(index, f, msg, f.carry.size() + size_t(got));
+        }
+    }
+
+    // Splits msg's `avail` bytes into lines, keeps the incomplete tail in
+    // f.carry and queues the rest (if any line is complete).
+    void _emit(uint32_t index, File& f, BytesMsg& msg, size_t avail) {
+        const size_t head = sizeof(LineBatchHeader);
+        const uint8_t* bytes = msg.data() + head;
+        std::vector<uint32_t> starts{0};
+        size_t line_start = 0;
+        const size_t max_line = std::max<uint32_t>(config.max_line, 1);
+        for_each_newline(bytes, avail, [&](size_t nl) {
+            while (nl - line_start >= max_line) {   // cut overlong lines
+                line_start += max_line;
+                starts.push_back(uint32_t(line_start));
+            }
+            line_start = nl + 1;
+            starts.push_back(uint32_t(line_start));
+        });
+        while (avail - line_start >= max_line) {
+            line_start += max_line;
+            starts.push_back(uint32_t(line_start));
+        }
+        const uint64_t batch_at = f.carry_at;
+        f.carry.assign(bytes + line_start, bytes + avail);
+        f.carry_at = batch_at + line_start;
+        if (starts.size() == 1) return;
+
+        LineBatchHeader h;
+        h.file        = index;
+        h.count       = uint32_t(starts.size() - 1);
+        h.bytes_len   = uint32_t(line_start);
+        h.offsets_at  = uint32_t((head + line_start + 3) & ~size_t(3));
+        h.file_offset = batch_at;
+        msg.resize(h.offsets_at + starts.size() * sizeof(uint32_t));
+        std::memcpy(msg.data(), &h, sizeof h);
+        std::memcpy(msg.data() + h.offsets_at, starts.data(), starts.size() * sizeof(uint32_t));
+        push(std::move(msg));
+    }
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_FILE_TAIL_SYMBOLS ─────────────────────────────────────────────
+// FCB_EXPORT_BYTES_SYMBOLS for an fcb::FileTail (messages are LineBatch
+// buffers) plus the configuration API:
+//
+//   file_tail_configure(block, max_line, from_start)  →  bool  false while
+//                                   running; clears the paths added before
+//   file_tail_add_path(path)     →  uint32_t     file index in LineBatchHeader
+//   file_tail_simd_path()        →  const char*  "avx2", "sse2", "neon", …
+//
+#define FCB_EXPORT_FILE_TAIL_SYMBOLS(svc)                                           \
+    FCB_EXPORT_BYTES_SYMBOLS(svc, fcb::FileTail::run)                               \
+    FCB_EXPORT bool file_tail_configure(uint32_t block, uint32_t max_line,          \
+                                        bool from_start) {                          \
+        if ((svc).running()) return false;                                          \
+        (svc).config.paths.clear();                                                 \
+        (svc).config.block      = block;                                            \
+        (svc).config.max_line   = max_line;                                         \
+        (svc).config.from_start = from_start;                                       \
+        return true;                                                                \
+    }                                                                               \
+    FCB_EXPORT uint32_t file_tail_add_path(const char* path) {                      \
+        (svc).config.paths.emplace_back(path);                                      \
+        return static_cast<uint32_t>((svc).config.paths.size() - 1);                \
+    }                                                                               \
+    FCB_EXPORT const char* file_tail_simd_path() { return fcb::newline_simd_path(); }
@@ -0,0 +1,515 @@
+// flutter_cpp_bridge/frame_processing.h
+//
+// CPU frame-processing stage for camera / video services: YUV 4:2:0 → RGBA
+// colour conversion, crop and bilinear scaling, so that Dart receives
+// display-ready RGBA (ui.decodeImageFromPixels, Texture upload, …) instead
+// of converting in Dart or in per-service ad-hoc code.
+//
+//   • Colour conversion (BT.601, limited range) is vectorised with AVX2 on
+//     x86-64 — selected at run time, so the library still loads on CPUs
+//     without AVX2 — and with NEON on AArch64 / ARMv7 with NEON.
+//   • Crop is zero-copy on YUV input (plane pointers are offset).
+//   • Bilinear scaling is separable fixed-point: a horizontal pass per source
+//     row, then a vertical blend over contiguous 16-bit rows, written so the
+//     compiler vectorises it at -O2/-O3.
+//   • An optional TilePool splits every stage into row bands across threads.
+//
+// Requirements: C++17 or later.
+//
+// ─── Example: camera service delivering 640×360 RGBA ────────────────────────
+//
+//   #include "flutter_cpp_bridge/frame_processing.h"
+//
+//   static fcb::FrameQueue g_svc;
+//
+//   static void worker(fcb::FrameQueue& svc) {
+//       fcb::frame::Pipeline pipe({/*crop*/ {0, 60, 1920, 960},
+//                                  /*out_w*/ 640, /*out_h*/ 360,
+//                                  /*threads*/ 4});
+//       while (svc.wait_for_consumer()) {
+//           fcb::frame::YuvImage img = camera_dequeue();   // NV12 planes
+//           fcb::FrameMsg frame;
+//           pipe.process(img, frame);
+//           camera_requeue(img);
+//           svc.push(std::move(frame));
+//       }
+//   }
+//
+//   FCB_EXPORT_FRAME_SYMBOLS(g_svc, worker)
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <functional>
+#include <memory>
+
+#if defined(__x86_64__)
+#  include <immintrin.h>
+#  define FCB_FRAME_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define FCB_FRAME_NEON 1
+#endif
+
+namespace fcb {
+
+// ── FrameMsg / FrameQueue ────────────────────────────────────────────────────
+// Tightly described RGBA8888 frame.  pixels holds stride * height bytes.
+struct FrameMsg {
+    uint32_t             width  = 0;
+    uint32_t             height = 0;
+    uint32_t             stride = 0;   // bytes per row
+    std::vector<uint8_t> pixels;
+};
+inline size_t message_bytes(const FrameMsg& f) noexcept {
+    return sizeof(f) + f.pixels.capacity();
+}
+using FrameQueue = Queue<FrameMsg>;
+
+namespace frame {
+
+// ── Image descriptions ───────────────────────────────────────────────────────
+enum class YuvLayout : uint8_t {
+    I420,   // Y plane, U plane, V plane (each chroma plane w/2 × h/2)
+    NV12,   // Y plane, interleaved UV plane
+    NV21,   // Y plane, interleaved VU plane
+};
+
+// Non-owning view of a YUV 4:2:0 image.  For NV12 / NV21 only u (the
+// interleaved plane) and uv_stride are used.
+struct YuvImage {
+    YuvLayout      layout = YuvLayout::NV12;
+    uint32_t       width = 0, height = 0;
+    const uint8_t* y = nullptr;
+    const uint8_t* u = nullptr;
+    const uint8_t* v = nullptr;
+    uint32_t       y_stride = 0, uv_stride = 0;
+};
+
+struct Rect { uint32_t x = 0, y = 0, w = 0, h = 0; };
+
+// Zero-copy crop of a YUV view.  x / y are rounded down to even values so
+// that chroma stays aligned; w / h are clamped to the image.
+inline YuvImage crop(const YuvImage& in, Rect r) {
+    r.x &= ~1u;
+    r.y &= ~1u;
+    if (r.x >= in.width || r.y >= in.height) return YuvImage{in.layout};
+    r.w = std::min(r.w, in.width - r.x);
+    r.h = std::min(r.h, in.height - r.y);
+    YuvImage out = in;
+    out.width  = r.w;
+    out.height = r.h;
+    out.y = in.y + size_t(r.y) * in.y_stride + r.x;
+    size_t uv_row = size_t(r.y / 2) * in.uv_stride;
+    if (in.layout == YuvLayout::I420) {
+        out.u = in.u + uv_row + r.x / 2;
+        out.v = in.v + uv_row + r.x / 2;
+    } else {
+        out.u = in.u + uv_row + r.x;   // two bytes per chroma pair
+    }
+    return out;
+}
+
+// Copies a rectangle out of an RGBA buffer.
+inline void crop_rgba(const uint8_t* src, uint32_t src_stride, Rect r,
+                      uint8_t* dst, uint32_t dst_stride) {
+    for (uint32_t row = 0; row < r.h; ++row)
+        std::memcpy(dst + size_t(row) * dst_stride,
+                    src + size_t(r.y + row) * src_stride + size_t(r.x) * 4,
+                    size_t(r.w) * 4);
+}
+
+// ── TilePool ─────────────────────────────────────────────────────────────────
+// Minimal fork-join pool: run() splits [0, rows) into bands of `band` rows
+// and executes fn(first_row, end_row) on the pool threads and the caller.
+// With threads <= 1 everything runs inline on the caller.
+class TilePool {
+public:
+    explicit TilePool(unsigned threads) {
+        for (unsigned i = 1; i < threads; ++i)
+            _threads.emplace_back([this] { _loop(); });
+    }
+    ~TilePool() {
+        { std::lock_guard<std::mutex> lk(_mtx); _quit = true; }
+        _cv.notify_all();
+        for (auto& t : _threads) t.join();
+    }
+    TilePool(const TilePool&) = delete;
+    TilePool& operator=(const TilePool&) = delete;
+
+    unsigned size() const noexcept { return unsigned(_threads.size()) + 1; }
+
+    void run(uint32_t rows, uint32_t band,
+             const std::function<void(uint32_t, uint32_t)>& fn) {
+        band = std::max<uint32_t>(band, 1);
+        if (_threads.empty() || rows <= band) { fn(0, rows); return; }
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _fn = &fn;
+            _rows = rows;
+            _band = band;
+            _next.store(0, std::memory_order_relaxed);
+            _active = unsigned(_threads.size());
+            ++_generation;
+        }
+        _cv.notify_all();
+        _work();
+        std::unique_lock<std::mutex> lk(_mtx);
+        _done_cv.wait(lk, [this] { return _active == 0; });
+        _fn = nullptr;
+    }
+
+private:
+    void _work() {
+        for (;;) {
+            uint32_t first = _next.fetch_add(_band, std::memory_order_relaxed);
+            if (first >= _rows) return;
+            (*_fn)(first, std::min(_rows, first + _band));
+        }
+    }
+    void _loop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(_mtx);
+                _cv.wait(lk, [&] { return _quit || _generation != seen; });
+                if (_quit) return;
+                seen = _generation;
+            }
+            _work();
+            {
+                std::lock_guard<std::mutex> lk(_mtx);
+                if (--_active == 0) _done_cv.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex               _mtx;
+    std::condition_variable  _cv, _done_cv;
+    const std::function<void(uint32_t, uint32_t)>* _fn = nullptr;
+    std::atomic<uint32_t>    _next{0};
+    uint32_t                 _rows = 0, _band = 1;
+    unsigned                 _active = 0;
+    uint64_t                 _generation = 0;
+    bool                     _quit = false;
+};
+
+// ── Colour conversion kernels ────────────────────────────────────────────────
+namespace detail {
+
+// BT.601 limited range, 8-bit fixed point.
+inline uint32_t yuv_pixel(int y, int u, int v) {
+    int c = 298 * (y - 16) + 128;
+    int d = u - 128, e = v - 128;
+    auto clamp = [](int x) { return uint32_t(x < 0 ? 0 : (x > 255 ? 255 : x)); };
+    return clamp((c + 409 * e) >> 8)
+         | clamp((c - 100 * d - 208 * e) >> 8) << 8
+         | clamp((c + 516 * d) >> 8) << 16
+         | 0xFF000000u;
+}
+
+// One output row; `uv_step` is 1 for planar chroma and 2 for interleaved.
+inline void yuv_row_scalar(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                           unsigned uv_step, uint8_t* dst, uint32_t x, uint32_t width) {
+    for (; x < width; ++x) {
+        uint32_t px = yuv_pixel(y[x], u[(x / 2) * uv_step], v[(x / 2) * uv_step]);
+        std::memcpy(dst + size_t(x) * 4, &px, 4);
+    }
+}
+
+#if defined(FCB_FRAME_X86)
+// 8 pixels per iteration in 32-bit lanes; packed straight into RGBA words.
+__attribute__((target("avx2")))
+inline uint32_t yuv_row_avx2(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                             unsigned uv_step, uint8_t* dst, uint32_t width) {
+    const __m256i k16   = _mm256_set1_epi32(16);
+    const __m256i k128  = _mm256_set1_epi32(128);
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i k255  = _mm256_set1_epi32(255);
+    const __m256i alpha = _mm256_set1_epi32(int(0xFF000000u));
+    const __m256i dup   = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i even  = _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6);
+    const __m256i odd   = _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7);
+    uint32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        int64_t y8;
+        std::memcpy(&y8, y + x, 8);
+        __m256i yy = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(y8));
+        __m256i uu, vv;
+        if (uv_step == 1) {
+            int32_t u4, v4;
+            std::memcpy(&u4, u + x / 2, 4);
+            std::memcpy(&v4, v + x / 2, 4);
+            uu = _mm256_permutevar8x32_epi32(_mm256_cvtepu8_epi32(_mm_cvtsi32_si128(u4)), dup);
+            vv = _mm256_permutevar8x32_epi32(_mm256_cvtepu8_epi32(_mm_cvtsi32_si128(v4)), dup);
+        } else {
+            // u and v point into the same interleaved row (v = u ± 1).
+            const uint8_t* uv = std::min(u, v);
+            int64_t uv8;
+            std::memcpy(&uv8, uv + x, 8);
+            __m256i both = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(uv8));
+            __m256i lo = _mm256_permutevar8x32_epi32(both, even);
+            __m256i hi = _mm256_permutevar8x32_epi32(both, odd);
+            uu = (u < v) ? lo : hi;
+            vv = (u < v) ? hi : lo;
+        }
+        __m256i c = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(yy, k16),
+                                                        _mm256_set1_epi32(298)), k128);
+        __m256i d = _mm256_sub_epi32(uu, k128);
+        __m256i e = _mm256_sub_epi32(vv, k128);
+        __m256i r = _mm256_srai_epi32(_mm256_add_epi32(c, _mm256_mullo_epi32(e, _mm256_set1_epi32(409))), 8);
+        __m256i g = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_sub_epi32(c,
+                        _mm256_mullo_epi32(d, _mm256_set1_epi32(100))),
+                        _mm256_mullo_epi32(e, _mm256_set1_epi32(208))), 8);
+        __m256i b = _mm256_srai_epi32(_mm256_add_epi32(c, _mm256_mullo_epi32(d, _mm256_set1_epi32(516))), 8);
+        r = _mm256_min_epi32(_mm256_max_epi32(r, zero), k255);
+        g = _mm256_min_epi32(_mm256_max_epi32(g, zero), k255);
+        b = _mm256_min_epi32(_mm256_max_epi32(b, zero), k255);
+        __m256i px = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                                     _mm256_or_si256(_mm256_slli_epi32(b, 16), alpha));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + size_t(x) * 4), px);
+    }
+    return x;
+}
+
+inline bool cpu_has_avx2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+#endif
+
+#if defined(FCB_FRAME_NEON)
+// 8 pixels per iteration as two 4-lane halves.
+inline uint32_t yuv_row_neon(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                             unsigned uv_step, uint8_t* dst, uint32_t width) {
+    uint32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8_t ub[8], vb[8];
+        for (int i = 0; i < 8; ++i) {
+            ub[i] = u[((x + i) / 2) * uv_step];
+            vb[i] = v[((x + i) / 2) * uv_step];
+        }
+        int16x8_t yy = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + x)));
+        int16x8_t uu = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ub)));
+        int16x8_t vv = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(vb)));
+        yy = vsubq_s16(yy, vdupq_n_s16(16));
+        uu = vsubq_s16(uu, vdupq_n_s16(128));
+        vv = vsubq_s16(vv, vdupq_n_s16(128));
+        for (int half = 0; half < 2; ++half) {
+            int16x4_t y4 = half ? vget_high_s16(yy) : vget_low_s16(yy);
+            int16x4_t u4 = half ? vget_high_s16(uu) : vget_low_s16(uu);
+            int16x4_t v4 = half ? vget_high_s16(vv) : vget_low_s16(vv);
+            int32x4_t c = vmlal_n_s16(vdupq_n_s32(128), y4, 298);
+            int32x4_t r = vshrq_n_s32(vmlal_n_s16(c, v4, 409), 8);
+            int32x4_t g = vshrq_n_s32(vmlsl_n_s16(vmlsl_n_s16(c, u4, 100), v4, 208), 8);
+            int32x4_t b = vshrq_n_s32(vmlal_n_s16(c, u4, 516), 8);
+            int32x4_t lo = vdupq_n_s32(0), hi = vdupq_n_s32(255);
+            uint32x4_t ru = vreinterpretq_u32_s32(vminq_s32(vmaxq_s32(r, lo), hi));
+            uint32x4_t gu = vreinterpretq_u32_s32(vminq_s32(vmaxq_s32(g, lo), hi));
+            uint32x4_t bu = vreinterpretq_u32_s32(vminq_s32(vmaxq_s32(b, lo), hi));
+            uint32x4_t px = vorrq_u32(vorrq_u32(ru, vshlq_n_u32(gu, 8)),
+                                      vorrq_u32(vshlq_n_u32(bu, 16), vdupq_n_u32(0xFF000000u)));
+            vst1q_u32(reinterpret_cast<uint32_t*>(dst + size_t(x + half * 4) * 4), px);
+        }
+    }
+    return x;
+}
+#endif
+
+inline void yuv_row(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                    unsigned uv_step, uint8_t* dst, uint32_t width) {
+    uint32_t x = 0;
+#if defined(FCB_FRAME_X86)
+    if (cpu_has_avx2()) x = yuv_row_avx2(y, u, v, uv_step, dst, width);
+#elif defined(FCB_FRAME_NEON)
+    x = yuv_row_neon(y, u, v, uv_step, dst, width);
+#endif
+    yuv_row_scalar(y, u, v, uv_step, dst, x, width);
+}
+
+// Converts rows [row0, row1) of `in`; `row_fn` selects the row kernel.
+template<typename RowFn>
+inline void yuv_rows(const YuvImage& in, uint8_t* dst, uint32_t dst_stride,
+                     uint32_t row0, uint32_t row1, RowFn row_fn) {
+    for (uint32_t row = row0; row < row1; ++row) {
+        const uint8_t* yr = in.y + size_t(row) * in.y_stride;
+        const uint8_t* cr_u;
+        const uint8_t* cr_v;
+        unsigned step;
+        size_t uv_off = size_t(row / 2) * in.uv_stride;
+        switch (in.layout) {
+            case YuvLayout::I420: cr_u = in.u + uv_off; cr_v = in.v + uv_off; step = 1; break;
+            case YuvLayout::NV12: cr_u = in.u + uv_off; cr_v = cr_u + 1;      step = 2; break;
+            default:              cr_v = in.u + uv_off; cr_u = cr_v + 1;      step = 2; break;
+        }
+        row_fn(yr, cr_u, cr_v, step, dst + size_t(row) * dst_stride, in.width);
+    }
+}
+
+} // namespace detail
+
+// Which colour-conversion path yuv_to_rgba() takes on this machine.
+inline const char* simd_path() {
+#if defined(FCB_FRAME_X86)
+    return detail::cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(FCB_FRAME_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// Converts `in` into RGBA at `dst` (in.width × in.height, dst_stride bytes
+// per row).  Rows are split across `pool` when given.
+inline void yuv_to_rgba(const YuvImage& in, uint8_t* dst, uint32_t dst_stride,
+                        TilePool* pool = nullptr) {
+    auto band = [&](uint32_t r0, uint32_t r1) {
+        detail::yuv_rows(in, dst, dst_stride, r0, r1, detail::yuv_row);
+    };
+    if (pool) pool->run(in.height, 32, band);
+    else      band(0, in.height);
+}
+
+// Reference scalar conversion (benchmarks, tests).
+inline void yuv_to_rgba_scalar(const YuvImage& in, uint8_t* dst, uint32_t dst_stride) {
+    detail::yuv_rows(in, dst, dst_stride, 0, in.height,
+        [](const uint8_t* y, const uint8_t* u, const uint8_t* v, unsigned step,
+           uint8_t* d, uint32_t w) { detail::yuv_row_scalar(y, u, v, step, d, 0, w); });
+}
+
+// ── Bilinear scaling ─────────────────────────────────────────────────────────
+// Resamples an RGBA image to dst_w × dst_h (down- or up-scaling) with 8-bit
+// fractional weights and pixel-centre alignment.
+inline void scale_bilinear_rgba(const uint8_t* src, uint32_t src_w, uint32_t src_h,
+                                uint32_t src_stride, uint8_t* dst, uint32_t dst_w,
+                                uint32_t dst_h, uint32_t dst_stride,
+                                TilePool* pool = nullptr) {
+    if (!src_w || !src_h || !dst_w || !dst_h) return;
+
+    // Per-column source byte offsets and weight, shared by every row.
+    std::vector<uint32_t> xp(dst_w), xq(dst_w);
+    std::vector<uint16_t> fx(dst_w);
+    auto coord = [](uint32_t i, uint32_t s, uint32_t d, uint32_t& i0, uint16_t& f) {
+        int64_t pos = ((int64_t(2 * i + 1) * s << 8) / (2 * d)) - 128;   // 24.8
+        if (pos < 0) pos = 0;
+        i0 = uint32_t(pos >> 8);
+        f  = uint16_t(pos & 0xFF);
+        if (i0 >= s - 1) { i0 = s - 1; f = 0; }
+    };
+    for (uint32_t i = 0; i < dst_w; ++i) {
+        uint32_t x0;
+        coord(i, src_w, dst_w, x0, fx[i]);
+        xp[i] = x0 * 4;
+        xq[i] = std::min(x0 + 1, src_w - 1) * 4;
+    }
+
+    auto band = [&](uint32_t r0, uint32_t r1) {
+        // Horizontally filtered source rows; consecutive output rows mostly
+        // share them, so the last two are kept.
+        std::vector<uint16_t> top(size_t(dst_w) * 4), bot(size_t(dst_w) * 4);
+        uint32_t top_row = UINT32_MAX, bot_row = UINT32_MAX;
+        auto hpass = [&](uint32_t row, uint16_t* out) {
+            const uint8_t* base = src + size_t(row) * src_stride;
+            for (uint32_t i = 0; i < dst_w; ++i) {
+                const uint8_t* p = base + xp[i];
+                const uint8_t* q = base + xq[i];
+                uint32_t w1 = fx[i], w0 = 256 - w1;
+                uint16_t* o = out + size_t(i) * 4;
+                o[0] = uint16_t((p[0] * w0 + q[0] * w1) >> 1);   // ≤ 32640
+                o[1] = uint16_t((p[1] * w0 + q[1] * w1) >> 1);
+                o[2] = uint16_t((p[2] * w0 + q[2] * w1) >> 1);
+                o[3] = uint16_t((p[3] * w0 + q[3] * w1) >> 1);
+            }
+        };
+        for (uint32_t j = r0; j < r1; ++j) {
+            uint32_t y0; uint16_t fy;
+            coord(j, src_h, dst_h, y0, fy);
+            uint32_t y1 = std::min(y0 + 1, src_h - 1);
+            if (y0 == bot_row) { std::swap(top, bot); std::swap(top_row, bot_row); }
+            if (y0 != top_row) { hpass(y0, top.data()); top_row = y0; }
+            if (y1 != bot_row) { hpass(y1, bot.data()); bot_row = y1; }
+            // Vertical blend: contiguous, branch-free, auto-vectorised.
+            const uint32_t w1 = fy, w0 = 256 - fy;
+            uint8_t* out = dst + size_t(j) * dst_stride;
+            const uint16_t* a = top.data();
+            const uint16_t* b = bot.data();
+            for (size_t k = 0, n = size_t(dst_w) * 4; k < n; ++k)
+                out[k] = uint8_t((a[k] * w0 + b[k] * w1 + (1u << 14)) >> 15);
+        }
+    };
+    if (pool) pool->run(dst_h, 16, band);
+    else      band(0, dst_h);
+}
+
+// ── Pipeline ─────────────────────────────────────────────────────────────────
+// crop → colour conversion → optional scale, writing a FrameMsg.  Reuses its
+// intermediate buffer and the capacity of out.pixels between frames.
+class Pipeline {
+public:
+    struct Config {
+        Rect     crop;          // w == 0 → no crop; outside → empty frame
+        uint32_t out_w   = 0;   // 0 → keep (cropped) size
+        uint32_t out_h   = 0;
+        unsigned threads = 1;   // > 1 → tile across a private TilePool
+    };
+
+    explicit Pipeline(Config cfg)
+        : _cfg(cfg), _pool(cfg.threads > 1 ? new TilePool(cfg.threads) : nullptr) {}
+
+    void process(const YuvImage& in, FrameMsg& out) {
+        YuvImage img = _cfg.crop.w ? crop(in, _cfg.crop) : in;
+        if (!img.width || !img.height) {
+            // Crop outside the image: an empty frame, never stale pixels.
+            out.width = out.height = out.stride = 0;
+            out.pixels.clear();
+            return;
+        }
+        bool scale = _cfg.out_w && _cfg.out_h &&
+                     (_cfg.out_w != img.width || _cfg.out_h != img.height);
+        uint32_t w = scale ? _cfg.out_w : img.width;
+        uint32_t h = scale ? _cfg.out_h : img.height;
+        out.width  = w;
+        out.height = h;
+        out.stride = w * 4;
+        out.pixels.resize(size_t(out.stride) * h);
+        if (!scale) {
+            yuv_to_rgba(img, out.pixels.data(), out.stride, _pool.get());
+            return;
+        }
+        _rgba.resize(size_t(img.width) * 4 * img.height);
+        yuv_to_rgba(img, _rgba.data(), img.width * 4, _pool.get());
+        scale_bilinear_rgba(_rgba.data(), img.width, img.height, img.width * 4,
+                            out.pixels.data(), w, h, out.stride, _pool.get());
+    }
+
+private:
+    Config                    _cfg;
+    std::unique_ptr<TilePool> _pool;
+    std::vector<uint8_t>      _rgba;
+};
+
+} // namespace frame
+} // namespace fcb
+
+// ── FCB_EXPORT_FRAME_SYMBOLS ─────────────────────────────────────────────────
+// Variant of FCB_EXPORT_BYTES_SYMBOLS for fcb::FrameQueue services.
+// get_msg_bytes / get_msg_len return the RGBA pixels, so existing byte-buffer
+// Dart wrappers keep working; the frame geometry is exported as well:
+//
+//   get_frame_width (fcb::FrameMsg*)  →  uint32_t
+//   get_frame_height(fcb::FrameMsg*)  →  uint32_t
+//   get_frame_stride(fcb::FrameMsg*)  →  uint32_t   bytes per row
+//
+// On the Dart side, use FrameService (frame_service.dart).
+//
+#define FCB_EXPORT_FRAME_SYMBOLS(svc, worker_fn)                                    \
+    FCB_EXPORT_SYMBOLS(svc, worker_fn)                                              \
+    FCB_EXPORT const uint8_t* get_msg_bytes(fcb::FrameMsg* msg) { return msg->pixels.data(); } \
+    FCB_EXPORT uint32_t get_msg_len(fcb::FrameMsg* msg) {                           \
+        return static_cast<uint32_t>(msg->pixels.size());                           \
+    }                                                                               \
+    FCB_EXPORT uint32_t get_frame_width (fcb::FrameMsg* msg) { return msg->width;  } \
+    FCB_EXPORT uint32_t get_frame_height(fcb::FrameMsg* msg) { return msg->height; } \
+    FCB_EXPORT uint32_t get_frame_stride(fcb::FrameMsg* msg) { return msg->stride; }
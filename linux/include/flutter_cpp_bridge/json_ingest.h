@@ -0,0 +1,264 @@
+// flutter_cpp_bridge/json_ingest.h
+//
+// JSON ingest stage for bytes services: producers that emit JSON are parsed
+// natively with simdjson on the worker thread, so Dart never runs jsonDecode
+// on the UI isolate.
+//
+//   • fcb::JsonIngest converts JSON — one document or NDJSON — into a flat
+//     POD batch according to a mapping of JSON pointers to typed fields, set
+//     from Dart or C++ before the service starts;
+//   • fcb::for_each_json() hands each parsed document to your own code, e.g.
+//     to build a FlatBuffers Message (see README);
+//   • parsers are per thread, so convert() also runs as a ParallelStage
+//     transform when one worker thread cannot keep up.
+//
+// Batch layout (one BytesMsg):
+//
+//   JsonBatchHeader
+//   records[count]        record_size bytes each, 8-byte aligned:
+//                           uint64_t present   bit i set = field i was found
+//                           fields at their offsets (natural alignment)
+//   strings[strings_len]  at strings_at; a String field is
+//                           { uint32 offset into strings, uint32 length }
+//
+// Requirements: C++17, simdjson (see README, "CMake — simdjson").
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/json_ingest.h"
+//
+//   static fcb::JsonIngest g_svc;
+//
+//   static void worker(fcb::JsonIngest& svc) {
+//       while (!svc.stopped()) svc.ingest(receive_json());   // fcb::BytesMsg
+//   }
+//
+//   FCB_EXPORT_JSON_INGEST_SYMBOLS(g_svc, worker)
+//
+// On the Dart side, use JsonIngestService (json_ingest_service.dart).
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <simdjson.h>
+
+namespace fcb {
+
+// Field types, in the order of the Dart JsonFieldType enum.
+enum class JsonType : uint8_t { Bool, Int32, Int64, Float32, Float64, String };
+
+inline size_t json_type_size(JsonType t) noexcept {
+    switch (t) {
+    case JsonType::Bool:    return 1;
+    case JsonType::Int32:
+    case JsonType::Float32: return 4;
+    default:                return 8;   // Int64, Float64, String slot
+    }
+}
+
+struct JsonField {
+    std::string pointer;   // RFC 6901, e.g. "/sensor/temp"
+    JsonType    type;
+    uint32_t    offset;    // within the record
+};
+
+struct JsonBatchHeader {
+    uint32_t count;         // records
+    uint32_t record_size;
+    uint32_t strings_at;    // from the start of the message
+    uint32_t strings_len;
+};
+static_assert(sizeof(JsonBatchHeader) == 16, "JsonBatchHeader layout is shared with Dart");
+
+// Fixed record layout built from JSON pointers.  Not thread-safe while
+// fields are added; read-only afterwards.
+class JsonMapping {
+public:
+    // One presence bit per field.
+    static constexpr size_t kMaxFields = 64;
+
+    // Appends a field and returns its offset in the record, or -1 if the
+    // mapping is full or the pointer is not "" or "/…".
+    int32_t add(std::string pointer, JsonType type) {
+        if (_fields.size() == kMaxFields) return -1;
+        if (!pointer.empty() && pointer[0] != '/') return -1;
+        const size_t align = json_type_size(type);
+        const uint32_t offset = uint32_t((_end + align - 1) & ~(align - 1));
+        _fields.push_back({std::move(pointer), type, offset});
+        _end = offset + json_type_size(type);
+        return int32_t(offset);
+    }
+
+    // Removes every field, e.g. before a new wrapper sends its own.
+    void clear() noexcept {
+        _fields.clear();
+        _end = sizeof(uint64_t);
+    }
+
+    const std::vector<JsonField>& fields() const noexcept { return _fields; }
+
+    // Bytes per record, presence mask included.
+    uint32_t record_size() const noexcept { return uint32_t((_end + 7) & ~size_t(7)); }
+
+private:
+    std::vector<JsonField> _fields;
+    size_t                 _end = sizeof(uint64_t);   // after the presence mask
+};
+
+// Calls fn(simdjson::dom::element) for every document in `json` (one
+// document or NDJSON), parsed with a parser owned by the calling thread.
+// Grows json's capacity by SIMDJSON_PADDING if needed, so pass buffers with
+// spare capacity to avoid a copy.  Returns the number of documents that
+// failed to parse; parsing stops at the first one.
+template<typename Fn>
+inline size_t for_each_json(BytesMsg& json, Fn&& fn) {
+    if (json.empty()) return 0;
+    if (json.capacity() - json.size() < simdjson::SIMDJSON_PADDING)
+        json.reserve(json.size() + simdjson::SIMDJSON_PADDING);
+    thread_local simdjson::dom::parser parser;
+    const size_t batch = std::max<size_t>(json.size(), simdjson::dom::DEFAULT_BATCH_SIZE);
+    simdjson::dom::document_stream stream;
+    if (parser.parse_many(json.data(), json.size(), batch).get(stream)) return 1;
+    for (auto doc : stream) {
+        simdjson::dom::element root;
+        if (doc.get(root)) return 1;
+        fn(root);
+    }
+    return stream.truncated_bytes() > 0 ? 1 : 0;
+}
+
+// ── JsonIngest ───────────────────────────────────────────────────────────────
+struct JsonIngest : BytesQueue {
+    // Edited from Dart (json_ingest_add_field) before start_service().
+    JsonMapping mapping;
+
+    // JSON → POD batch, or nullopt if no document was converted.  Safe to
+    // call from several threads (ParallelStage) once the mapping is final.
+    std::optional<BytesMsg> convert(BytesMsg& json) {
+        const uint32_t size = mapping.record_size();
+        JsonBatchHeader h{};
+        BytesMsg out(sizeof h);
+        std::string strings;
+        _errors.fetch_add(for_each_json(json, [&](simdjson::dom::element root) {
+            out.resize(out.size() + size);
+            _fill(root, out.data() + out.size() - size, strings);
+            ++h.count;
+        }), std::memory_order_relaxed);
+        if (h.count == 0) return std::nullopt;
+
+        h.record_size = size;
+        h.strings_at  = uint32_t(out.size());
+        h.strings_len = uint32_t(strings.size());
+        out.insert(out.end(), strings.begin(), strings.end());
+        std::memcpy(out.data(), &h, sizeof h);
+        return out;
+    }
+
+    // convert() and push.  Returns false if nothing was queued.
+    bool ingest(BytesMsg json) {
+        std::optional<BytesMsg> batch = convert(json);
+        if (!batch) return false;
+        push(std::move(*batch));
+        return true;
+    }
+
+    // Documents that failed to parse so far.
+    uint64_t errors() const noexcept { return _errors.load(std::memory_order_relaxed); }
+
+private:
+    // Missing fields and type mismatches leave the field zero and its
+    // presence bit clear.  Numbers that do not fit the field type count as
+    // mismatches; floats accept integers.
+    void _fill(simdjson::dom::element root, uint8_t* rec, std::string& strings) const {
+        uint64_t present = 0;
+        const auto& fields = mapping.fields();
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const JsonField& f = fields[i];
+            simdjson::dom::element v;
+            if (root.at_pointer(f.pointer).get(v)) continue;
+            uint8_t* at = rec + f.offset;
+            bool ok = false;
+            switch (f.type) {
+            case JsonType::Bool: {
+                bool b;
+                if ((ok = !v.get_bool().get(b))) *at = b ? 1 : 0;
+                break;
+            }
+            case JsonType::Int32: {
+                int64_t n;
+                if ((ok = !v.get_int64().get(n) && n >= std::numeric_limits<int32_t>::min() &&
+                          n <= std::numeric_limits<int32_t>::max())) {
+                    int32_t n32 = int32_t(n);
+                    std::memcpy(at, &n32, sizeof n32);
+                }
+                break;
+            }
+            case JsonType::Int64: {
+                int64_t n;
+                if ((ok = !v.get_int64().get(n))) std::memcpy(at, &n, sizeof n);
+                break;
+            }
+            case JsonType::Float32: {
+                double d;
+                if ((ok = !v.get_double().get(d))) {
+                    float d32 = float(d);
+                    std::memcpy(at, &d32, sizeof d32);
+                }
+                break;
+            }
+            case JsonType::Float64: {
+                double d;
+                if ((ok = !v.get_double().get(d))) std::memcpy(at, &d, sizeof d);
+                break;
+            }
+            case JsonType::String: {
+                std::string_view s;
+                if ((ok = !v.get_string().get(s))) {
+                    const uint32_t slot[2] = {uint32_t(strings.size()), uint32_t(s.size())};
+                    std::memcpy(at, slot, sizeof slot);
+                    strings.append(s);
+                }
+                break;
+            }
+            }
+            if (ok) present |= uint64_t(1) << i;
+        }
+        std::memcpy(rec, &present, sizeof present);
+    }
+
+    std::atomic<uint64_t> _errors{0};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_JSON_INGEST_SYMBOLS ───────────────────────────────────────────
+// FCB_EXPORT_BYTES_SYMBOLS for an fcb::JsonIngest (messages are POD batches)
+// plus the mapping API:
+//
+//   json_ingest_clear_fields()            →  bool      false while running
+//   json_ingest_add_field(pointer, type)  →  int32_t   offset, or -1 (also
+//                                                       while running)
+//   json_ingest_record_size()             →  uint32_t
+//   json_ingest_errors()                  →  uint64_t  documents rejected
+//
+// `type` is an fcb::JsonType (0 bool, 1 int32, 2 int64, 3 float32,
+// 4 float64, 5 string).
+//
+#define FCB_EXPORT_JSON_INGEST_SYMBOLS(svc, worker_fn)                              \
+    FCB_EXPORT_BYTES_SYMBOLS(svc, worker_fn)                                        \
+    FCB_EXPORT bool json_ingest_clear_fields() {                                    \
+        if ((svc).running()) return false;                                          \
+        (svc).mapping.clear();                                                      \
+        return true;                                                                \
+    }                                                                               \
+    FCB_EXPORT int32_t json_ingest_add_field(const char* pointer, uint32_t type) {  \
+        if ((svc).running() || type > uint32_t(fcb::JsonType::String)) return -1;   \
+        return (svc).mapping.add(pointer, static_cast<fcb::JsonType>(type));        \
+    }                                                                               \
+    FCB_EXPORT uint32_t json_ingest_record_size() { return (svc).mapping.record_size(); } \
+    FCB_EXPORT uint64_t json_ingest_errors() { return (svc).errors(); }
@@ -0,0 +1,274 @@
+// flutter_cpp_bridge/mapped_file.h
+//
+// Random access to huge files (scrubbing through recordings) without loading
+// them: the file is mmap()ed read-only once, and Dart wraps any region
+// returned by view(offset, len) with asTypedList — no copy, no FFI call per
+// byte, and only the pages actually touched are read from disk.
+//
+//   • optional MAP_POPULATE pre-faults the whole file at open (small files
+//     that must never stall);
+//   • advise() applies madvise() access hints to the whole mapping or to a
+//     region (sequential playback vs random scrubbing);
+//   • prefetch() hands the region the UI will show next to a background
+//     thread that issues madvise(MADV_WILLNEED), so the page-cache reads
+//     start before the UI thread touches the pages.  Only the most recent
+//     requests are kept: a fast scrub does not queue stale prefetches.
+//
+// Views stay valid until stop_service() unmaps the file.  A new path is
+// mapped by configure() + open() once the service is stopped.
+//
+// Requirements: C++17, POSIX mmap.
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/mapped_file.h"
+//
+//   static fcb::MappedFile g_file;
+//
+//   FCB_EXPORT_MAPPED_FILE_SYMBOLS(g_file)
+//
+// On the Dart side, use MappedFileService (mapped_file_service.dart).
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fcb {
+
+// madvise() hints, in the order of the Dart MappedFileAccess enum.
+enum class MappedFileAccess : uint8_t { Normal, Sequential, Random };
+
+struct MappedFileConfig {
+    std::string      path;
+    bool             populate = false;   // MAP_POPULATE
+    MappedFileAccess access   = MappedFileAccess::Normal;
+};
+
+class MappedFile {
+public:
+    // Prefetch requests kept while the thread is busy; older ones are
+    // dropped.
+    static constexpr size_t kMaxPending = 4;
+
+    // Edited from Dart (mapped_file_configure) before open().
+    MappedFileConfig config;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { stop(); }
+
+    // Maps config.path.  Returns false and sets error() on failure.  A file
+    // that is already mapped stays mapped (views remain valid) until
+    // configure() or stop().
+    bool open() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_open) return true;
+        _error.clear();
+        int fd = ::open(config.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return _fail("open " + config.path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) { ::close(fd); return _fail("stat " + config.path); }
+        _size = size_t(st.st_size);
+        if (_size > 0) {
+            const int flags = MAP_PRIVATE | (config.populate ? MAP_POPULATE : 0);
+            void* p = mmap(nullptr, _size, PROT_READ, flags, fd, 0);
+            if (p == MAP_FAILED) { ::close(fd); _size = 0; return _fail("mmap " + config.path); }
+            _base = static_cast<uint8_t*>(p);
+            madvise(_base, _size, _advice(config.access));
+        }
+        ::close(fd);   // the mapping keeps the file referenced
+        _open = true;
+        return true;
+    }
+
+    const std::string& error() const noexcept { return _error; }
+    size_t             size() const noexcept  { return _size; }
+
+    // Starts a new configuration: replaces config and unmaps a file left
+    // mapped by an earlier open(), so the next open() maps the new path.
+    // Refused (false) while the service runs, as Dart may hold views.
+    bool configure(MappedFileConfig c) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_thread.joinable()) return false;
+        _unmap();
+        config = std::move(c);
+        return true;
+    }
+
+    // Pointer to [offset, offset + len) of the file, or nullptr if the range
+    // is not inside it.  Valid until stop().  An empty file has no mapping:
+    // its only range, (0, 0), gets a non-null pointer to nothing.
+    const uint8_t* view(uint64_t offset, uint64_t len) const noexcept {
+        static const uint8_t nothing = 0;
+        if (!_open || offset > _size || len > _size - offset) return nullptr;
+        return _base ? _base + offset : &nothing;
+    }
+
+    // madvise() hint for a region; len 0 = to the end of the file.
+    bool advise(uint64_t offset, uint64_t len, MappedFileAccess access) noexcept {
+        uint8_t* start;
+        size_t   bytes;
+        if (!_page_range(offset, len, start, bytes)) return false;
+        return madvise(start, bytes, _advice(access)) == 0;
+    }
+
+    // Asks the prefetch thread to start reading a region.  Never blocks.
+    void prefetch(uint64_t offset, uint64_t len) {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            if (_pending.size() == kMaxPending) _pending.pop_front();
+            _pending.push_back({offset, len});
+        }
+        _cv.notify_one();
+    }
+
+    // Regions handed to madvise(MADV_WILLNEED) so far.
+    uint64_t prefetched() const noexcept { return _prefetched.load(std::memory_order_relaxed); }
+
+    // Whether start() ran and stop() did not.
+    bool running() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _thread.joinable();
+    }
+
+    // Starts the prefetch thread.
+    void start() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_thread.joinable()) return;
+        _quit = false;
+        _thread = std::thread([this] { _run(); });
+    }
+
+    // Joins the prefetch thread and unmaps the file.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _quit = true;
+            _pending.clear();
+        }
+        _cv.notify_all();
+        if (_thread.joinable()) _thread.join();
+        std::lock_guard<std::mutex> lk(_mtx);
+        _unmap();
+    }
+
+private:
+    struct Region {
+        uint64_t offset;
+        uint64_t len;
+    };
+
+    static int _advice(MappedFileAccess a) noexcept {
+        switch (a) {
+        case MappedFileAccess::Sequential: return MADV_SEQUENTIAL;
+        case MappedFileAccess::Random:     return MADV_RANDOM;
+        default:                           return MADV_NORMAL;
+        }
+    }
+
+    // Widens a region to whole pages, as madvise() requires.
+    bool _page_range(uint64_t offset, uint64_t len, uint8_t*& start, size_t& bytes) const {
+        if (!_base || offset >= _size) return false;
+        if (len == 0 || len > _size - offset) len = _size - offset;
+        static const uint64_t page = uint64_t(sysconf(_SC_PAGESIZE));
+        const uint64_t first = offset & ~(page - 1);
+        start = _base + first;
+        bytes = size_t(offset + len - first);
+        return true;
+    }
+
+    void _run() {
+        for (;;) {
+            Region r;
+            {
+                std::unique_lock<std::mutex> lk(_mtx);
+                _cv.wait(lk, [this] { return _quit || !_pending.empty(); });
+                if (_quit) return;
+                r = _pending.back();   // the newest request matters most
+                _pending.pop_back();
+            }
+            uint8_t* start;
+            size_t   bytes;
+            if (_page_range(r.offset, r.len, start, bytes) &&
+                madvise(start, bytes, MADV_WILLNEED) == 0)
+                _prefetched.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool _fail(const std::string& what) {
+        _error = what + ": " + std::strerror(errno);
+        return false;
+    }
+
+    void _unmap() noexcept {   // under _mtx
+        if (_base) munmap(_base, _size);
+        _base = nullptr;
+        _size = 0;
+        _open = false;
+    }
+
+    std::mutex              _mtx;
+    std::condition_variable _cv;
+    std::deque<Region>      _pending;
+    bool                    _quit = false;
+    std::thread             _thread;
+    bool                    _open = false;
+    uint8_t*                _base = nullptr;   // null for an empty file
+    size_t                  _size = 0;
+    std::string             _error;
+    std::atomic<uint64_t>   _prefetched{0};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_MAPPED_FILE_SYMBOLS ───────────────────────────────────────────
+// Standalone-service symbols (start_service / stop_service run the prefetch
+// thread; stop_service unmaps the file) plus the mapping API:
+//
+//   service_running()                →  bool            prefetch thread up
+//   mapped_file_configure(path, populate, access)  →  bool  false while
+//                                    running; unmaps a file left mapped
+//   mapped_file_open()               →  const char*     nullptr, or the error
+//   mapped_file_size()               →  uint64_t
+//   mapped_file_view(offset, len)    →  const uint8_t*  nullptr if out of range
+//   mapped_file_advise(offset, len, access)  →  bool    len 0 = to the end
+//   mapped_file_prefetch(offset, len)        →  void    background WILLNEED
+//   mapped_file_prefetched()         →  uint64_t
+//
+// `access` is an fcb::MappedFileAccess (0 normal, 1 sequential, 2 random).
+//
+#define FCB_EXPORT_MAPPED_FILE_SYMBOLS(file)                                        \
+    FCB_EXPORT_STANDALONE((file).start, (file).stop)                                \
+    FCB_EXPORT bool service_running() { return (file).running(); }                  \
+    FCB_EXPORT bool mapped_file_configure(const char* path, bool populate,          \
+                                          uint32_t access) {                        \
+        fcb::MappedFileConfig fcb_cfg;                                              \
+        fcb_cfg.path     = path;                                                    \
+        fcb_cfg.populate = populate;                                                \
+        fcb_cfg.access   = static_cast<fcb::MappedFileAccess>(access);              \
+        return (file).configure(std::move(fcb_cfg));                                \
+    }                                                                               \
+    FCB_EXPORT const char* mapped_file_open() {                                     \
+        return (file).open() ? nullptr : (file).error().c_str();                    \
+    }                                                                               \
+    FCB_EXPORT uint64_t mapped_file_size() { return (file).size(); }                \
+    FCB_EXPORT const uint8_t* mapped_file_view(uint64_t offset, uint64_t len) {     \
+        return (file).view(offset, len);                                            \
+    }                                                                               \
+    FCB_EXPORT bool mapped_file_advise(uint64_t offset, uint64_t len, uint32_t access) { \
+        return (file).advise(offset, len, static_cast<fcb::MappedFileAccess>(access)); \
+    }                                                                               \
+    FCB_EXPORT void mapped_file_prefetch(uint64_t offset, uint64_t len) {           \
+        (file).prefetch(offset, len);                                               \
+    }                                                                               \
+    FCB_EXPORT uint64_t mapped_file_prefetched() { return (file).prefetched(); }
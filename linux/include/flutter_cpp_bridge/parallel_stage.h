@@ -0,0 +1,204 @@
+// flutter_cpp_bridge/parallel_stage.h
+//
+// Parallel transform stage for services whose per-message work (parsing,
+// decompression, FFT, …) would otherwise cap throughput at the single worker
+// thread.
+//
+// The service worker submit()s raw input; a pool of threads with one deque
+// each (idle threads steal from the back of their peers' deques) runs the
+// transform; results are put back in submission order by sequence number
+// before being pushed, so get_next_message() still yields FIFO order.
+//
+// A bounded reorder window (default 1024 in-flight items) applies
+// backpressure: submit() blocks while the oldest unfinished item holds the
+// window open, which also bounds memory when the transform is slower than
+// ingest.
+//
+// Requirements: C++17 or later.
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/parallel_stage.h"
+//
+//   static fcb::BytesQueue g_svc;
+//
+//   static std::optional<fcb::BytesMsg> decode(fcb::BytesMsg& raw) {
+//       if (raw.empty()) return std::nullopt;   // dropped, order preserved
+//       return inflate(raw);
+//   }
+//
+//   static void worker(fcb::BytesQueue& svc) {
+//       fcb::ParallelStage<fcb::BytesMsg, fcb::BytesMsg> stage(svc, 8, decode);
+//       while (!svc.stopped()) stage.submit(receive_compressed());
+//       stage.drain();
+//   }
+//
+//   FCB_EXPORT_BYTES_SYMBOLS(g_svc, worker)
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace fcb {
+
+template<typename In, typename Out>
+class ParallelStage {
+public:
+    using Transform = std::function<std::optional<Out>(In&)>;
+    using Emit      = std::function<void(Out&&)>;
+
+    // Results are handed to `emit` in submission order, one at a time, from
+    // a pool thread and without any stage lock held.
+    ParallelStage(unsigned threads, Transform fn, Emit emit, size_t window = 1024)
+        : _fn(std::move(fn)), _emit(std::move(emit)),
+          _slots(std::max<size_t>(window, 1)), _ready(_slots.size(), 0) {
+        threads = std::max(threads, 1u);
+        for (unsigned i = 0; i < threads; ++i)
+            _workers.emplace_back(new Worker);
+        for (unsigned i = 0; i < threads; ++i)
+            _threads.emplace_back([this, i] { _loop(i); });
+    }
+
+    // Convenience: results are pushed into `sink`.
+    ParallelStage(Queue<Out>& sink, unsigned threads, Transform fn, size_t window = 1024)
+        : ParallelStage(threads, std::move(fn),
+                        [&sink](Out&& out) { sink.push(std::move(out)); }, window) {}
+
+    ~ParallelStage() {
+        drain();
+        { std::lock_guard<std::mutex> lk(_idle_mtx); _quit = true; }
+        _idle_cv.notify_all();
+        for (auto& t : _threads) t.join();
+    }
+
+    ParallelStage(const ParallelStage&) = delete;
+    ParallelStage& operator=(const ParallelStage&) = delete;
+
+    // Hands one input to the pool.  Blocks while the reorder window is full.
+    // Must be called from a single producer thread.
+    void submit(In in) {
+        uint64_t seq;
+        {
+            std::unique_lock<std::mutex> lk(_order_mtx);
+            _space_cv.wait(lk, [this] { return _submitted - _emitted < _slots.size(); });
+            seq = _submitted++;
+        }
+        Worker& w = *_workers[seq % _workers.size()];
+        { std::lock_guard<std::mutex> lk(w.mtx); w.tasks.push_back({seq, std::move(in)}); }
+        { std::lock_guard<std::mutex> lk(_idle_mtx); ++_queued; }
+        _idle_cv.notify_one();
+    }
+
+    // Blocks until every submitted input has been emitted (or dropped).
+    void drain() {
+        std::unique_lock<std::mutex> lk(_order_mtx);
+        _space_cv.wait(lk, [this] { return _emitted == _submitted; });
+    }
+
+    unsigned threads() const noexcept { return unsigned(_threads.size()); }
+
+private:
+    struct Task {
+        uint64_t seq;
+        In       in;
+    };
+    struct Worker {
+        std::mutex       mtx;
+        std::deque<Task> tasks;
+    };
+
+    // Own deque from the front (oldest first keeps latency low), peers' from
+    // the back (newest, least likely to be next in the reorder window).
+    std::optional<Task> _take(unsigned self) {
+        const size_t n = _workers.size();
+        for (size_t k = 0; k < n; ++k) {
+            Worker& w = *_workers[(self + k) % n];
+            std::lock_guard<std::mutex> lk(w.mtx);
+            if (w.tasks.empty()) continue;
+            std::optional<Task> out;
+            if (k == 0) { out.emplace(std::move(w.tasks.front())); w.tasks.pop_front(); }
+            else        { out.emplace(std::move(w.tasks.back()));  w.tasks.pop_back();  }
+            return out;
+        }
+        return std::nullopt;
+    }
+
+    void _loop(unsigned self) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(_idle_mtx);
+                _idle_cv.wait(lk, [this] { return _queued > 0 || _quit; });
+                if (_queued == 0) return;   // _quit and nothing left
+                --_queued;
+            }
+            // A queued task is reserved for us; it is in some deque.
+            std::optional<Task> task;
+            while (!(task = _take(self))) std::this_thread::yield();
+            std::optional<Out> result;
+            try {
+                result = _fn(task->in);
+            } catch (...) {
+                // A throwing transform drops its item; order is preserved.
+            }
+            _complete(task->seq, std::move(result));
+        }
+    }
+
+    // Stores a result, then emits the ready run at the head of the window.
+    // One completing thread emits at a time (in order) and does so outside
+    // _order_mtx, so a slow emit does not stall the other pool threads.
+    void _complete(uint64_t seq, std::optional<Out> result) {
+        std::unique_lock<std::mutex> lk(_order_mtx);
+        size_t slot = seq % _slots.size();
+        _slots[slot] = std::move(result);
+        _ready[slot] = 1;
+        if (_emitting) return;   // picked up by the thread emitting now
+        _emitting = true;
+        std::vector<Out> run;
+        for (;;) {
+            // Slots [_emitted, _emitted + taken) stay reserved until emitted:
+            // submit() cannot reuse them before _emitted moves past.
+            uint64_t taken = 0;
+            for (;;) {
+                size_t head = (_emitted + taken) % _slots.size();
+                if (!_ready[head]) break;
+                _ready[head] = 0;
+                if (_slots[head]) run.push_back(std::move(*_slots[head]));
+                _slots[head].reset();
+                ++taken;
+            }
+            if (taken == 0) break;
+            lk.unlock();
+            for (Out& out : run) _emit(std::move(out));
+            run.clear();
+            lk.lock();
+            _emitted += taken;
+            _space_cv.notify_all();
+        }
+        _emitting = false;
+    }
+
+    Transform                            _fn;
+    Emit                                 _emit;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread>             _threads;
+
+    std::mutex              _idle_mtx;
+    std::condition_variable _idle_cv;
+    size_t                  _queued = 0;
+    bool                    _quit   = false;
+
+    std::mutex                      _order_mtx;
+    std::condition_variable         _space_cv;
+    std::vector<std::optional<Out>> _slots;
+    std::vector<uint8_t>            _ready;
+    uint64_t                        _submitted = 0;
+    uint64_t                        _emitted   = 0;
+    bool                            _emitting  = false;
+};
+
+} // namespace fcb
@@ -0,0 +1,53 @@
+// flutter_cpp_bridge/process_shared.h
+//
+// Objects shared by every service library of the process, although Dart
+// loads each of them with RTLD_LOCAL: fcb::bus() (bus.h), fcb::registry()
+// (service_registry.h) and fcb::watchdog() (watchdog.h).  Each library
+// exports a candidate instance and all of them adopt the one of the
+// earliest loaded library.  service_helpers.h alone does not include this
+// header, so plain services neither export candidates nor need libdl.
+//
+// Requirements: libdl (link with ${CMAKE_DL_LIBS} on glibc older than
+// 2.34).
+//
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+#include <link.h>
+
+namespace fcb {
+
+
+// The object returned by `symbol` in the earliest loaded library exporting
+// it, or local() if none does.  Libraries loaded with RTLD_LOCAL cannot see
+// each other's symbols, so every loaded object is searched in load order;
+// the library found stays pinned.
+inline void* process_instance(const char* symbol, void* (*local)()) {
+    std::vector<std::string> objects;
+    dl_iterate_phdr([](dl_phdr_info* info, size_t, void* out) {
+        static_cast<std::vector<std::string>*>(out)->emplace_back(
+            info->dlpi_name ? info->dlpi_name : "");
+        return 0;
+    }, &objects);
+    for (const std::string& name : objects) {
+        void* h = dlopen(name.empty() ? nullptr : name.c_str(), RTLD_LAZY | RTLD_NOLOAD);
+        if (!h) continue;
+        if (auto fn = reinterpret_cast<void* (*)()>(dlsym(h, symbol))) return fn();
+        dlclose(h);
+    }
+    return local();
+}
+
+} // namespace fcb
+
+// Symbol name of a candidate instance that reads ServiceBase objects:
+// FCB_LAYOUT_SYMBOL(fcb_watchdog_v1) is fcb_watchdog_v1_sl1 for
+// FCB_SERVICE_LAYOUT 1, and FCB_SYMBOL_NAME turns it into a string.
+#define FCB_LAYOUT_SYMBOL(name)              FCB_LAYOUT_SYMBOL_(name, FCB_SERVICE_LAYOUT)
+#define FCB_LAYOUT_SYMBOL_(name, layout)     FCB_LAYOUT_SYMBOL_AT_(name, layout)
+#define FCB_LAYOUT_SYMBOL_AT_(name, layout)  name##_sl##layout
+#define FCB_SYMBOL_NAME(symbol)              FCB_SYMBOL_NAME_(symbol)
+#define FCB_SYMBOL_NAME_(symbol)             #symbol
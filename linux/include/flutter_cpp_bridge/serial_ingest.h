@@ -0,0 +1,520 @@
+// flutter_cpp_bridge/serial_ingest.h
+//
+// Serial / TTY ingest service for sensors on RS-232 / RS-485 lines, replacing
+// worker loops that block in read() once per byte.
+//
+//   • the port is configured from Dart: speed, data bits, parity, stop bits,
+//     RTS/CTS, optional kernel RS-485 mode (TIOCSRS485);
+//   • reads are bulk: epoll wakes the ingest thread, and VMIN / VTIME let one
+//     read() collect a whole burst (up to VMIN bytes, or until the line has
+//     been quiet for VTIME tenths of a second);
+//   • frames are cut natively by a pluggable framer — delimiter,
+//     length-prefix, COBS, raw, or your own — and every frame completed by
+//     one read is queued in a single message: a packed SerialBatch;
+//   • a device that disappears (USB adapter unplugged) is reopened.
+//
+// SerialBatch layout (one BytesMsg):
+//
+//   SerialBatchHeader
+//   bytes                           frame payloads, back to back
+//   padding to 4 bytes
+//   uint32_t starts[count + 1]      at offsets_at; frame i is
+//                                   bytes[starts[i], starts[i + 1])
+//
+// Requirements: C++17, Linux (termios, epoll).
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/serial_ingest.h"
+//
+//   static fcb::SerialIngest g_svc;
+//
+//   FCB_EXPORT_SERIAL_INGEST_SYMBOLS(g_svc)
+//
+// On the Dart side, use SerialIngestService (serial_ingest_service.dart).
+// A custom framer is set from C++ before start_service():
+//
+//   g_svc.framer = [](const uint8_t* p, size_t n, fcb::SerialFrames& out) {
+//       ...   // out.add(frame, len) per frame; return bytes consumed
+//   };
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/serial.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace fcb {
+
+struct SerialBatchHeader {
+    uint32_t count;          // frames in the batch
+    uint32_t offsets_at;     // from the start of the message
+    int64_t  timestamp_ns;   // CLOCK_REALTIME when the last frame completed
+};
+static_assert(sizeof(SerialBatchHeader) == 16, "SerialBatchHeader layout is shared with Dart");
+
+// Collects the frames of one batch, in place in the message being built.
+class SerialFrames {
+public:
+    SerialFrames() { _reset(); }
+
+    // Appends a complete frame.
+    void add(const uint8_t* p, size_t n) { std::memcpy(begin(n), p, n); commit(n); }
+
+    // Room for a frame of up to max bytes, written in place (decoders);
+    // finish it with commit() or cancel().
+    uint8_t* begin(size_t max) {
+        _open = _msg.size();
+        _msg.resize(_open + max);
+        return _msg.data() + _open;
+    }
+    void commit(size_t n) {
+        _msg.resize(_open + n);
+        _starts.push_back(uint32_t(_msg.size() - sizeof(SerialBatchHeader)));
+    }
+    void cancel() { _msg.resize(_open); }
+
+    // Records a frame the framer had to throw away (oversized, corrupt).
+    void drop() noexcept { ++_dropped; }
+
+    size_t count() const noexcept { return _starts.size() - 1; }
+
+    // The packed batch; starts a new one.
+    BytesMsg take(int64_t timestamp_ns) {
+        SerialBatchHeader h;
+        h.count        = uint32_t(count());
+        h.offsets_at   = uint32_t((_msg.size() + 3) & ~size_t(3));
+        h.timestamp_ns = timestamp_ns;
+        _msg.resize(h.offsets_at + _starts.size() * sizeof(uint32_t));
+        std::memcpy(_msg.data(), &h, sizeof h);
+        std::memcpy(_msg.data() + h.offsets_at, _starts.data(),
+                    _starts.size() * sizeof(uint32_t));
+        BytesMsg out = std::move(_msg);
+        _reset();
+        return out;
+    }
+
+    // Frames dropped since the last call.
+    uint64_t take_dropped() noexcept { return std::exchange(_dropped, 0); }
+
+private:
+    void _reset() {
+        _msg.assign(sizeof(SerialBatchHeader), 0);
+        _starts.assign(1, 0);
+    }
+
+    BytesMsg              _msg;
+    std::vector<uint32_t> _starts;
+    size_t                _open    = 0;
+    uint64_t              _dropped = 0;
+};
+
+// Cuts frames from p[0, n) into out and returns the number of bytes
+// consumed; the rest is offered again with the next read appended.  Runs on
+// the ingest thread only, so it may keep state.
+using SerialFramer = std::function<size_t(const uint8_t* p, size_t n, SerialFrames& out)>;
+
+// Frames end with `delim`, which is not part of the frame.  Empty frames
+// are skipped; a frame longer than max_frame is dropped up to the next
+// delimiter.
+inline SerialFramer serial_delimiter_framer(uint8_t delim, size_t max_frame) {
+    return [delim, max_frame, discarding = false](const uint8_t* p, size_t n,
+                                                  SerialFrames& out) mutable {
+        size_t start = 0;
+        while (start < n) {
+            auto* hit = static_cast<const uint8_t*>(std::memchr(p + start, delim, n - start));
+            if (!hit) break;
+            const size_t len = size_t(hit - p) - start;
+            if (discarding || len > max_frame) out.drop();
+            else if (len > 0) out.add(p + start, len);
+            discarding = false;
+            start += len + 1;
+        }
+        if (n - start > max_frame) {   // no delimiter in sight
+            discarding = true;
+            return n;
+        }
+        return discarding ? n : start;
+    };
+}
+
+// Frames are a `bytes`-byte length (1, 2 or 4; little-endian unless
+// big_endian) followed by that many bytes.  A length above max_frame is
+// taken as line noise: one byte is skipped to resynchronise.
+inline SerialFramer serial_length_prefix_framer(uint32_t bytes, bool big_endian,
+                                                size_t max_frame) {
+    if (bytes != 1 && bytes != 2 && bytes != 4) bytes = 2;
+    return [bytes, big_endian, max_frame](const uint8_t* p, size_t n, SerialFrames& out) {
+        size_t at = 0;
+        while (n - at >= bytes) {
+            size_t len = 0;
+            for (uint32_t k = 0; k < bytes; ++k)
+                len |= size_t(p[at + (big_endian ? k : bytes - 1 - k)]) << (8 * (bytes - 1 - k));
+            if (len > max_frame) { out.drop(); ++at; continue; }
+            if (n - at - bytes < len) break;
+            if (len > 0) out.add(p + at + bytes, len);
+            at += bytes + len;
+        }
+        return at;
+    };
+}
+
+// COBS-encoded frames, each terminated by 0x00 (the payload may contain
+// zeros).  Corrupt or oversized frames are dropped.
+inline SerialFramer serial_cobs_framer(size_t max_frame) {
+    const size_t max_encoded = max_frame + max_frame / 254 + 1;
+    return [max_frame, max_encoded, discarding = false](const uint8_t* p, size_t n,
+                                                        SerialFrames& out) mutable {
+        size_t start = 0;
+        while (start < n) {
+            auto* hit = static_cast<const uint8_t*>(std::memchr(p + start, 0, n - start));
+            if (!hit) break;
+            const size_t len = size_t(hit - p) - start;
+            if (discarding || len > max_encoded) {
+                out.drop();
+            } else if (len > 0) {
+                const uint8_t* src = p + start;
+                uint8_t* dst = out.begin(len);
+                size_t used = 0, i = 0;
+                bool ok = true;
+                while (i < len) {
+                    const size_t code = src[i++];
+                    if (i + code - 1 > len) { ok = false; break; }
+                    std::memcpy(dst + used, src + i, code - 1);
+                    used += code - 1;
+                    i += code - 1;
+                    if (code != 0xFF && i < len) dst[used++] = 0;
+                }
+                if (ok && used <= max_frame && used > 0) out.commit(used);
+                else { out.cancel(); out.drop(); }
+            }
+            discarding = false;
+            start += len + 1;
+        }
+        if (n - start > max_encoded) {
+            discarding = true;
+            return n;
+        }
+        return discarding ? n : start;
+    };
+}
+
+// Every read() is one frame: for devices that already packetise, or when
+// Dart does the framing.
+inline SerialFramer serial_raw_framer() {
+    return [](const uint8_t* p, size_t n, SerialFrames& out) {
+        if (n > 0) out.add(p, n);
+        return n;
+    };
+}
+
+// Built-in framers, in the order of the Dart SerialFraming enum.
+enum class SerialFraming : uint8_t { Delimiter, LengthPrefix, Cobs, Raw };
+
+enum class SerialParity : uint8_t { None, Even, Odd };
+
+struct SerialIngestConfig {
+    std::string   path;                 // e.g. /dev/ttyUSB0
+    uint32_t      baud        = 115200;
+    uint8_t       data_bits   = 8;      // 5 … 8
+    SerialParity  parity      = SerialParity::None;
+    uint8_t       stop_bits   = 1;      // 1 or 2
+    bool          rtscts      = false;  // hardware flow control
+    bool          rs485       = false;  // kernel RS-485 mode (driver support)
+
+    uint8_t       vmin        = 255;    // bytes one read() waits for …
+    uint8_t       vtime       = 1;      // … or tenths of a second of silence
+    uint32_t      read_size   = 4096;   // bytes per read()
+
+    SerialFraming framing      = SerialFraming::Delimiter;
+    uint8_t       delimiter    = '\n';
+    uint32_t      length_bytes = 2;     // LengthPrefix: 1, 2 or 4
+    bool          big_endian   = false; // LengthPrefix
+    uint32_t      max_frame    = 4096;
+};
+
+// ── SerialIngest ─────────────────────────────────────────────────────────────
+struct SerialIngest : BytesQueue {
+    // Edited from Dart (serial_ingest_* symbols) before start_service().
+    SerialIngestConfig config;
+
+    // Optional; replaces the framer chosen by config.framing.  Set it before
+    // start_service().
+    SerialFramer framer;
+
+    ~SerialIngest() { close(); }
+
+    // Opens and configures the port.  Called from Dart before starting so
+    // that a bad path or setting is reported synchronously; the ingest
+    // thread calls it too if the port is not open yet.  Returns false and
+    // sets error() on failure.
+    bool open() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_fd >= 0) return true;
+        _error.clear();
+        speed_t speed;
+        if (!_speed(config.baud, speed)) {
+            _error = "unsupported baud rate " + std::to_string(config.baud);
+            return false;
+        }
+        // O_NONBLOCK so that open() does not wait for carrier; cleared below
+        // because VMIN / VTIME only apply to blocking reads.
+        _fd = ::open(config.path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (_fd < 0) return _fail("open " + config.path);
+        termios tio;
+        if (tcgetattr(_fd, &tio) != 0) return _fail("tcgetattr " + config.path);
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+        switch (config.data_bits) {
+        case 5:  tio.c_cflag |= CS5; break;
+        case 6:  tio.c_cflag |= CS6; break;
+        case 7:  tio.c_cflag |= CS7; break;
+        default: tio.c_cflag |= CS8; break;
+        }
+        if (config.parity != SerialParity::None) tio.c_cflag |= PARENB;
+        if (config.parity == SerialParity::Odd)  tio.c_cflag |= PARODD;
+        if (config.stop_bits == 2) tio.c_cflag |= CSTOPB;
+        if (config.rtscts)         tio.c_cflag |= CRTSCTS;
+        // VTIME 0 would let a read wait forever for VMIN bytes (and block
+        // stop_service()); a burst always ends after a tenth of silence.
+        tio.c_cc[VMIN]  = config.vmin;
+        tio.c_cc[VTIME] = config.vmin > 1 ? std::max<uint8_t>(config.vtime, 1) : config.vtime;
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        if (tcsetattr(_fd, TCSANOW, &tio) != 0) return _fail("tcsetattr " + config.path);
+        if (config.rs485) {
+            serial_rs485 rs{};
+            rs.flags = SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND;
+            if (ioctl(_fd, TIOCSRS485, &rs) != 0) return _fail("TIOCSRS485 " + config.path);
+        }
+        tcflush(_fd, TCIFLUSH);
+        if (fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_NONBLOCK) != 0)
+            return _fail("fcntl " + config.path);
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    // Empty when the last open() succeeded.
+    std::string error() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _error;
+    }
+
+    // Starts a new configuration: replaces config and closes a port left
+    // open by an earlier open().  Refused (false) while the service runs;
+    // waits for a stopping ingest thread to close the port first.
+    bool configure(SerialIngestConfig c) {
+        if (running()) return false;
+        while (_in_run.load(std::memory_order_acquire))
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        close();
+        config = std::move(c);
+        return true;
+    }
+
+    // Frames thrown away by the framer (oversized, corrupt) so far.
+    uint64_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+    // Bytes read from the port so far.
+    uint64_t bytes_read() const noexcept { return _bytes.load(std::memory_order_relaxed); }
+
+    // Body of the ingest thread started by FCB_EXPORT_SERIAL_INGEST_SYMBOLS.
+    // A missing port is retried; a failing poll ends the run, and the
+    // service no longer counts as running.
+    static void run(SerialIngest& svc) {
+        svc._in_run.store(true, std::memory_order_release);
+        svc._ingest();
+        svc.close();
+        if (!svc.stopped()) svc.mark_finished();
+        svc._in_run.store(false, std::memory_order_release);
+    }
+
+private:
+    void _ingest() {
+        SerialFramer frame = framer ? framer : _builtin();
+        const size_t read_size = std::max<uint32_t>(config.read_size, 64);
+        // A pending partial frame plus one read always fits.
+        std::vector<uint8_t> buf(read_size + 2 * size_t(config.max_frame) + 16);
+        size_t have = 0;
+        SerialFrames frames;
+        int ep = epoll_create1(EPOLL_CLOEXEC);
+        if (ep < 0) return;
+        int watched = -1;
+
+        while (!stopped()) {
+            if (watched < 0) {
+                if (!open()) {   // not plugged in (yet): retry
+                    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                    continue;
+                }
+                watched = _fd;
+                epoll_event ev{};
+                ev.events = EPOLLIN;
+                epoll_ctl(ep, EPOLL_CTL_ADD, watched, &ev);
+                have = 0;
+            }
+            epoll_event ev;
+            int rc = epoll_wait(ep, &ev, 1, 100);
+            heartbeat();   // alive while the line is quiet (Watchdog)
+            if (rc < 0 && errno != EINTR) break;
+            if (rc <= 0) continue;
+            ssize_t got = 0;
+            if (!(ev.events & (EPOLLHUP | EPOLLERR)) || (ev.events & EPOLLIN))
+                got = read(watched, buf.data() + have, std::min(read_size, buf.size() - have));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {   // hang-up or device gone: reopen
+                epoll_ctl(ep, EPOLL_CTL_DEL, watched, nullptr);
+                close();
+                watched = -1;
+                continue;
+            }
+            // Drivers hand over a burst in pieces (a pty in 64-byte ones):
+            // read what is already buffered before queueing the batch.
+            size_t batch_bytes = 0;
+            for (;;) {
+                _bytes.fetch_add(uint64_t(got), std::memory_order_relaxed);
+                batch_bytes += size_t(got);
+                const size_t n = have + size_t(got);
+                size_t used = std::min(frame(buf.data(), n, frames), n);
+                if (used == 0 && n == buf.size()) {   // custom framer made no progress
+                    frames.drop();
+                    used = n;
+                }
+                have = n - used;
+                std::memmove(buf.data(), buf.data() + used, have);
+                int avail = 0;
+                if (batch_bytes >= 16 * read_size || ioctl(watched, FIONREAD, &avail) != 0 ||
+                    avail <= 0)
+                    break;
+                // No more than is buffered, so VMIN cannot make this wait.
+                got = read(watched, buf.data() + have,
+                           std::min({size_t(avail), read_size, buf.size() - have}));
+                if (got <= 0) break;
+            }
+            _dropped.fetch_add(frames.take_dropped(), std::memory_order_relaxed);
+            if (frames.count() > 0) {
+                timespec now;
+                clock_gettime(CLOCK_REALTIME, &now);
+                push(frames.take(int64_t(now.tv_sec) * 1000000000 + now.tv_nsec));
+            }
+        }
+        ::close(ep);
+    }
+
+    SerialFramer _builtin() const {
+        switch (config.framing) {
+        case SerialFraming::LengthPrefix:
+            return serial_length_prefix_framer(config.length_bytes, config.big_endian,
+                                               config.max_frame);
+        case SerialFraming::Cobs: return serial_cobs_framer(config.max_frame);
+        case SerialFraming::Raw:  return serial_raw_framer();
+        default:                  return serial_delimiter_framer(config.delimiter, config.max_frame);
+        }
+    }
+
+    static bool _speed(uint32_t baud, speed_t& out) {
+        static const struct { uint32_t baud; speed_t speed; } table[] = {
+            {1200, B1200},       {2400, B2400},       {4800, B4800},
+            {9600, B9600},       {19200, B19200},     {38400, B38400},
+            {57600, B57600},     {115200, B115200},   {230400, B230400},
+            {460800, B460800},   {500000, B500000},   {576000, B576000},
+            {921600, B921600},   {1000000, B1000000}, {1152000, B1152000},
+            {1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000},
+            {3000000, B3000000}, {3500000, B3500000}, {4000000, B4000000},
+        };
+        for (const auto& e : table)
+            if (e.baud == baud) { out = e.speed; return true; }
+        return false;
+    }
+
+    bool _fail(const std::string& what) {
+        _error = what + ": " + std::strerror(errno);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    std::mutex            _mtx;
+    int                   _fd = -1;
+    std::string           _error;
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _bytes{0};
+    std::atomic<bool>     _in_run{false};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_SERIAL_INGEST_SYMBOLS ─────────────────────────────────────────
+// FCB_EXPORT_BYTES_SYMBOLS for an fcb::SerialIngest (messages are packed
+// SerialBatch buffers; its ingest thread is the worker) plus the
+// configuration API:
+//
+//   serial_ingest_configure(path, baud, data_bits, parity, stop_bits,
+//                           rtscts, rs485)                     →  bool  false
+//                              while running; resets timing and framing too
+//   serial_ingest_timing(vmin, vtime, read_size)               →  void
+//   serial_ingest_framing(framing, delimiter, length_bytes, big_endian,
+//                         max_frame)                           →  void
+//   serial_ingest_open()        →  const char*  nullptr, or the error text
+//   serial_ingest_dropped()     →  uint64_t     frames dropped by the framer
+//   serial_ingest_bytes_read()  →  uint64_t
+//
+// `parity` is an fcb::SerialParity (0 none, 1 even, 2 odd); `framing` an
+// fcb::SerialFraming (0 delimiter, 1 length prefix, 2 COBS, 3 raw).
+//
+#define FCB_EXPORT_SERIAL_INGEST_SYMBOLS(svc)                                       \
+    FCB_EXPORT_BYTES_SYMBOLS(svc, fcb::SerialIngest::run)                           \
+    FCB_EXPORT bool serial_ingest_configure(const char* path, uint32_t baud,        \
+                                            uint8_t data_bits, uint8_t parity,      \
+                                            uint8_t stop_bits, bool rtscts,         \
+                                            bool rs485) {                           \
+        fcb::SerialIngestConfig fcb_cfg;                                            \
+        fcb_cfg.path      = path;                                                   \
+        fcb_cfg.baud      = baud;                                                   \
+        fcb_cfg.data_bits = data_bits;                                              \
+        fcb_cfg.parity    = static_cast<fcb::SerialParity>(parity);                 \
+        fcb_cfg.stop_bits = stop_bits;                                              \
+        fcb_cfg.rtscts    = rtscts;                                                 \
+        fcb_cfg.rs485     = rs485;                                                  \
+        return (svc).configure(std::move(fcb_cfg));                                 \
+    }                                                                               \
+    FCB_EXPORT void serial_ingest_timing(uint8_t vmin, uint8_t vtime,               \
+                                         uint32_t read_size) {                      \
+        (svc).config.vmin      = vmin;                                              \
+        (svc).config.vtime     = vtime;                                             \
+        (svc).config.read_size = read_size;                                         \
+    }                                                                               \
+    FCB_EXPORT void serial_ingest_framing(uint8_t framing, uint8_t delimiter,       \
+                                          uint32_t length_bytes, bool big_endian,   \
+                                          uint32_t max_frame) {                     \
+        (svc).config.framing      = static_cast<fcb::SerialFraming>(framing);       \
+        (svc).config.delimiter    = delimiter;                                      \
+        (svc).config.length_bytes = length_bytes;                                   \
+        (svc).config.big_endian   = big_endian;                                     \
+        (svc).config.max_frame    = max_frame;                                      \
+    }                                                                               \
+    FCB_EXPORT const char* serial_ingest_open() {                                   \
+        static thread_local std::string error;                                      \
+        if ((svc).open()) return nullptr;                                           \
+        error = (svc).error();                                                      \
+        return error.c_str();                                                       \
+    }                                                                               \
+    FCB_EXPORT uint64_t serial_ingest_dropped()    { return (svc).dropped();    }   \
+    FCB_EXPORT uint64_t serial_ingest_bytes_read() { return (svc).bytes_read(); }
@@ -18,7 +18,7 @@
 //
 //   static void worker(fcb::Queue<my_msg_t>& svc) {
 //       int i = 0;
-//       while (!svc.stopped()) {
+//       while (svc.wait_for_consumer()) {     // sleeps while Dart has no job
 //           svc.push({i++});
 //           std::this_thread::sleep_for(std::chrono::seconds(1));
 //       }
@@ -61,19 +61,113 @@
 //
 
 #pragma once
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <deque>
+#include <functional>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <time.h>
+
 // Visibility macro reused for all exported symbols (mandatory and extra).
 #define FCB_EXPORT extern "C" __attribute__((visibility("default")))
 
 namespace fcb {
 
+// ── MemoryBudget ─────────────────────────────────────────────────────────────
+// Byte budget shared by the queues of every service attached to it.  Each
+// service is a separate shared library with its own copy of this header, so
+// the counters cannot live in a static: Dart allocates one MemoryBudget in
+// native memory (MemoryBudget in memory_budget.dart, which mirrors this
+// layout) and hands its address to each service with set_memory_budget().
+//
+// A queue whose push() finds `used` above `limit` while it holds more than
+// its weighted share (limit * weight / total_weight) applies its
+// MemoryPolicy to its own pending messages.
+struct MemoryBudget {
+    std::atomic<int64_t>  used{0};          // bytes held by all attached queues
+    std::atomic<int64_t>  limit{0};         // written by Dart; 0 = unlimited
+    std::atomic<uint32_t> total_weight{0};  // sum of the attached weights
+    std::atomic<uint64_t> evicted{0};       // messages evicted by any queue
+};
+static_assert(sizeof(MemoryBudget) == 32 && std::atomic<int64_t>::is_always_lock_free,
+              "fcb::MemoryBudget is shared with Dart as a plain struct");
+
+// What a queue does with its pending messages (those not yet handed to Dart)
+// when it is over its share of the MemoryBudget.  The newest message is
+// always kept.
+enum class MemoryPolicy : uint8_t {
+    DropOldest,   // evict the oldest pending messages until back within share
+    Coalesce,     // evict every pending message but the newest
+    Spill,        // like DropOldest, but hand evicted messages to Queue::spill
+};
+
+// Counters read from Dart with get_service_stats() (Service.stats).  The
+// layout is mirrored in service.dart; new fields are only ever appended.
+struct ServiceStats {
+    int64_t  bytes_held;   // message_bytes() of the messages in the queue
+    uint64_t evicted;      // messages evicted by the MemoryPolicy
+    uint64_t expired;      // messages dropped by next() past their deadline
+    uint64_t last_seq;     // sequence number of the newest message
+    uint64_t ingest_gaps;  // upstream messages missing (note_ingest_seq)
+    // Watchdog inputs (see watchdog.h); idle times are 0 until started.
+    uint64_t pending;        // messages queued, not yet handed to Dart
+    int64_t  drain_idle_ms;  // since Dart last took a message
+    int64_t  beat_idle_ms;   // since the worker last pushed or beat
+    uint32_t alarms;         // WatchdogAlarm bits currently raised
+    uint32_t reserved;
+};
+static_assert(sizeof(ServiceStats) == 72, "fcb::ServiceStats is shared with Dart");
+
+// CLOCK_MONOTONIC_COARSE: a few ns per read, millisecond resolution; enough
+// for the watchdog's timestamps, which are taken on every push.
+inline int64_t coarse_now_ns() noexcept {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Bytes a queued message is accounted for.  The default suits fixed-size
+// messages; message types that own heap memory overload message_bytes() in
+// their own namespace (found by argument-dependent lookup).
+template<typename T>
+size_t message_bytes(const T&) noexcept { return sizeof(T); }
+
+inline size_t message_bytes(const std::vector<uint8_t>& buf) noexcept {
+    return sizeof(buf) + buf.capacity();
+}
+
 // ── Shared base ──────────────────────────────────────────────────────────────
+struct ServiceBase;
+
+// Holds pointers to services, such as fcb::Watchdog (watchdog.h), and is
+// told by each one when it is destroyed.  A virtual call, so that the code
+// run is that of the library owning the watcher.
+class ServiceWatcher {
+public:
+    virtual void unwatch(ServiceBase& svc) = 0;
+
+protected:
+    ~ServiceWatcher() = default;
+};
+
+// Revision of the ServiceBase layout.  Process-wide objects that read
+// services of other libraries (fcb::registry(), fcb::watchdog()) carry it in
+// their symbol name (see FCB_LAYOUT_SYMBOL), so that libraries built with
+// different layouts never share one: bump it whenever the members change.
+#define FCB_SERVICE_LAYOUT 1
+
 struct ServiceBase {
     std::mutex                 mtx;
     std::atomic<bool>          stop_flag{false};
@@ -83,42 +177,328 @@ struct ServiceBase {
     // it, and that a nullptr store from dispose() is visible before any
     // subsequent worker call.
     std::atomic<void(*)()>     notify_cb{nullptr};
+    // Set from Dart (set_consumer_active) when a job is assigned / cancelled.
+    // Producers poll has_consumer() or block in wait_for_consumer() so that
+    // expensive acquisition pauses while nobody on the Dart side is listening.
+    std::atomic<bool>          consumer_flag{false};
+    // Signalled (under mtx) whenever consumer_flag or stop_flag changes.
+    // Derived services may wait on it for their own mtx-guarded state too.
+    std::condition_variable    state_cv;
+    // Memory accounting (see MemoryBudget); budget and weight change under mtx.
+    std::atomic<MemoryBudget*> budget{nullptr};
+    uint32_t                   budget_weight = 0;
+    MemoryPolicy               memory_policy = MemoryPolicy::DropOldest;
+    std::atomic<int64_t>       bytes_held{0};
+    std::atomic<uint64_t>      evicted{0};
+    std::atomic<uint64_t>      expired{0};
+    // Every message gets the next sequence number (1, 2, …) when it is
+    // pushed; a jump between two messages Dart receives is a local drop
+    // (evicted + expired).  Gaps in the producer's own numbering (a ZMQ
+    // publisher's id, HWM drops upstream) are reported by note_ingest_seq().
+    std::atomic<uint64_t>      last_seq{0};
+    std::atomic<uint64_t>      ingest_gaps{0};
+    // Set once start_service() has run, so that the registry can tell a
+    // service never started from a running one.
+    std::atomic<bool>          started{false};
+    // Activity read by the watchdog (see watchdog.h), as coarse_now_ns()
+    // stamps: the last push, the last message Dart took (or when the queue
+    // last became non-empty, whichever is later) and the last heartbeat().
+    // pending counts the slots not yet handed out, evicted ones included.
+    std::atomic<int64_t>       last_push_ns{0};
+    std::atomic<int64_t>       last_drain_ns{0};
+    std::atomic<int64_t>       last_beat_ns{0};
+    std::atomic<uint64_t>      pending{0};
+    std::atomic<uint32_t>      alarms{0};          // WatchdogAlarm bits
+    std::atomic<ServiceWatcher*> watcher{nullptr};  // set while watched
+
+    ~ServiceBase() {
+        if (ServiceWatcher* w = watcher.load(std::memory_order_relaxed)) w->unwatch(*this);
+    }
 
     bool stopped() const noexcept {
         return stop_flag.load(std::memory_order_relaxed);
     }
+    bool running() const noexcept {
+        return started.load(std::memory_order_relaxed) && !stopped();
+    }
+    bool has_consumer() const noexcept {
+        return consumer_flag.load(std::memory_order_relaxed);
+    }
     void notify() const noexcept {
         auto cb = notify_cb.load(std::memory_order_acquire);
         if (cb) cb();
     }
+
+    // Flags are flipped under mtx so that a worker blocked in
+    // wait_for_consumer() cannot miss the wake-up.
+    void set_consumer(bool active) {
+        { std::lock_guard<std::mutex> lk(mtx); consumer_flag.store(active, std::memory_order_relaxed); }
+        state_cv.notify_all();
+    }
+    void request_stop() {
+        { std::lock_guard<std::mutex> lk(mtx); stop_flag.store(true, std::memory_order_relaxed); }
+        state_cv.notify_all();
+    }
+    // Called by the start_service symbols before the worker is launched.
+    void mark_started() noexcept {
+        const int64_t now = coarse_now_ns();
+        last_drain_ns.store(now, std::memory_order_relaxed);
+        last_beat_ns.store(now, std::memory_order_relaxed);
+        started.store(true, std::memory_order_relaxed);
+        stop_flag.store(false, std::memory_order_relaxed);
+    }
+
+    // Called by a worker that ends on its own, before stop_service() (a
+    // one-shot reader at the end of its input): the service no longer
+    // counts as running for the registry and the watchdog, while Dart
+    // drains what it queued.
+    void mark_finished() noexcept {
+        started.store(false, std::memory_order_relaxed);
+    }
+
+    // Tells the watchdog the worker is alive.  Pushing does too, so only
+    // workers that may go quiet for longer than their heartbeat limit
+    // (waiting for hardware, say) need to call it.
+    void heartbeat() noexcept {
+        last_beat_ns.store(coarse_now_ns(), std::memory_order_relaxed);
+    }
+
+    // Blocks the worker until Dart has a consumer or the service is stopped.
+    // Returns false if woken by stop_service().
+    bool wait_for_consumer() {
+        std::unique_lock<std::mutex> lk(mtx);
+        state_cv.wait(lk, [this] { return has_consumer() || stopped(); });
+        heartbeat();
+        return !stopped();
+    }
+
+    // Attaches the service to `b` (nullptr detaches), moving the bytes it
+    // already holds from the previous budget.  Once this returns the service
+    // no longer touches the previous budget, so Dart may free it.
+    void set_memory_budget(MemoryBudget* b, uint32_t weight) {
+        std::lock_guard<std::mutex> lk(mtx);
+        const int64_t held = bytes_held.load(std::memory_order_relaxed);
+        if (MemoryBudget* old = budget.load(std::memory_order_relaxed)) {
+            old->used.fetch_sub(held, std::memory_order_relaxed);
+            old->total_weight.fetch_sub(budget_weight, std::memory_order_relaxed);
+        }
+        budget_weight = b ? std::max<uint32_t>(weight, 1) : 0;
+        if (b) {
+            b->used.fetch_add(held, std::memory_order_relaxed);
+            b->total_weight.fetch_add(budget_weight, std::memory_order_relaxed);
+        }
+        budget.store(b, std::memory_order_relaxed);
+    }
+
+    ServiceStats stats() const noexcept {
+        const bool live = started.load(std::memory_order_relaxed);
+        const int64_t now = live ? coarse_now_ns() : 0;
+        return {bytes_held.load(std::memory_order_relaxed),
+                evicted.load(std::memory_order_relaxed),
+                expired.load(std::memory_order_relaxed),
+                last_seq.load(std::memory_order_relaxed),
+                ingest_gaps.load(std::memory_order_relaxed),
+                pending.load(std::memory_order_relaxed),
+                live ? (now - last_drain_ns.load(std::memory_order_relaxed)) / 1000000 : 0,
+                live ? (now - last_beat()) / 1000000 : 0,
+                alarms.load(std::memory_order_relaxed),
+                0};
+    }
+
+    // Latest sign of life from the worker: a push or a heartbeat().
+    int64_t last_beat() const noexcept {
+        return std::max(last_push_ns.load(std::memory_order_relaxed),
+                        last_beat_ns.load(std::memory_order_relaxed));
+    }
+
+    // Called by the ingest thread with the sequence number the upstream
+    // producer put in each received message.  Returns how many messages
+    // were skipped since the previous one (added to ingest_gaps).  A number
+    // that goes backwards is taken as a producer restart and resynchronises.
+    uint64_t note_ingest_seq(uint64_t seq) noexcept {
+        uint64_t missing = 0;
+        if (_ingest_started && seq > _ingest_next) missing = seq - _ingest_next;
+        _ingest_started = true;
+        _ingest_next    = seq + 1;
+        if (missing) ingest_gaps.fetch_add(missing, std::memory_order_relaxed);
+        return missing;
+    }
+
+protected:
+    uint64_t _ingest_next    = 0;       // ingest thread only
+    bool     _ingest_started = false;
+
+    // Called by the variants with mtx held; depth is what remains pending.
+    void _note_push(uint64_t depth) noexcept {
+        const int64_t now = coarse_now_ns();
+        last_push_ns.store(now, std::memory_order_relaxed);
+        if (pending.exchange(depth, std::memory_order_relaxed) == 0)
+            last_drain_ns.store(now, std::memory_order_relaxed);   // nothing was owed
+    }
+    void _note_drain(uint64_t depth) noexcept {
+        last_drain_ns.store(coarse_now_ns(), std::memory_order_relaxed);
+        pending.store(depth, std::memory_order_relaxed);
+    }
+
+    // Both called with mtx held.
+    void _account(int64_t delta) noexcept {
+        bytes_held.fetch_add(delta, std::memory_order_relaxed);
+        if (MemoryBudget* b = budget.load(std::memory_order_relaxed))
+            b->used.fetch_add(delta, std::memory_order_relaxed);
+    }
+    bool _over_share() const noexcept {
+        MemoryBudget* b = budget.load(std::memory_order_relaxed);
+        if (!b) return false;
+        const int64_t limit = b->limit.load(std::memory_order_relaxed);
+        if (limit <= 0 || b->used.load(std::memory_order_relaxed) <= limit) return false;
+        const uint32_t total = std::max<uint32_t>(b->total_weight.load(std::memory_order_relaxed), 1);
+        return bytes_held.load(std::memory_order_relaxed) > limit / total * budget_weight;
+    }
 };
 
 // ── Queue variant ────────────────────────────────────────────────────────────
-// Worker calls push(); Dart drains one message at a time (FIFO).
+// Worker calls push(); Dart drains messages in FIFO order.
+//
+// Each next() hands out the oldest message not yet handed out, so Dart may
+// hold several pointers at once (async jobs) and release them in any order.
+// std::deque is intentional: push_back() and pop_front() never invalidate
+// references to the other elements.  A released message is only marked; the
+// front of the deque is popped while it is released, so a pointer that Dart
+// still holds is never moved or freed.
+//
+// Messages evicted by the MemoryPolicy are freed at once and left as
+// released slots, which next() skips.
 //
-// std::deque is intentional: push_back() never invalidates references to
-// existing elements, so Dart can safely hold a pointer to &front() while
-// the worker is pushing new messages at the back.
+// A message may carry a time-to-live (push(msg, ttl), or default_ttl for
+// plain push()).  Expiry is lazy: next() frees and skips messages whose
+// deadline has passed, so after a stall Dart resumes with fresh messages
+// instead of replaying stale ones.
 template<typename T>
 struct Queue : ServiceBase {
-    std::deque<T> _q;
+    struct Slot {
+        std::optional<T> value;        // empty once evicted or expired
+        size_t           bytes    = 0; // accounted until popped or dropped
+        int64_t          deadline = 0; // steady_clock ns; 0 = never expires
+        uint64_t         seq      = 0;
+        bool             released = false;
+    };
+    using ttl_type = std::chrono::nanoseconds;
+    std::deque<Slot> _q;
+    size_t           _out = 0;   // slots at the front handed out to Dart
 
-    void push(T msg) {
-        { std::lock_guard<std::mutex> lk(mtx); _q.push_back(std::move(msg)); }
+    // Receives evicted messages under MemoryPolicy::Spill (on the pushing
+    // thread, without the lock held), e.g. to write them to disk.
+    std::function<void(T&&)> spill;
+
+    // Time-to-live of messages pushed without one; zero = no expiry.
+    ttl_type default_ttl{0};
+
+    void push(T msg) { push(std::move(msg), default_ttl); }
+
+    void push(T msg, ttl_type ttl) {
+        const int64_t deadline = ttl.count() > 0 ? _now_ns() + ttl.count() : 0;
+        std::vector<T> spilled;
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            const size_t bytes = message_bytes(msg);
+            const uint64_t seq = last_seq.load(std::memory_order_relaxed) + 1;
+            _q.push_back(Slot{std::move(msg), bytes, deadline, seq});
+            last_seq.store(seq, std::memory_order_relaxed);
+            _account(static_cast<int64_t>(bytes));
+            if (_over_share()) _evict_locked(spilled);
+            _note_push(_q.size() - _out);
+        }
         notify();
+        for (T& m : spilled) spill(std::move(m));
     }
 
     void* next() noexcept {
         std::lock_guard<std::mutex> lk(mtx);
-        return _q.empty() ? nullptr : static_cast<void*>(&_q.front());
+        _pop_released();
+        int64_t now = 0;
+        uint64_t n = 0;
+        while (_out < _q.size()) {
+            Slot& s = _q[_out];
+            if (!s.released) {
+                if (s.deadline == 0) break;
+                if (now == 0) now = _now_ns();
+                if (now < s.deadline) break;
+                _drop_locked(s);
+                ++n;
+            }
+            ++_out;
+        }
+        if (n) {
+            expired.fetch_add(n, std::memory_order_relaxed);
+            _pop_released();
+        }
+        if (_out == _q.size()) {
+            pending.store(0, std::memory_order_relaxed);
+            return nullptr;
+        }
+        void* p = &*_q[_out++].value;
+        _note_drain(_q.size() - _out);
+        return p;
+    }
+
+    // Sequence number of a message handed out by next(); 0 if unknown.
+    uint64_t seq_of(const void* p) noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        for (size_t i = _out; i-- > 0;)   // usually the most recent one
+            if (!_q[i].released && &*_q[i].value == p) return _q[i].seq;
+        return 0;
     }
 
     void release(void* p) noexcept {
         if (!p) return;
         std::lock_guard<std::mutex> lk(mtx);
         auto* typed = static_cast<T*>(p);
-        for (auto it = _q.begin(); it != _q.end(); ++it)
-            if (&(*it) == typed) { _q.erase(it); return; }
+        for (size_t i = 0; i < _out; ++i)
+            if (!_q[i].released && &*_q[i].value == typed) { _q[i].released = true; break; }
+        _pop_released();
+    }
+
+private:
+    static int64_t _now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Frees a pending message and leaves its slot as released.
+    void _drop_locked(Slot& s) noexcept {
+        s.value.reset();
+        s.released = true;
+        _account(-static_cast<int64_t>(s.bytes));
+        s.bytes = 0;
+    }
+
+    // Skips dropped slots at the head of the pending range, then pops the
+    // released prefix.
+    void _pop_released() noexcept {
+        while (_out < _q.size() && _q[_out].released) ++_out;
+        while (_out > 0 && _q.front().released) {
+            _account(-static_cast<int64_t>(_q.front().bytes));
+            _q.pop_front();
+            --_out;
+        }
+    }
+
+    void _evict_locked(std::vector<T>& spilled) {
+        const bool coalesce = memory_policy == MemoryPolicy::Coalesce;
+        const bool to_spill = memory_policy == MemoryPolicy::Spill && spill;
+        uint64_t n = 0;
+        for (size_t i = _out; i + 1 < _q.size(); ++i) {
+            if (!coalesce && !_over_share()) break;
+            Slot& s = _q[i];
+            if (s.released) continue;
+            if (to_spill) spilled.push_back(std::move(*s.value));
+            _drop_locked(s);
+            ++n;
+        }
+        evicted.fetch_add(n, std::memory_order_relaxed);
+        if (MemoryBudget* b = budget.load(std::memory_order_relaxed))
+            b->evicted.fetch_add(n, std::memory_order_relaxed);
+        _pop_released();
     }
 };
 
@@ -126,25 +506,182 @@ struct Queue : ServiceBase {
 // Worker calls set(); Dart reads the latest value once then releases it.
 // Only one message is live at a time; _ready acts as the nullptr sentinel
 // so get_next_message() correctly returns nullptr after consumption.
+// _out keeps the value from being handed out twice while Dart holds it.
+//
+// The value is double-buffered: Dart may hold it across awaits (async
+// jobs), so a set() that lands while it is out writes the other slot.  The
+// notification of such a set() finds the value out and is lost, so
+// release() notifies again when a newer value is waiting.
 template<typename T>
 struct CurrentValue : ServiceBase {
-    T    _val{};
-    bool _ready = false;
+    T        _slot[2]{};
+    uint8_t  _cur  = 0;   // slot holding the latest value
+    uint8_t  _held = 0;   // slot handed out while _out
+    bool     _ready = false;
+    bool     _out   = false;
+    uint64_t _gen = 0, _gen_out = 0;
 
     void set(T val) {
-        { std::lock_guard<std::mutex> lk(mtx); _val = std::move(val); _ready = true; }
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (_out && _cur == _held) _cur ^= 1;   // never write what Dart reads
+            _slot[_cur] = std::move(val);
+            _ready = true;
+            last_seq.store(++_gen, std::memory_order_relaxed);
+            _note_push(1);
+        }
         notify();
     }
 
+    // Sequence number of the value handed out by next().
+    uint64_t seq_of(const void*) noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        return _gen_out;
+    }
+
     void* next() noexcept {
         std::lock_guard<std::mutex> lk(mtx);
-        return _ready ? static_cast<void*>(&_val) : nullptr;
+        if (!_ready || _out) return nullptr;
+        _out     = true;
+        _held    = _cur;
+        _gen_out = _gen;
+        _note_drain(0);
+        return static_cast<void*>(&_slot[_held]);
     }
 
     void release(void* p) noexcept {
         if (!p) return;
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            _ready = _gen != _gen_out;
+            _out   = false;
+            if (!_ready) return;
+        }
+        notify();   // set() while out: its notification found nothing
+    }
+};
+
+// ── History variant ──────────────────────────────────────────────────────────
+// Worker calls push(); samples go into a fixed-capacity native ring that
+// keeps the last N values.  Every sample gets a sequence number (0, 1, 2, …);
+// samples [begin_seq(), end_seq()) are available.  Dart pulls exactly the
+// window it renders with read_range() (copy) or view() (zero-copy), instead
+// of keeping its own growing history list.
+//
+// Notifications are coalesced like CurrentValue: get_next_message() returns
+// a pointer to a uint64_t holding end_seq() at the time of the last push,
+// then nullptr until the message is released.  The tick handed out does not
+// change while Dart holds it; pushes meanwhile are notified again on
+// release().
+template<typename T>
+struct History : ServiceBase {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "fcb::History<T> copies samples with memcpy");
+
+    // Two contiguous segments covering a window of the ring (the second one
+    // is empty unless the window wraps around).  Counts are in samples.
+    struct View {
+        const T* first;
+        uint32_t first_count;
+        const T* second;
+        uint32_t second_count;
+        uint64_t first_seq;
+    };
+
+    // A capacity of 0 is taken as 1: the ring always holds the latest sample.
+    explicit History(uint32_t capacity) : _ring(std::max<uint32_t>(capacity, 1)) {}
+
+    void push(T sample) {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            _ring[_end % _ring.size()] = sample;
+            _tick  = ++_end;
+            _ready = true;
+            last_seq.store(_end, std::memory_order_relaxed);
+            _note_push(1);
+        }
+        notify();
+    }
+
+    // The tick handed out by next() is itself the sequence number.
+    uint64_t seq_of(const void*) noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        return _tick_out;
+    }
+
+    uint32_t capacity() const noexcept { return static_cast<uint32_t>(_ring.size()); }
+
+    uint64_t begin_seq() noexcept {
         std::lock_guard<std::mutex> lk(mtx);
-        _ready = false;
+        return _begin_locked();
+    }
+    uint64_t end_seq() noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        return _end;
+    }
+
+    // Copies up to count samples starting at start_seq into out.  A start_seq
+    // that has already been overwritten is clamped to begin_seq().  Returns
+    // the number of samples written.
+    uint32_t read_range(uint64_t start_seq, uint32_t count, T* out) noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        View v = _view_locked(start_seq, count);
+        std::memcpy(out, v.first, v.first_count * sizeof(T));
+        std::memcpy(out + v.first_count, v.second, v.second_count * sizeof(T));
+        return v.first_count + v.second_count;
+    }
+
+    // Zero-copy variant of read_range().  The pointers reference the ring
+    // itself: the data is intact as long as begin_seq() <= first_seq, which
+    // the reader checks after consuming the segments.
+    View view(uint64_t start_seq, uint32_t count) noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        return _view_locked(start_seq, count);
+    }
+
+    void* next() noexcept {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (!_ready || _out) return nullptr;
+        _out      = true;
+        _tick_out = _tick;
+        _note_drain(0);
+        return static_cast<void*>(&_tick_out);
+    }
+
+    void release(void* p) noexcept {
+        if (!p) return;
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            _ready = _tick != _tick_out;   // pushed while Dart held the tick
+            _out   = false;
+            if (!_ready) return;
+        }
+        notify();   // that push's notification found the tick out
+    }
+
+    std::vector<T> _ring;
+    uint64_t       _end      = 0;
+    uint64_t       _tick     = 0;
+    uint64_t       _tick_out = 0;
+    bool           _ready    = false;
+    bool           _out      = false;
+
+private:
+    uint64_t _begin_locked() const noexcept {
+        return _end > _ring.size() ? _end - _ring.size() : 0;
+    }
+
+    View _view_locked(uint64_t start_seq, uint32_t count) const noexcept {
+        start_seq = std::max(start_seq, _begin_locked());
+        uint64_t stop = std::min<uint64_t>(_end, start_seq + count);
+        View v{_ring.data(), 0, _ring.data(), 0, start_seq};
+        if (start_seq >= stop) return v;
+        auto n   = static_cast<uint32_t>(stop - start_seq);
+        auto idx = static_cast<uint32_t>(start_seq % _ring.size());
+        v.first        = _ring.data() + idx;
+        v.first_count  = std::min<uint32_t>(n, capacity() - idx);
+        v.second_count = n - v.first_count;
+        return v;
     }
 };
 
@@ -157,7 +694,10 @@ using BytesQueue = Queue<BytesMsg>;
 } // namespace fcb
 
 // ── FCB_EXPORT_SYMBOLS ───────────────────────────────────────────────────────
-// Generates the five mandatory C-linkage symbols for a pooled service.
+// Generates the five mandatory C-linkage symbols for a pooled service, plus
+// the optional set_consumer_active(bool) used by Dart for flow control,
+// service_running() checked by Service.exclusive wrappers before they take
+// the callback over, and the FCB_EXPORT_STATS_SYMBOLS.
 //
 // Parameters:
 //   svc        — name of a global fcb::Queue<T> or fcb::CurrentValue<T>
@@ -169,15 +709,83 @@ using BytesQueue = Queue<BytesMsg>;
 //
 #define FCB_EXPORT_SYMBOLS(svc, worker_fn)                                          \
     FCB_EXPORT void  start_service() {                                              \
-        (svc).stop_flag.store(false, std::memory_order_relaxed);                    \
+        (svc).mark_started();                                                       \
         std::thread([&s = (svc)]() { worker_fn(s); }).detach();                     \
     }                                                                               \
-    FCB_EXPORT void  stop_service()  {                                              \
-        (svc).stop_flag.store(true, std::memory_order_relaxed);                     \
-    }                                                                               \
+    FCB_EXPORT void  stop_service()  { (svc).request_stop(); }                      \
     FCB_EXPORT void* get_next_message()        { return (svc).next();    }          \
     FCB_EXPORT void  free_message(void* p)     { (svc).release(p);       }          \
-    FCB_EXPORT void  set_message_callback(void (*cb)()) { (svc).notify_cb.store(cb, std::memory_order_release); }
+    FCB_EXPORT void  set_message_callback(void (*cb)()) { (svc).notify_cb.store(cb, std::memory_order_release); } \
+    FCB_EXPORT void  set_consumer_active(bool active) { (svc).set_consumer(active); } \
+    FCB_EXPORT bool  service_running() { return (svc).running(); }                  \
+    FCB_EXPORT_STATS_SYMBOLS(svc)
+
+// ── FCB_EXPORT_STATS_SYMBOLS ─────────────────────────────────────────────────
+// Accounting and sequencing symbols, included by every FCB_EXPORT_*SYMBOLS
+// macro that wraps a ServiceBase:
+//
+//   set_memory_budget(budget, weight)  →  void  attach to an fcb::MemoryBudget
+//                                               (nullptr detaches)
+//   get_service_stats(out, size)       →  void  copies min(size, sizeof)
+//                                               bytes of fcb::ServiceStats
+//   get_message_seq(msg)               →  uint64_t  sequence number of a
+//                                               message from get_next_message
+//
+// set_watchdog is opt-in: FCB_EXPORT_WATCHDOG_SYMBOLS (watchdog.h).
+//
+#define FCB_EXPORT_STATS_SYMBOLS(svc)                                               \
+    FCB_EXPORT void set_memory_budget(void* budget, uint32_t weight) {              \
+        (svc).set_memory_budget(static_cast<fcb::MemoryBudget*>(budget), weight);   \
+    }                                                                               \
+    FCB_EXPORT void get_service_stats(void* out, uint32_t size) {                   \
+        fcb::ServiceStats st = (svc).stats();                                       \
+        std::memcpy(out, &st, std::min<size_t>(size, sizeof(st)));                  \
+    }                                                                               \
+    FCB_EXPORT uint64_t get_message_seq(void* msg) { return (svc).seq_of(msg); }
+
+// ── FCB_EXPORT_CHANNEL_SYMBOLS ───────────────────────────────────────────────
+// Several services in one library (e.g. the channels of a demultiplexer).
+// Each channel is a ServiceBase-derived queue addressed by index; Dart binds
+// one with Service.channel(libname, index).  The symbols mirror the
+// per-library ones with a leading uint32_t channel argument:
+//
+//   channel_start_service(ch)        channel_stop_service(ch)
+//   channel_get_next_message(ch)     channel_free_message(ch, msg)
+//   channel_set_message_callback(ch, cb)
+//   channel_set_consumer_active(ch, active)
+//   channel_set_memory_budget(ch, budget, weight)
+//   channel_get_service_stats(ch, out, size)
+//   channel_get_message_seq(ch, msg)
+//
+// channel_set_watchdog is opt-in: FCB_EXPORT_CHANNEL_WATCHDOG_SYMBOLS
+// (watchdog.h).
+//
+// Parameters:
+//   channel_of — expression callable as channel_of(ch), returning the
+//                channel's queue by reference
+//   start_fn / stop_fn — called as start_fn(ch) / stop_fn(ch)
+//
+#define FCB_EXPORT_CHANNEL_SYMBOLS(channel_of, start_fn, stop_fn)                   \
+    FCB_EXPORT void  channel_start_service(uint32_t ch) { start_fn(ch); }           \
+    FCB_EXPORT void  channel_stop_service (uint32_t ch) { stop_fn(ch);  }           \
+    FCB_EXPORT void* channel_get_next_message(uint32_t ch) { return channel_of(ch).next(); } \
+    FCB_EXPORT void  channel_free_message(uint32_t ch, void* p) { channel_of(ch).release(p); } \
+    FCB_EXPORT void  channel_set_message_callback(uint32_t ch, void (*cb)()) {      \
+        channel_of(ch).notify_cb.store(cb, std::memory_order_release);              \
+    }                                                                               \
+    FCB_EXPORT void  channel_set_consumer_active(uint32_t ch, bool active) {        \
+        channel_of(ch).set_consumer(active);                                        \
+    }                                                                               \
+    FCB_EXPORT void  channel_set_memory_budget(uint32_t ch, void* budget, uint32_t weight) { \
+        channel_of(ch).set_memory_budget(static_cast<fcb::MemoryBudget*>(budget), weight); \
+    }                                                                               \
+    FCB_EXPORT void  channel_get_service_stats(uint32_t ch, void* out, uint32_t size) { \
+        fcb::ServiceStats st = channel_of(ch).stats();                              \
+        std::memcpy(out, &st, std::min<size_t>(size, sizeof(st)));                  \
+    }                                                                               \
+    FCB_EXPORT uint64_t channel_get_message_seq(uint32_t ch, void* msg) {           \
+        return channel_of(ch).seq_of(msg);                                          \
+    }
 
 // ── FCB_EXPORT_STANDALONE_NOOP ───────────────────────────────────────────────
 // Generates five no-op mandatory symbols for a standalone service (command
@@ -227,3 +835,35 @@ using BytesQueue = Queue<BytesMsg>;
     get_msg_len (fcb::BytesMsg* msg) {                                              \
         return static_cast<uint32_t>(msg->size());                                  \
     }
+
+// ── FCB_EXPORT_HISTORY_SYMBOLS ───────────────────────────────────────────────
+// Variant of FCB_EXPORT_SYMBOLS for fcb::History<T> services.
+//
+// Exports the mandatory symbols plus the window-read API (sample type T is
+// seen from C as void*, counts are in samples):
+//
+//   history_begin_seq()            →  uint64_t  oldest available sample
+//   history_end_seq()              →  uint64_t  one past the newest sample
+//   history_capacity()             →  uint32_t  ring size in samples
+//   history_sample_size()          →  uint32_t  sizeof(T)
+//   read_range(start, count, out)  →  uint32_t  samples copied into out
+//   read_view (start, count, view) →  void      fills an fcb::History<T>::View
+//
+// On the Dart side, use HistoryService (history_service.dart).
+//
+#define FCB_EXPORT_HISTORY_SYMBOLS(svc, worker_fn)                                  \
+    FCB_EXPORT_SYMBOLS(svc, worker_fn)                                              \
+    FCB_EXPORT uint64_t history_begin_seq()   { return (svc).begin_seq(); }         \
+    FCB_EXPORT uint64_t history_end_seq()     { return (svc).end_seq();   }         \
+    FCB_EXPORT uint32_t history_capacity()    { return (svc).capacity();  }         \
+    FCB_EXPORT uint32_t history_sample_size() {                                     \
+        return static_cast<uint32_t>(sizeof((svc)._ring[0]));                       \
+    }                                                                               \
+    FCB_EXPORT uint32_t read_range(uint64_t start_seq, uint32_t count, void* out) { \
+        using sample_t = std::remove_reference_t<decltype((svc)._ring[0])>;        \
+        return (svc).read_range(start_seq, count, static_cast<sample_t*>(out));     \
+    }                                                                               \
+    FCB_EXPORT void read_view(uint64_t start_seq, uint32_t count, void* view) {     \
+        auto v = (svc).view(start_seq, count);                                      \
+        std::memcpy(view, &v, sizeof(v));                                           \
+    }
@@ -0,0 +1,290 @@
+// flutter_cpp_bridge/service_registry.h
+//
+// Process-wide registry of the services loaded in the process
+// (fcb::registry()), filled by FCB_REGISTER_SERVICE when each library is
+// loaded, so that Dart can find and construct them (ServiceRegistry in
+// service_registry.dart).
+//
+// Requirements: C++17; libdl (link with ${CMAKE_DL_LIBS} on glibc older
+// than 2.34), through fcb::process_instance() and dladdr().
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/service_registry.h"
+//
+//   static fcb::Queue<liba_message_t> g_svc;
+//
+//   FCB_EXPORT_SYMBOLS(g_svc, worker)
+//   FCB_REGISTER_SERVICE(g_svc, "liba", "color")
+//
+
+#pragma once
+#include "process_shared.h"
+#include "service_helpers.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+namespace fcb {
+
+// ── Service registry ─────────────────────────────────────────────────────────
+// Process-wide list of the services loaded in the process, so Dart can find
+// and construct them instead of hardcoding library names.  A library
+// registers its services when it is loaded and unregisters them at exit:
+//
+//   static fcb::Queue<liba_message_t> g_svc;
+//   FCB_EXPORT_SYMBOLS(g_svc, worker)
+//   FCB_REGISTER_SERVICE(g_svc, "liba", "color,random")
+//
+// Every registering library also exports the query symbols
+// (fcb_registry_json / fcb_registry_free), and the registry is shared by
+// every library (see fcb::process_instance()), so Dart may ask any of them
+// (ServiceRegistry in service_registry.dart).
+struct ServiceInfo {
+    std::string              name;           // unique in the process
+    std::string              library;        // path the library was loaded from
+    std::string              kind;           // "queue", "bytes", "current", "history",
+                                             // "standalone", or your own
+    std::string              message_type;   // C++ type of the messages, if known
+    std::vector<std::string> capabilities;
+    int32_t                  channel = -1;   // for Service.channel; -1 = whole library
+    const ServiceBase*       base    = nullptr;   // live state; null if none
+};
+
+class ServiceRegistry {
+public:
+    // False if the name is already taken.
+    bool add(ServiceInfo info) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        for (const ServiceInfo& s : _services)
+            if (s.name == info.name) return false;
+        _services.push_back(std::move(info));
+        return true;
+    }
+
+    void remove(std::string_view name) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _services.erase(std::remove_if(_services.begin(), _services.end(),
+                                       [&](const ServiceInfo& s) { return s.name == name; }),
+                        _services.end());
+    }
+
+    // In registration (= load) order.
+    std::vector<ServiceInfo> list() const {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _services;
+    }
+
+    // Array of {name, library, kind, message_type, capabilities, channel,
+    // running, consumer}; running and consumer are read at the time of the
+    // call.
+    std::string json() const {
+        std::lock_guard<std::mutex> lk(_mtx);
+        std::string out = "[";
+        for (const ServiceInfo& s : _services) {
+            if (out.size() > 1) out += ',';
+            out += "{\"name\":";          _quote(out, s.name);
+            out += ",\"library\":";       _quote(out, s.library);
+            out += ",\"kind\":";          _quote(out, s.kind);
+            out += ",\"message_type\":";  _quote(out, s.message_type);
+            out += ",\"capabilities\":[";
+            for (size_t i = 0; i < s.capabilities.size(); ++i) {
+                if (i) out += ',';
+                _quote(out, s.capabilities[i]);
+            }
+            out += "],\"channel\":" + std::to_string(s.channel);
+            out += ",\"running\":";
+            out += s.base && s.base->running() ? "true" : "false";
+            out += ",\"consumer\":";
+            out += s.base && s.base->has_consumer() ? "true" : "false";
+            out += '}';
+        }
+        return out + "]";
+    }
+
+private:
+    static void _quote(std::string& out, std::string_view v) {
+        out += '"';
+        for (char c : v) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char esc[8];
+                std::snprintf(esc, sizeof esc, "\\u%04x", c);
+                out += esc;
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    mutable std::mutex       _mtx;
+    std::vector<ServiceInfo> _services;
+};
+
+} // namespace fcb
+
+// Candidate instances (see fcb::process_instance()).  Entries point to
+// services of other libraries, so the symbol carries FCB_SERVICE_LAYOUT.
+FCB_EXPORT __attribute__((used)) inline void* FCB_LAYOUT_SYMBOL(fcb_registry_v1)() {
+    static fcb::ServiceRegistry* r = new fcb::ServiceRegistry;   // never destroyed
+    return r;
+}
+
+namespace fcb {
+
+// The process-wide service registry.
+inline ServiceRegistry& registry() {
+    static ServiceRegistry* const instance = static_cast<ServiceRegistry*>(process_instance(
+        FCB_SYMBOL_NAME(FCB_LAYOUT_SYMBOL(fcb_registry_v1)), FCB_LAYOUT_SYMBOL(fcb_registry_v1)));
+    return *instance;
+}
+
+// Demangled name of T, e.g. "liba_message_t".
+template<typename T>
+inline std::string type_name() {
+    int status = 0;
+    char* s = abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status);
+    std::string name = status == 0 && s ? s : typeid(T).name();
+    std::free(s);
+    return name;
+}
+
+namespace detail {
+template<typename T> T    queue_message(const Queue<T>*);
+template<typename T> T    queue_message(const CurrentValue<T>*);
+template<typename T> T    queue_message(const History<T>*);
+inline               void queue_message(const void*);
+
+template<typename T> const char* queue_kind(const Queue<T>*)        { return "queue"; }
+inline               const char* queue_kind(const Queue<BytesMsg>*) { return "bytes"; }
+template<typename T> const char* queue_kind(const CurrentValue<T>*) { return "current"; }
+template<typename T> const char* queue_kind(const History<T>*)      { return "history"; }
+inline               const char* queue_kind(const void*)            { return ""; }
+} // namespace detail
+
+// ServiceInfo without live state, e.g. for a standalone service;
+// capabilities are comma-separated (surrounding spaces are ignored).
+inline ServiceInfo make_service_info(std::string name, std::string_view capabilities,
+                                     std::string kind) {
+    ServiceInfo info;
+    info.name = std::move(name);
+    info.kind = std::move(kind);
+    while (!capabilities.empty()) {
+        const size_t comma = std::min(capabilities.find(','), capabilities.size());
+        std::string_view tag = capabilities.substr(0, comma);
+        while (!tag.empty() && tag.front() == ' ') tag.remove_prefix(1);
+        while (!tag.empty() && tag.back() == ' ') tag.remove_suffix(1);
+        if (!tag.empty()) info.capabilities.emplace_back(tag);
+        capabilities.remove_prefix(std::min(comma + 1, capabilities.size()));
+    }
+    return info;
+}
+
+// ServiceInfo for svc; kind defaults to the helper svc derives from.
+template<typename S>
+inline ServiceInfo describe_service(const S& svc, std::string name,
+                                    std::string_view capabilities, std::string kind = {}) {
+    if (kind.empty()) kind = detail::queue_kind(&svc);
+    ServiceInfo info = make_service_info(std::move(name), capabilities, std::move(kind));
+    using message_t = decltype(detail::queue_message(&svc));
+    if constexpr (!std::is_void_v<message_t>) info.message_type = type_name<message_t>();
+    if constexpr (std::is_base_of_v<ServiceBase, S>) info.base = &svc;
+    return info;
+}
+
+// ServiceInfo for channel `index` of a multi-service library (see
+// FCB_EXPORT_CHANNEL_SYMBOLS); ch is that channel's queue.
+template<typename S>
+inline ServiceInfo describe_channel(const S& ch, uint32_t index, std::string name,
+                                    std::string_view capabilities, std::string kind = {}) {
+    ServiceInfo info = describe_service(ch, std::move(name), capabilities, std::move(kind));
+    info.channel = static_cast<int32_t>(index);
+    return info;
+}
+
+} // namespace fcb
+
+// Query symbols, exported by every library that registers a service.
+// fcb_registry_json() returns the ServiceRegistry::json() snapshot in a
+// buffer the caller frees with fcb_registry_free().
+FCB_EXPORT inline char* fcb_registry_json() {
+    const std::string json = fcb::registry().json();
+    char* out = static_cast<char*>(std::malloc(json.size() + 1));
+    if (out) std::memcpy(out, json.c_str(), json.size() + 1);
+    return out;
+}
+FCB_EXPORT inline void fcb_registry_free(char* json) { std::free(json); }
+
+namespace fcb {
+
+// Registers a service for as long as it exists (see FCB_REGISTER_SERVICE);
+// the library path is looked up from the registration's own address.
+class ServiceRegistration {
+public:
+    explicit ServiceRegistration(ServiceInfo info) : _name(info.name) {
+        // Referencing the query symbols emits them in this library.
+        asm volatile("" : : "r"(&fcb_registry_json), "r"(&fcb_registry_free));
+        Dl_info dl{};
+        if (info.library.empty() && dladdr(this, &dl) && dl.dli_fname)
+            info.library = dl.dli_fname;
+        _added = registry().add(std::move(info));
+    }
+    ~ServiceRegistration() { if (_added) registry().remove(_name); }
+
+    ServiceRegistration(const ServiceRegistration&) = delete;
+    ServiceRegistration& operator=(const ServiceRegistration&) = delete;
+
+    // False if another service had already registered the name.
+    bool added() const noexcept { return _added; }
+
+private:
+    std::string _name;
+    bool        _added = false;
+};
+
+} // namespace fcb
+
+// ── FCB_REGISTER_SERVICE ─────────────────────────────────────────────────────
+// Adds a service of this library to fcb::registry() when the library is
+// loaded, and removes it when the library is unloaded:
+//
+//   FCB_REGISTER_SERVICE(svc, name, capabilities)
+//   FCB_REGISTER_SERVICE_AS(svc, name, kind, capabilities)
+//   FCB_REGISTER_CHANNEL(hub, index, name, capabilities)
+//   FCB_REGISTER_STANDALONE(name, capabilities)
+//
+//   svc          — the service instance; its kind ("queue", "bytes",
+//                  "current", "history") and message type are deduced
+//   hub, index   — a channel host constructed with its channels, e.g. an
+//                  fcb::ZmqDemux; Dart binds it with Service.channel
+//   name         — unique in the process, e.g. "liba"
+//   kind         — overrides the deduced kind, e.g. "zmq_ingest", so that
+//                  Dart can pick the matching wrapper class
+//   capabilities — comma-separated tags, e.g. "color,random"
+//
+#define FCB_REGISTER_SERVICE(svc, name, capabilities)                               \
+    FCB_REGISTER_INFO_(fcb::describe_service((svc), (name), (capabilities)))
+#define FCB_REGISTER_SERVICE_AS(svc, name, kind, capabilities)                      \
+    FCB_REGISTER_INFO_(fcb::describe_service((svc), (name), (capabilities), (kind)))
+#define FCB_REGISTER_CHANNEL(hub, index, name, capabilities)                        \
+    FCB_REGISTER_INFO_(fcb::describe_channel((hub).channel(index), (index), (name),   \
+                                             (capabilities)))
+#define FCB_REGISTER_STANDALONE(name, capabilities)                                 \
+    FCB_REGISTER_INFO_(fcb::make_service_info((name), (capabilities), "standalone"))
+
+#define FCB_REGISTER_INFO_(info)   FCB_REGISTER_INFO_AT_(info, __LINE__)
+#define FCB_REGISTER_INFO_AT_(info, line) FCB_REGISTER_INFO_AT2_(info, line)
+#define FCB_REGISTER_INFO_AT2_(info, line)                                          \
+    static const fcb::ServiceRegistration fcb_registration_##line{info};
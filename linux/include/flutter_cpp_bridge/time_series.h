@@ -0,0 +1,272 @@
+// flutter_cpp_bridge/time_series.h
+//
+// Time-indexed native store for replay / scrub UIs that ask "give me the
+// samples between t0 and t1" over tens of millions of stored samples.
+//
+// Storage is columnar (one timestamp array, one value array) with a sparse
+// block index holding, per block of kBlock samples, the time span and the
+// min / max value.  A query binary-searches the block index, then the block,
+// and decimates the range into at most max_points samples by keeping the
+// min and max of each time bucket — whole blocks inside a bucket are
+// summarised from the index without touching their samples.
+//
+// Queries are requested from Dart, run on a dedicated query thread and come
+// back through the regular notify / get_next_message path as a result
+// message whose arrays Dart views zero-copy until free_message().
+//
+// Requirements: C++17 or later.
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/time_series.h"
+//
+//   static fcb::TimeSeries<float> g_svc;
+//
+//   static void worker(fcb::TimeSeries<float>& svc) {
+//       while (!svc.stopped()) {
+//           svc.append(now_ns(), read_sensor());
+//           std::this_thread::sleep_for(std::chrono::milliseconds(1));
+//       }
+//   }
+//
+//   FCB_EXPORT_TIME_SERIES_SYMBOLS(g_svc, worker)
+//
+// On the Dart side, use TimeSeriesService (time_series_service.dart).
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <shared_mutex>
+
+namespace fcb {
+
+// One decimated query answer.  times / values have the same length; samples
+// are in increasing time order.
+template<typename V>
+struct TimeSeriesResult {
+    uint64_t             id = 0;
+    std::vector<int64_t> times;
+    std::vector<V>       values;
+};
+
+// Worker calls append(); Dart calls query() and receives TimeSeriesResult<V>
+// messages through the inherited Queue.
+template<typename V>
+struct TimeSeries : Queue<TimeSeriesResult<V>> {
+    static_assert(std::is_arithmetic<V>::value,
+                  "fcb::TimeSeries<V> needs an ordered numeric value type");
+
+    using result_type = TimeSeriesResult<V>;
+
+    static constexpr uint32_t kBlock = 4096;
+
+    struct BlockInfo {
+        int64_t  t_first, t_last;
+        V        v_min, v_max;
+        uint32_t i_min, i_max;   // absolute sample indices
+    };
+
+    struct Request {
+        uint64_t id;
+        int64_t  t0, t1;
+        uint32_t max_points;
+    };
+
+    void reserve(size_t samples) {
+        std::unique_lock<std::shared_mutex> lk(_data_mtx);
+        _ts.reserve(samples);
+        _val.reserve(samples);
+        _blocks.reserve(samples / kBlock + 1);
+    }
+
+    // Timestamps must be non-decreasing; an out-of-order sample is rejected.
+    bool append(int64_t t, V v) {
+        std::unique_lock<std::shared_mutex> lk(_data_mtx);
+        if (!_ts.empty() && t < _ts.back()) return false;
+        auto i = static_cast<uint32_t>(_ts.size());
+        _ts.push_back(t);
+        _val.push_back(v);
+        if (i % kBlock == 0) {
+            _blocks.push_back({t, t, v, v, i, i});
+        } else {
+            BlockInfo& b = _blocks.back();
+            b.t_last = t;
+            if (v < b.v_min) { b.v_min = v; b.i_min = i; }
+            if (v > b.v_max) { b.v_max = v; b.i_max = i; }
+        }
+        return true;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lk(_data_mtx);
+        return _ts.size();
+    }
+
+    // Queues a query for samples with t0 <= t < t1 and returns its id; the
+    // answer is pushed as a TimeSeriesResult with the same id.
+    uint64_t query(int64_t t0, int64_t t1, uint32_t max_points) {
+        uint64_t id;
+        {
+            std::lock_guard<std::mutex> lk(this->mtx);
+            id = ++_last_id;
+            _pending.push_back({id, t0, t1, max_points});
+        }
+        this->state_cv.notify_all();
+        return id;
+    }
+
+    // Body of the query thread started by FCB_EXPORT_TIME_SERIES_SYMBOLS.
+    void query_loop() {
+        for (;;) {
+            Request rq;
+            {
+                std::unique_lock<std::mutex> lk(this->mtx);
+                this->state_cv.wait(lk, [this] {
+                    return !_pending.empty() || this->stopped();
+                });
+                if (this->stopped()) return;
+                rq = _pending.front();
+                _pending.pop_front();
+            }
+            this->push(run(rq));
+        }
+    }
+
+    // Synchronous query; exposed for native callers and tests.
+    result_type run(const Request& rq) const {
+        result_type out;
+        out.id = rq.id;
+        std::shared_lock<std::shared_mutex> lk(_data_mtx);
+        if (rq.t1 <= rq.t0) return out;
+        uint32_t lo = _lower_bound(rq.t0);
+        uint32_t hi = _lower_bound(rq.t1);
+        if (lo >= hi) return out;
+
+        if (rq.max_points == 0 || hi - lo <= rq.max_points) {
+            out.times.assign(_ts.begin() + lo, _ts.begin() + hi);
+            out.values.assign(_val.begin() + lo, _val.begin() + hi);
+            return out;
+        }
+
+        // A single point cannot carry a min and a max: the newest sample.
+        if (rq.max_points == 1) {
+            out.times.push_back(_ts[hi - 1]);
+            out.values.push_back(_val[hi - 1]);
+            return out;
+        }
+
+        // Min/max decimation over equal time buckets: two points per bucket.
+        uint32_t buckets = std::max<uint32_t>(1, rq.max_points / 2);
+        out.times.reserve(2 * buckets);
+        out.values.reserve(2 * buckets);
+        long double span = static_cast<long double>(rq.t1 - rq.t0) / buckets;
+        uint32_t i = lo;
+        for (uint32_t k = 0; k < buckets && i < hi; ++k) {
+            uint32_t j = (k + 1 == buckets)
+                ? hi
+                : std::min(hi, _lower_bound(rq.t0 + static_cast<int64_t>(span * (k + 1))));
+            if (j <= i) continue;
+            uint32_t i_min, i_max;
+            _min_max(i, j, i_min, i_max);
+            uint32_t a = std::min(i_min, i_max), b = std::max(i_min, i_max);
+            out.times.push_back(_ts[a]);
+            out.values.push_back(_val[a]);
+            if (b != a) {
+                out.times.push_back(_ts[b]);
+                out.values.push_back(_val[b]);
+            }
+            i = j;
+        }
+        return out;
+    }
+
+private:
+    // First sample index with timestamp >= t: block index first, then block.
+    uint32_t _lower_bound(int64_t t) const {
+        auto blk = std::partition_point(_blocks.begin(), _blocks.end(),
+            [t](const BlockInfo& b) { return b.t_last < t; });
+        if (blk == _blocks.end()) return static_cast<uint32_t>(_ts.size());
+        size_t first = static_cast<size_t>(blk - _blocks.begin()) * kBlock;
+        size_t last  = std::min(first + kBlock, _ts.size());
+        return static_cast<uint32_t>(
+            std::lower_bound(_ts.begin() + first, _ts.begin() + last, t) - _ts.begin());
+    }
+
+    // Indices of the min and max values in [i, j), using block summaries for
+    // every block entirely contained in the range.
+    void _min_max(uint32_t i, uint32_t j, uint32_t& i_min, uint32_t& i_max) const {
+        i_min = i_max = i;
+        auto take = [&](uint32_t lo_idx, uint32_t hi_idx) {
+            if (_val[lo_idx] < _val[i_min]) i_min = lo_idx;
+            if (_val[hi_idx] > _val[i_max]) i_max = hi_idx;
+        };
+        while (i < j) {
+            uint32_t blk_end = (i / kBlock + 1) * kBlock;
+            if (i % kBlock == 0 && blk_end <= j) {
+                const BlockInfo& b = _blocks[i / kBlock];
+                take(b.i_min, b.i_max);
+                i = blk_end;
+            } else {
+                uint32_t stop = std::min(j, blk_end);
+                for (; i < stop; ++i) take(i, i);
+            }
+        }
+    }
+
+    mutable std::shared_mutex _data_mtx;
+    std::vector<int64_t>      _ts;
+    std::vector<V>            _val;
+    std::vector<BlockInfo>    _blocks;
+    std::deque<Request>       _pending;   // guarded by mtx
+    uint64_t                  _last_id = 0;
+};
+
+template<typename V>
+size_t message_bytes(const TimeSeriesResult<V>& r) noexcept {
+    return sizeof(r) + r.times.capacity() * sizeof(int64_t) + r.values.capacity() * sizeof(V);
+}
+
+} // namespace fcb
+
+// ── FCB_EXPORT_TIME_SERIES_SYMBOLS ───────────────────────────────────────────
+// Mandatory symbols for an fcb::TimeSeries<V> service plus the query API.
+// start_service() spawns both the worker (appending samples) and the query
+// thread; stop_service() ends both.
+//
+//   ts_size()                        →  uint64_t        samples stored
+//   ts_query(t0, t1, max_points)     →  uint64_t        request id
+//   ts_result_id    (msg)            →  uint64_t        id of the answered query
+//   ts_result_count (msg)            →  uint32_t        samples in the result
+//   ts_result_times (msg)            →  const int64_t*  timestamps
+//   ts_result_values(msg)            →  const void*     values (V[])
+//
+#define FCB_EXPORT_TIME_SERIES_SYMBOLS(svc, worker_fn)                              \
+    FCB_EXPORT void  start_service() {                                              \
+        (svc).mark_started();                                                       \
+        std::thread([&s = (svc)]() { worker_fn(s); }).detach();                     \
+        std::thread([&s = (svc)]() { s.query_loop(); }).detach();                   \
+    }                                                                               \
+    FCB_EXPORT void  stop_service()  { (svc).request_stop(); }                      \
+    FCB_EXPORT void* get_next_message()        { return (svc).next();    }          \
+    FCB_EXPORT void  free_message(void* p)     { (svc).release(p);       }          \
+    FCB_EXPORT void  set_message_callback(void (*cb)()) { (svc).notify_cb.store(cb, std::memory_order_release); } \
+    FCB_EXPORT void  set_consumer_active(bool active) { (svc).set_consumer(active); } \
+    FCB_EXPORT_STATS_SYMBOLS(svc)                                                   \
+    FCB_EXPORT uint64_t ts_size() { return (svc).size(); }                          \
+    FCB_EXPORT uint64_t ts_query(int64_t t0, int64_t t1, uint32_t max_points) {     \
+        return (svc).query(t0, t1, max_points);                                     \
+    }                                                                               \
+    FCB_EXPORT uint64_t ts_result_id(void* msg) {                                   \
+        return static_cast<decltype(svc)::result_type*>(msg)->id;                      \
+    }                                                                               \
+    FCB_EXPORT uint32_t ts_result_count(void* msg) {                                \
+        return static_cast<uint32_t>(                                               \
+            static_cast<decltype(svc)::result_type*>(msg)->times.size());              \
+    }                                                                               \
+    FCB_EXPORT const int64_t* ts_result_times(void* msg) {                          \
+        return static_cast<decltype(svc)::result_type*>(msg)->times.data();            \
+    }                                                                               \
+    FCB_EXPORT const void* ts_result_values(void* msg) {                            \
+        return static_cast<decltype(svc)::result_type*>(msg)->values.data();           \
+    }
@@ -0,0 +1,452 @@
+// flutter_cpp_bridge/udp_ingest.h
+//
+// UDP ingest service for devices that stream telemetry as datagrams.  Instead
+// of one recv() and one queued message per datagram, the ingest thread
+// drains the socket with recvmmsg() straight into a pooled buffer and queues
+// the whole batch as one message, with an index of the datagrams it holds.
+//
+//   • up to config.batch datagrams per system call, one buffer slot each;
+//   • optional UDP_GRO: the kernel coalesces same-flow datagrams into one
+//     slot (needs large slots, see max_datagram) and the index splits them
+//     back into datagrams;
+//   • optional SO_TIMESTAMPNS: the kernel receive time of every datagram;
+//   • optional multicast group (IPv4 or IPv6);
+//   • buffers and indexes are recycled when Dart frees the batch, so the
+//     steady state does not allocate.
+//
+// Requirements: C++17, Linux (recvmmsg; UDP_GRO needs kernel 5.0+).
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/udp_ingest.h"
+//
+//   static fcb::UdpIngest g_svc;
+//
+//   FCB_EXPORT_UDP_INGEST_SYMBOLS(g_svc)
+//
+// On the Dart side, use UdpIngestService (udp_ingest_service.dart):
+//
+//   final feed = UdpIngestService('libudp.so', port: 9000, timestamps: true);
+//   feed.assignJob((msg) {
+//     final batch = feed.batch(msg);
+//     for (var i = 0; i < batch.length; i++) handle(batch[i]);
+//   });
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef UDP_GRO
+#define UDP_GRO 104   // <linux/udp.h>; older libc headers lack it
+#endif
+
+namespace fcb {
+
+// One entry of a UdpBatch index.  Layout shared with Dart (_UdpDatagram).
+struct UdpDatagram {
+    uint32_t offset;         // into UdpBatch::data()
+    uint32_t length;
+    int64_t  timestamp_ns;   // CLOCK_REALTIME kernel receive time, 0 if off
+};
+static_assert(sizeof(UdpDatagram) == 16, "UdpDatagram layout is shared with Dart");
+
+struct UdpIngestConfig {
+    std::string address      = "0.0.0.0";  // local address to bind
+    uint16_t    port         = 0;          // 0 = ephemeral, see local_port()
+    std::string group;                     // multicast group to join, or empty
+    int         rcvbuf       = -1;         // SO_RCVBUF, -1 = system default
+    uint32_t    batch        = 64;         // datagrams per recvmmsg()
+    uint32_t    max_datagram = 2048;       // slot size; 64 KiB when gro is set
+    bool        gro          = false;
+    bool        timestamps   = false;
+};
+
+// Free list of batch storage, shared by the ingest thread (acquire) and
+// whichever thread frees a batch (recycle).  Bounded by bytes rather than by
+// count: with UDP_GRO one batch is batch × 64 KiB.
+class UdpBufferPool {
+public:
+    struct FreeBytes {
+        void operator()(uint8_t* p) const noexcept { std::free(p); }
+    };
+    struct Storage {
+        std::unique_ptr<uint8_t[], FreeBytes> bytes;
+        size_t                                size = 0;
+        std::vector<UdpDatagram>              index;
+    };
+
+    explicit UdpBufferPool(size_t max_cached_bytes = size_t(16) << 20)
+        : _max_cached(max_cached_bytes) {}
+
+    // Storage with at least `size` bytes; contents are uninitialised.
+    std::unique_ptr<Storage> acquire(size_t size) {
+        std::unique_ptr<Storage> s;
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            if (!_free.empty()) {
+                s = std::move(_free.back());
+                _free.pop_back();
+                _cached -= footprint(*s);
+            }
+        }
+        if (!s) s.reset(new Storage);
+        if (s->size < size) {
+            s->bytes.reset();   // no realloc: the old contents are not needed
+            s->bytes.reset(static_cast<uint8_t*>(std::malloc(size)));
+            if (!s->bytes) { s->size = 0; throw std::bad_alloc(); }
+            s->size = size;
+        }
+        s->index.clear();
+        return s;
+    }
+
+    // Gives the tail of s beyond `size` bytes back to the allocator when it
+    // is large enough to matter (a partial GRO batch), so neither the queue
+    // nor the memory budget holds slots that received nothing.
+    static void trim(Storage& s, size_t size) noexcept {
+        if (size == 0 || s.size - size < kTrimSlack) return;
+        if (void* p = std::realloc(s.bytes.get(), size)) {
+            (void)s.bytes.release();
+            s.bytes.reset(static_cast<uint8_t*>(p));
+            s.size = size;
+        }
+    }
+
+    void recycle(std::unique_ptr<Storage> s) noexcept {
+        std::lock_guard<std::mutex> lk(_mtx);
+        const size_t bytes = footprint(*s);
+        if (_cached + bytes > _max_cached) return;
+        _free.push_back(std::move(s));
+        _cached += bytes;
+    }
+
+    // Bytes held by s, as counted against the cache and the memory budget.
+    static size_t footprint(const Storage& s) noexcept {
+        return s.size + s.index.capacity() * sizeof(UdpDatagram);
+    }
+
+private:
+    static constexpr size_t kTrimSlack = size_t(1) << 20;
+
+    std::mutex                            _mtx;
+    std::vector<std::unique_ptr<Storage>> _free;
+    size_t                                _cached = 0;
+    size_t                                _max_cached;
+};
+
+// The datagrams of one recvmmsg() call.  Datagram i is
+// data() + index()[i].offset, index()[i].length bytes long.
+class UdpBatch {
+public:
+    UdpBatch() = default;
+    UdpBatch(UdpBufferPool* pool, std::unique_ptr<UdpBufferPool::Storage> s)
+        : _pool(pool), _s(std::move(s)) {}
+    UdpBatch(UdpBatch&&) noexcept = default;
+    UdpBatch& operator=(UdpBatch&& o) noexcept {
+        if (this != &o) { _recycle(); _pool = o._pool; _s = std::move(o._s); }
+        return *this;
+    }
+    ~UdpBatch() { _recycle(); }
+
+    size_t             size() const noexcept  { return _s ? _s->index.size() : 0; }
+    bool               empty() const noexcept { return size() == 0; }
+    const uint8_t*     data() const noexcept  { return _s ? _s->bytes.get() : nullptr; }
+    const UdpDatagram* index() const noexcept { return _s ? _s->index.data() : nullptr; }
+
+    const uint8_t* datagram(size_t i) const noexcept { return data() + index()[i].offset; }
+    size_t         length(size_t i) const noexcept   { return index()[i].length; }
+
+    size_t capacity_bytes() const noexcept {
+        return _s ? UdpBufferPool::footprint(*_s) : 0;
+    }
+
+private:
+    void _recycle() noexcept {
+        if (_s && _pool) _pool->recycle(std::move(_s));
+        _s.reset();
+    }
+
+    UdpBufferPool*                         _pool = nullptr;
+    std::unique_ptr<UdpBufferPool::Storage> _s;
+};
+
+inline size_t message_bytes(const UdpBatch& b) noexcept {
+    return sizeof(b) + b.capacity_bytes();
+}
+
+struct UdpIngest : Queue<UdpBatch> {
+    // Edited from Dart (udp_ingest_* symbols) before start_service().
+    UdpIngestConfig config;
+
+    // Optional; runs on the ingest thread.  Returning false drops the batch.
+    std::function<bool(UdpBatch&)> filter;
+
+    // Recycles batch storage once Dart frees a batch.
+    UdpBufferPool pool;
+
+    explicit UdpIngest(std::function<bool(UdpBatch&)> filter_fn = {})
+        : filter(std::move(filter_fn)) {}
+    ~UdpIngest() { close(); }
+
+    // Creates and binds the socket from config.  Called from Dart before
+    // starting so that a bad address is reported synchronously; the ingest
+    // thread calls it too if the socket is not open yet.  Returns false and
+    // sets error() on failure.
+    bool open() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_fd >= 0) return true;
+        _error.clear();
+        addrinfo hints{};
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags    = AI_PASSIVE | AI_NUMERICHOST | AI_NUMERICSERV;
+        addrinfo* ai = nullptr;
+        const std::string port = std::to_string(config.port);
+        if (int rc = getaddrinfo(config.address.c_str(), port.c_str(), &hints, &ai)) {
+            _error = "address " + config.address + ": " + gai_strerror(rc);
+            return false;
+        }
+        std::unique_ptr<addrinfo, void (*)(addrinfo*)> guard(ai, freeaddrinfo);
+        _fd = socket(ai->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (_fd < 0) return _fail("socket");
+        int on = 1;
+        setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof on);
+        if (config.rcvbuf >= 0 &&
+            setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &config.rcvbuf, sizeof(int)) != 0)
+            return _fail("SO_RCVBUF");
+        if (config.gro && setsockopt(_fd, IPPROTO_UDP, UDP_GRO, &on, sizeof on) != 0)
+            return _fail("UDP_GRO");
+        if (config.timestamps &&
+            setsockopt(_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof on) != 0)
+            return _fail("SO_TIMESTAMPNS");
+        if (bind(_fd, ai->ai_addr, ai->ai_addrlen) != 0)
+            return _fail("bind " + config.address + ":" + port);
+        if (!config.group.empty() && !_join(ai->ai_family))
+            return _fail("join " + config.group);
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    // Empty unless the last open() or ingest run failed.
+    std::string error() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _error;
+    }
+
+    // Starts a new configuration: replaces config and closes a socket left
+    // open by an earlier open().  Refused (false) while the service runs;
+    // waits for a stopping ingest thread to close its socket first.
+    bool configure(UdpIngestConfig c) {
+        if (running()) return false;
+        while (_in_run.load(std::memory_order_acquire))
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        close();
+        config = std::move(c);
+        return true;
+    }
+
+    // Bound port (useful with config.port = 0), or 0 if not open.
+    uint16_t local_port() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        sockaddr_storage ss{};
+        socklen_t len = sizeof ss;
+        if (_fd < 0 || getsockname(_fd, reinterpret_cast<sockaddr*>(&ss), &len) != 0)
+            return 0;
+        return ntohs(ss.ss_family == AF_INET6
+                         ? reinterpret_cast<sockaddr_in6*>(&ss)->sin6_port
+                         : reinterpret_cast<sockaddr_in*>(&ss)->sin_port);
+    }
+
+    // Datagrams cut short because they did not fit in a slot.
+    uint64_t truncated() const noexcept { return _truncated.load(std::memory_order_relaxed); }
+
+    // Body of the ingest thread started by FCB_EXPORT_UDP_INGEST_SYMBOLS.
+    // A socket that fails to open or to poll ends the run: the service no
+    // longer counts as running and error() keeps the reason.
+    static void run(UdpIngest& svc) {
+        svc._in_run.store(true, std::memory_order_release);
+        if (!svc.stopped() && svc.open()) svc._receive();
+        svc.close();
+        if (!svc.stopped()) svc.mark_finished();
+        svc._in_run.store(false, std::memory_order_release);
+    }
+
+private:
+    // Room for one SO_TIMESTAMPNS and one UDP_GRO control message.
+    static constexpr size_t kControlBytes =
+        CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(int));
+
+    void _receive() {
+        const uint32_t n    = std::max<uint32_t>(config.batch, 1);
+        const size_t   slot = config.gro ? std::max<size_t>(config.max_datagram, 65535)
+                                         : std::max<size_t>(config.max_datagram, 1);
+        std::vector<mmsghdr> msgs(n);
+        std::vector<iovec>   iov(n);
+        std::vector<cmsghdr> control((n * kControlBytes + sizeof(cmsghdr) - 1) / sizeof(cmsghdr));
+        auto* ctrl = reinterpret_cast<uint8_t*>(control.data());
+
+        pollfd pfd{_fd, POLLIN, 0};
+        while (!stopped()) {
+            int rc = poll(&pfd, 1, 100);
+            heartbeat();   // alive while the socket is quiet (Watchdog)
+            if (rc < 0 && errno != EINTR) {
+                std::lock_guard<std::mutex> lk(_mtx);
+                _error = std::string("poll: ") + std::strerror(errno);
+                break;
+            }
+            if (rc <= 0) continue;
+            for (;;) {   // drain what is already queued in the socket
+                auto s = pool.acquire(n * slot);
+                for (uint32_t i = 0; i < n; ++i) {
+                    iov[i] = {s->bytes.get() + i * slot, slot};
+                    msghdr& h = msgs[i].msg_hdr;
+                    h = msghdr{};
+                    h.msg_iov        = &iov[i];
+                    h.msg_iovlen     = 1;
+                    h.msg_control    = ctrl + i * kControlBytes;
+                    h.msg_controllen = kControlBytes;
+                }
+                int got = recvmmsg(_fd, msgs.data(), n, MSG_DONTWAIT, nullptr);
+                if (got <= 0) { pool.recycle(std::move(s)); break; }
+                for (int i = 0; i < got; ++i) _index(*s, msgs[i], uint32_t(i * slot));
+                if (uint32_t(got) < n) UdpBufferPool::trim(*s, size_t(got) * slot);
+                UdpBatch batch(&pool, std::move(s));
+                if (!filter || filter(batch)) push(std::move(batch));
+                if (uint32_t(got) < n) break;
+            }
+        }
+    }
+
+    // Appends the datagrams of one received slot to the index: one entry, or
+    // one per segment of a GRO-coalesced slot.
+    void _index(UdpBufferPool::Storage& s, mmsghdr& m, uint32_t offset) {
+        msghdr& h = m.msg_hdr;
+        if (h.msg_flags & MSG_TRUNC) _truncated.fetch_add(1, std::memory_order_relaxed);
+        int64_t  ts  = 0;
+        uint32_t seg = 0;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_TIMESTAMPNS) {
+                timespec t;
+                std::memcpy(&t, CMSG_DATA(c), sizeof t);
+                ts = int64_t(t.tv_sec) * 1000000000 + t.tv_nsec;
+            } else if (c->cmsg_level == IPPROTO_UDP && c->cmsg_type == UDP_GRO) {
+                int size;
+                std::memcpy(&size, CMSG_DATA(c), sizeof size);
+                seg = uint32_t(size);
+            }
+        }
+        uint32_t len = m.msg_len;
+        if (seg == 0 || seg >= len) { s.index.push_back({offset, len, ts}); return; }
+        for (uint32_t at = 0; at < len; at += seg)
+            s.index.push_back({offset + at, std::min(seg, len - at), ts});
+    }
+
+    bool _join(int family) {
+        if (family == AF_INET6) {
+            ipv6_mreq mreq{};
+            if (inet_pton(AF_INET6, config.group.c_str(), &mreq.ipv6mr_multiaddr) != 1) {
+                errno = EINVAL;
+                return false;
+            }
+            return setsockopt(_fd, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof mreq) == 0;
+        }
+        ip_mreq mreq{};
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (inet_pton(AF_INET, config.group.c_str(), &mreq.imr_multiaddr) != 1) {
+            errno = EINVAL;
+            return false;
+        }
+        return setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof mreq) == 0;
+    }
+
+    bool _fail(const std::string& what) {
+        _error = what + ": " + std::strerror(errno);
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    std::mutex            _mtx;
+    int                   _fd = -1;
+    std::string           _error;
+    std::atomic<uint64_t> _truncated{0};
+    std::atomic<bool>     _in_run{false};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_UDP_INGEST_SYMBOLS ────────────────────────────────────────────
+// Mandatory symbols for an fcb::UdpIngest service (its ingest thread is the
+// worker), the configuration API and the batch accessors:
+//
+//   udp_ingest_configure(address, port, group, rcvbuf, batch, max_datagram,
+//                        gro, timestamps)                  →  bool  false
+//                                                             while running
+//   udp_ingest_open()           →  const char*  nullptr, or the error text
+//   udp_ingest_error()          →  const char*  nullptr, or why the ingest
+//                                               thread stopped on its own
+//   udp_ingest_local_port()     →  uint16_t     bound port
+//   udp_ingest_truncated()      →  uint64_t     datagrams larger than a slot
+//   udp_batch_count(msg)        →  uint32_t     datagrams in the batch
+//   udp_batch_data(msg)         →  const uint8_t*      base of the buffer
+//   udp_batch_index(msg)        →  const UdpDatagram*  count entries
+//
+// `group` may be nullptr.  Dart reads the index in place, so walking a batch
+// costs three FFI calls whatever its size.
+//
+#define FCB_EXPORT_UDP_INGEST_SYMBOLS(svc)                                          \
+    FCB_EXPORT_SYMBOLS(svc, fcb::UdpIngest::run)                                    \
+    FCB_EXPORT bool udp_ingest_configure(const char* address, uint16_t port,        \
+                                         const char* group, int rcvbuf,             \
+                                         uint32_t batch, uint32_t max_datagram,     \
+                                         bool gro, bool timestamps) {               \
+        fcb::UdpIngestConfig fcb_cfg;                                               \
+        fcb_cfg.address      = address;                                             \
+        fcb_cfg.port         = port;                                                \
+        fcb_cfg.group        = group ? group : "";                                  \
+        fcb_cfg.rcvbuf       = rcvbuf;                                              \
+        fcb_cfg.batch        = batch;                                               \
+        fcb_cfg.max_datagram = max_datagram;                                        \
+        fcb_cfg.gro          = gro;                                                 \
+        fcb_cfg.timestamps   = timestamps;                                          \
+        return (svc).configure(std::move(fcb_cfg));                                 \
+    }                                                                               \
+    FCB_EXPORT const char* udp_ingest_open() {                                      \
+        static thread_local std::string error;                                      \
+        if ((svc).open()) return nullptr;                                           \
+        error = (svc).error();                                                      \
+        return error.c_str();                                                       \
+    }                                                                               \
+    FCB_EXPORT const char* udp_ingest_error() {                                     \
+        static thread_local std::string error;                                      \
+        error = (svc).error();                                                      \
+        return error.empty() ? nullptr : error.c_str();                             \
+    }                                                                               \
+    FCB_EXPORT uint16_t udp_ingest_local_port() { return (svc).local_port(); }      \
+    FCB_EXPORT uint64_t udp_ingest_truncated()  { return (svc).truncated();  }      \
+    FCB_EXPORT uint32_t udp_batch_count(fcb::UdpBatch* msg) {                       \
+        return static_cast<uint32_t>(msg->size());                                  \
+    }                                                                               \
+    FCB_EXPORT const uint8_t* udp_batch_data(fcb::UdpBatch* msg) { return msg->data(); } \
+    FCB_EXPORT const fcb::UdpDatagram* udp_batch_index(fcb::UdpBatch* msg) {        \
+        return msg->index();                                                        \
+    }
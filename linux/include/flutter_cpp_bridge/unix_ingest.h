@@ -0,0 +1,426 @@
+// flutter_cpp_bridge/unix_ingest.h
+//
+// Ingest from local producer processes over a UNIX SOCK_SEQPACKET socket,
+// without ZMQ and without pushing large payloads through the socket:
+//
+//   • the service listens on a path (or, with a leading '@', an abstract
+//     name) and accepts any number of producers;
+//   • small messages travel inline: one packet = one message;
+//   • a large payload travels as a memfd passed with SCM_RIGHTS.  The
+//     service maps it read-only and Dart reads the mapping zero-copy through
+//     get_msg_bytes; free_message() unmaps it.  The descriptor itself is
+//     closed as soon as it is mapped — the mapping keeps the memory alive.
+//
+// A passed memfd must carry F_SEAL_SHRINK (config.require_seals), otherwise
+// a producer could truncate it under Dart's feet and turn a read into
+// SIGBUS; unsealed descriptors, and descriptors that cannot be sealed at all
+// (not a memfd), are rejected and counted.  F_SEAL_WRITE is not required: a
+// producer still writing to the memory can only change what Dart reads, not
+// fault it, and UnixClient seals writes anyway.
+//
+// fcb::UnixClient is the producer side, used by tests and benchmarks and as
+// a reference for producers written in other languages.
+//
+// Requirements: C++17, Linux (memfd_create, sealing).
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/unix_ingest.h"
+//
+//   static fcb::UnixIngest g_svc;
+//
+//   FCB_EXPORT_UNIX_INGEST_SYMBOLS(g_svc)
+//
+//   // producer process
+//   fcb::UnixClient client;
+//   client.connect("@telemetry");
+//   client.send(bytes, len);   // inline below 64 KiB, memfd above
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fcb {
+
+// Fills a sockaddr_un; a leading '@' selects the abstract namespace.
+inline bool unix_address(const std::string& path, sockaddr_un& addr, socklen_t& len) {
+    addr = sockaddr_un{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof addr.sun_path) return false;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    if (path[0] == '@') addr.sun_path[0] = '\0';
+    len = socklen_t(offsetof(sockaddr_un, sun_path) + path.size() + (path[0] == '@' ? 0 : 1));
+    return true;
+}
+
+// One received message: inline bytes, or a read-only mapping of a passed
+// memfd (unmapped on destruction).
+class UnixMsg {
+public:
+    UnixMsg() = default;
+    explicit UnixMsg(BytesMsg bytes) : _inline(std::move(bytes)) {}
+    UnixMsg(const uint8_t* mapping, size_t len) : _map(mapping), _map_len(len) {}
+    UnixMsg(UnixMsg&& o) noexcept
+        : _inline(std::move(o._inline)), _map(o._map), _map_len(o._map_len) {
+        o._map = nullptr;
+        o._map_len = 0;
+    }
+    UnixMsg& operator=(UnixMsg&& o) noexcept {
+        if (this != &o) {
+            _unmap();
+            _inline  = std::move(o._inline);
+            _map     = o._map;
+            _map_len = o._map_len;
+            o._map = nullptr;
+            o._map_len = 0;
+        }
+        return *this;
+    }
+    UnixMsg(const UnixMsg&) = delete;
+    UnixMsg& operator=(const UnixMsg&) = delete;
+    ~UnixMsg() { _unmap(); }
+
+    const uint8_t* data() const noexcept { return _map ? _map : _inline.data(); }
+    size_t         size() const noexcept { return _map ? _map_len : _inline.size(); }
+    bool           mapped() const noexcept { return _map != nullptr; }
+
+private:
+    void _unmap() noexcept {
+        if (_map) munmap(const_cast<uint8_t*>(_map), _map_len);
+        _map = nullptr;
+    }
+
+    BytesMsg       _inline;
+    const uint8_t* _map     = nullptr;
+    size_t         _map_len = 0;
+};
+
+inline size_t message_bytes(const UnixMsg& m) noexcept {
+    return sizeof(m) + m.size();
+}
+
+struct UnixIngestConfig {
+    std::string path;                    // filesystem path or "@abstract"
+    uint32_t    max_inline    = 65536;   // largest inline packet accepted
+    bool        require_seals = true;    // passed memfds need F_SEAL_SHRINK
+};
+
+struct UnixIngest : Queue<UnixMsg> {
+    // Edited from Dart (unix_ingest_* symbols) before start_service().
+    UnixIngestConfig config;
+
+    ~UnixIngest() { close(); }
+
+    // Creates the listening socket, replacing a stale socket file (any other
+    // file at the path fails with EADDRINUSE).  Called from Dart before
+    // starting so that a bad path is reported synchronously.  Returns false
+    // and sets error() on failure.
+    bool open() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_listen >= 0) return true;
+        _error.clear();
+        sockaddr_un addr;
+        socklen_t   len;
+        if (!unix_address(config.path, addr, len)) {
+            errno = ENAMETOOLONG;
+            return _fail("path " + config.path);
+        }
+        _listen = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (_listen < 0) return _fail("socket");
+        if (config.path[0] != '@' && !_remove_stale_socket())
+            return _fail("bind " + config.path);
+        if (bind(_listen, reinterpret_cast<sockaddr*>(&addr), len) != 0)
+            return _fail("bind " + config.path);
+        if (listen(_listen, 16) != 0) return _fail("listen " + config.path);
+        return true;
+    }
+
+    // Closes the listening socket; the ingest thread closes the producer
+    // connections when it returns.
+    void close() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_listen >= 0) {
+            ::close(_listen);
+            if (config.path[0] != '@') unlink(config.path.c_str());
+        }
+        _listen = -1;
+    }
+
+    // Empty unless the last open() failed.
+    std::string error() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _error;
+    }
+
+    // Starts a new configuration: replaces config and closes (and unlinks)
+    // a socket left open by an earlier open().  Refused (false) while the
+    // service runs; waits for a stopping ingest thread to close first.
+    bool configure(UnixIngestConfig c) {
+        if (running()) return false;
+        while (_in_run.load(std::memory_order_acquire))
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        close();
+        config = std::move(c);
+        return true;
+    }
+
+    // Packets larger than max_inline, and memfds rejected (unsealed or not
+    // mappable).
+    uint64_t rejected() const noexcept { return _rejected.load(std::memory_order_relaxed); }
+
+    // Body of the ingest thread started by FCB_EXPORT_UNIX_INGEST_SYMBOLS.
+    // A socket that fails to open ends the run: the service no longer
+    // counts as running.
+    static void run(UnixIngest& svc) {
+        svc._in_run.store(true, std::memory_order_release);
+        if (!svc.stopped() && svc.open()) svc._serve();
+        svc.close();
+        if (!svc.stopped()) svc.mark_finished();
+        svc._in_run.store(false, std::memory_order_release);
+    }
+
+private:
+    void _serve() {
+        int ep = epoll_create1(EPOLL_CLOEXEC);
+        if (ep < 0) return;
+        epoll_event ev{};
+        ev.events  = EPOLLIN;
+        ev.data.fd = _listen;
+        epoll_ctl(ep, EPOLL_CTL_ADD, _listen, &ev);
+        std::vector<int>     clients;
+        std::vector<uint8_t> scratch(std::max<uint32_t>(config.max_inline, 1));
+        epoll_event events[16];
+
+        while (!stopped()) {
+            int n = epoll_wait(ep, events, 16, 100);
+            heartbeat();   // alive while the clients are quiet (Watchdog)
+            if (n < 0 && errno != EINTR) break;
+            for (int i = 0; i < n; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == _listen) {
+                    int c;
+                    while ((c = accept4(_listen, nullptr, nullptr,
+                                        SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0) {
+                        ev.events  = EPOLLIN;
+                        ev.data.fd = c;
+                        epoll_ctl(ep, EPOLL_CTL_ADD, c, &ev);
+                        clients.push_back(c);
+                    }
+                } else if (!_drain(fd, scratch)) {
+                    epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+                    ::close(fd);
+                    clients.erase(std::find(clients.begin(), clients.end(), fd));
+                }
+            }
+        }
+        for (int c : clients) ::close(c);
+        ::close(ep);
+    }
+
+    // Receives every packet queued on a producer connection.  Returns false
+    // when the producer has gone.
+    bool _drain(int fd, std::vector<uint8_t>& scratch) {
+        for (;;) {
+            iovec  iov{scratch.data(), scratch.size()};
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 4)];
+            msghdr h{};
+            h.msg_iov        = &iov;
+            h.msg_iovlen     = 1;
+            h.msg_control    = control;
+            h.msg_controllen = sizeof control;
+            ssize_t got = recvmsg(fd, &h, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+            if (got < 0) return errno == EAGAIN || errno == EINTR;
+            if (got == 0) return false;
+
+            int passed = -1;
+            for (cmsghdr* c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h, c)) {
+                if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+                const size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for (size_t k = 0; k < count; ++k) {
+                    int f;
+                    std::memcpy(&f, CMSG_DATA(c) + k * sizeof(int), sizeof f);
+                    if (passed < 0) passed = f;
+                    else            ::close(f);   // one payload per packet
+                }
+            }
+            if (passed >= 0) {
+                _push_memfd(passed);
+            } else if (h.msg_flags & MSG_TRUNC) {
+                _rejected.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                push(UnixMsg(BytesMsg(scratch.data(), scratch.data() + got)));
+            }
+        }
+    }
+
+    void _push_memfd(int fd) {
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && config.require_seals) {
+            const int seals = fcntl(fd, F_GET_SEALS);   // -1: not sealable
+            ok = seals >= 0 && (seals & F_SEAL_SHRINK) != 0;
+        }
+        void* p = MAP_FAILED;
+        if (ok && st.st_size > 0)
+            p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (!ok || (st.st_size > 0 && p == MAP_FAILED)) {
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (st.st_size == 0) push(UnixMsg());
+        else push(UnixMsg(static_cast<const uint8_t*>(p), size_t(st.st_size)));
+    }
+
+    // Unlinks a socket file left by an earlier run, so bind() can reuse
+    // the path.  Anything else at the path is not ours to delete: fails
+    // with EADDRINUSE.
+    bool _remove_stale_socket() {
+        struct stat st;
+        if (lstat(config.path.c_str(), &st) != 0) return errno == ENOENT;
+        if (!S_ISSOCK(st.st_mode)) {
+            errno = EADDRINUSE;
+            return false;
+        }
+        return unlink(config.path.c_str()) == 0 || errno == ENOENT;
+    }
+
+    bool _fail(const std::string& what) {
+        _error = what + ": " + std::strerror(errno);
+        if (_listen >= 0) ::close(_listen);
+        _listen = -1;
+        return false;
+    }
+
+    std::mutex            _mtx;
+    int                   _listen = -1;
+    std::string           _error;
+    std::atomic<uint64_t> _rejected{0};
+    std::atomic<bool>     _in_run{false};
+};
+
+// ── UnixClient ───────────────────────────────────────────────────────────────
+// Producer side of UnixIngest.
+class UnixClient {
+public:
+    // Payloads of at least this many bytes go through a memfd.
+    size_t memfd_threshold = 65536;
+
+    UnixClient() = default;
+    UnixClient(const UnixClient&) = delete;
+    UnixClient& operator=(const UnixClient&) = delete;
+    ~UnixClient() { close(); }
+
+    bool connect(const std::string& path) {
+        close();
+        sockaddr_un addr;
+        socklen_t   len;
+        if (!unix_address(path, addr, len)) { errno = ENAMETOOLONG; return false; }
+        _fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (_fd < 0) return false;
+        if (::connect(_fd, reinterpret_cast<sockaddr*>(&addr), len) != 0) { close(); return false; }
+        return true;
+    }
+
+    void close() noexcept {
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    // Inline below memfd_threshold, memfd otherwise.  Blocks while the
+    // socket buffer is full.
+    bool send(const void* data, size_t len) {
+        return len < memfd_threshold ? send_inline(data, len) : send_memfd(data, len);
+    }
+
+    bool send_inline(const void* data, size_t len) {
+        return ::send(_fd, data, len, MSG_NOSIGNAL) == ssize_t(len);
+    }
+
+    // Copies the payload into a sealed memfd and passes the descriptor.
+    bool send_memfd(const void* data, size_t len) {
+        int mfd = memfd_create("fcb-payload", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (mfd < 0) return false;
+        bool ok = ftruncate(mfd, off_t(len)) == 0;
+        if (ok && len > 0) {
+            void* p = mmap(nullptr, len, PROT_WRITE, MAP_SHARED, mfd, 0);
+            ok = p != MAP_FAILED;
+            if (ok) { std::memcpy(p, data, len); munmap(p, len); }
+        }
+        ok = ok && fcntl(mfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE) == 0;
+        ok = ok && send_fd(mfd);
+        ::close(mfd);
+        return ok;
+    }
+
+    // Passes an already-filled (and sealed) descriptor.  SEQPACKET needs at
+    // least one data byte to carry the descriptor; it is ignored.
+    bool send_fd(int fd) {
+        char marker = 0;
+        iovec iov{&marker, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        msghdr h{};
+        h.msg_iov        = &iov;
+        h.msg_iovlen     = 1;
+        h.msg_control    = control;
+        h.msg_controllen = sizeof control;
+        cmsghdr* c  = CMSG_FIRSTHDR(&h);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type  = SCM_RIGHTS;
+        c->cmsg_len   = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(c), &fd, sizeof fd);
+        return sendmsg(_fd, &h, MSG_NOSIGNAL) == 1;
+    }
+
+private:
+    int _fd = -1;
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_UNIX_INGEST_SYMBOLS ───────────────────────────────────────────
+// Mandatory symbols for an fcb::UnixIngest service (its ingest thread is the
+// worker), the byte-buffer accessors and the configuration API:
+//
+//   unix_ingest_configure(path, max_inline, require_seals)  →  bool  false
+//                                                              while running
+//   unix_ingest_open()          →  const char*  nullptr, or the error text
+//   unix_ingest_rejected()      →  uint64_t     oversized / unsealed inputs
+//   get_msg_bytes(msg) / get_msg_len(msg)       zero-copy payload
+//   unix_msg_mapped(msg)        →  bool         payload came as a memfd
+//
+#define FCB_EXPORT_UNIX_INGEST_SYMBOLS(svc)                                         \
+    FCB_EXPORT_SYMBOLS(svc, fcb::UnixIngest::run)                                   \
+    FCB_EXPORT bool unix_ingest_configure(const char* path, uint32_t max_inline,    \
+                                          bool require_seals) {                     \
+        fcb::UnixIngestConfig fcb_cfg;                                              \
+        fcb_cfg.path          = path;                                               \
+        fcb_cfg.max_inline    = max_inline;                                         \
+        fcb_cfg.require_seals = require_seals;                                      \
+        return (svc).configure(std::move(fcb_cfg));                                 \
+    }                                                                               \
+    FCB_EXPORT const char* unix_ingest_open() {                                     \
+        static thread_local std::string error;                                      \
+        if ((svc).open()) return nullptr;                                           \
+        error = (svc).error();                                                      \
+        return error.c_str();                                                       \
+    }                                                                               \
+    FCB_EXPORT uint64_t unix_ingest_rejected() { return (svc).rejected(); }         \
+    FCB_EXPORT const uint8_t* get_msg_bytes(fcb::UnixMsg* msg) { return msg->data(); } \
+    FCB_EXPORT uint32_t get_msg_len(fcb::UnixMsg* msg) {                            \
+        return static_cast<uint32_t>(msg->size());                                  \
+    }                                                                               \
+    FCB_EXPORT bool unix_msg_mapped(fcb::UnixMsg* msg) { return msg->mapped(); }
@@ -0,0 +1,261 @@
+// flutter_cpp_bridge/watchdog.h
+//
+// Process-wide watchdog raising stalled-consumer and stuck-worker alarms on
+// the services that opt in (fcb::watchdog()), and the symbols that let Dart
+// set the limits (Service.watch).  The inputs are kept up to date by every
+// ServiceBase, so only libraries that watch a service include this header.
+//
+// Requirements: C++17; libdl (link with ${CMAKE_DL_LIBS} on glibc older
+// than 2.34), through fcb::process_instance().
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/watchdog.h"
+//
+//   static fcb::Queue<my_msg_t> g_svc;
+//
+//   FCB_EXPORT_SYMBOLS(g_svc, worker)
+//   FCB_EXPORT_WATCHDOG_SYMBOLS(g_svc)
+//
+// On the Dart side, call Service.watch (service.dart).
+//
+
+#pragma once
+#include "process_shared.h"
+#include "service_helpers.h"
+#include "service_registry.h"
+
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+
+namespace fcb {
+
+// ── Watchdog ─────────────────────────────────────────────────────────────────
+// Process-wide thread that raises alarms on two failure modes, per service:
+//
+//   kStalledConsumer  Dart has a job assigned and messages are pending, but
+//                     has taken none for stall_ms
+//   kStuckWorker      Dart has a job assigned, but the worker has neither
+//                     pushed nor called heartbeat() for heartbeat_ms
+//
+// Services opt in with a limit per alarm (0 disables it), from C++ or from
+// Dart (FCB_EXPORT_WATCHDOG_SYMBOLS, Service.watch):
+//
+//   fcb::watchdog().watch(g_svc, /*stall_ms=*/2000, /*heartbeat_ms=*/5000);
+//   fcb::watchdog().on_alarm(g_svc, [](const fcb::WatchdogEvent& e) {
+//       std::fprintf(stderr, "%s: alarms %x\n", e.name.c_str(), e.alarms);
+//   });
+//
+// The services keep the inputs up to date themselves (a coarse clock read
+// and a store per push and per next()); a scan reads a handful of relaxed
+// atomics per watched service, every period (250 ms by default).  Raised
+// alarms are stored in the service's `alarms`, which Dart reads through
+// ServiceStats, and each change is passed to the service's callback.
+enum WatchdogAlarm : uint32_t {
+    kStalledConsumer = 1u << 0,
+    kStuckWorker     = 1u << 1,
+};
+
+// Passed to a Watchdog callback when the alarms of a service change.
+struct WatchdogEvent {
+    const ServiceBase* service;
+    std::string        name;            // as given to watch()
+    uint32_t           alarms;          // now raised
+    uint32_t           raised;          // of those, new since the last scan
+    uint64_t           pending;
+    int64_t            drain_idle_ms;
+    int64_t            beat_idle_ms;
+};
+
+using WatchdogCallback = std::function<void(const WatchdogEvent&)>;
+
+class Watchdog final : public ServiceWatcher {
+public:
+    static constexpr uint32_t kDefaultPeriodMs = 250;
+
+    Watchdog() = default;
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+    ~Watchdog() {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _quit = true;
+            for (Entry& e : _entries) e.svc->watcher.store(nullptr, std::memory_order_relaxed);
+        }
+        _cv.notify_all();
+        if (_thread.joinable()) _thread.join();
+    }
+
+    // Sets the limits of svc, in ms (0 disables an alarm), keeping its
+    // callback.  name defaults to the service's registered name, or else to
+    // the path of the library holding it.  The thread starts on first use.
+    void watch(ServiceBase& svc, uint32_t stall_ms, uint32_t heartbeat_ms,
+               std::string name = {}) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        Entry& e = _entry(svc);
+        e.stall_ms     = stall_ms;
+        e.heartbeat_ms = heartbeat_ms;
+        if (!name.empty()) e.name = std::move(name);
+        if (!_thread.joinable()) _thread = std::thread([this] { _run(); });
+    }
+
+    // Called, on the watchdog thread, whenever the alarms of svc change.
+    // It runs under the watchdog's lock so that svc cannot be destroyed
+    // meanwhile: keep it short, and do not call back into the Watchdog.
+    void on_alarm(ServiceBase& svc, WatchdogCallback cb) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _entry(svc).callback = std::move(cb);
+    }
+
+    // Forgets svc and clears its alarms; services do it when destroyed.
+    void unwatch(ServiceBase& svc) override {
+        std::lock_guard<std::mutex> lk(_mtx);
+        auto it = std::find_if(_entries.begin(), _entries.end(),
+                               [&](const Entry& e) { return e.svc == &svc; });
+        if (it == _entries.end()) return;
+        svc.alarms.store(0, std::memory_order_relaxed);
+        svc.watcher.store(nullptr, std::memory_order_relaxed);
+        _entries.erase(it);
+    }
+
+    void set_period(uint32_t ms) {
+        { std::lock_guard<std::mutex> lk(_mtx); _period_ms = std::max<uint32_t>(ms, 1); }
+        _cv.notify_all();
+    }
+
+    // One pass over the watched services, as run by the thread every period;
+    // returns how many have an alarm raised.
+    size_t scan() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _scan_locked();
+    }
+
+    // The watched services with an alarm raised, as of the last scan.
+    std::vector<WatchdogEvent> alarmed() const {
+        std::lock_guard<std::mutex> lk(_mtx);
+        std::vector<WatchdogEvent> out;
+        for (const Entry& e : _entries)
+            if (uint32_t a = e.svc->alarms.load(std::memory_order_relaxed))
+                out.push_back(_event(e, a, 0, coarse_now_ns()));
+        return out;
+    }
+
+private:
+    struct Entry {
+        ServiceBase*     svc = nullptr;
+        std::string      name;
+        uint32_t         stall_ms     = 0;
+        uint32_t         heartbeat_ms = 0;
+        WatchdogCallback callback;
+    };
+
+    Entry& _entry(ServiceBase& svc) {
+        for (Entry& e : _entries)
+            if (e.svc == &svc) return e;
+        Entry e;
+        e.svc = &svc;
+        for (const ServiceInfo& s : registry().list())
+            if (s.base == &svc) e.name = s.name;
+        Dl_info dl{};
+        if (e.name.empty() && dladdr(&svc, &dl) && dl.dli_fname) e.name = dl.dli_fname;
+        svc.watcher.store(this, std::memory_order_relaxed);
+        _entries.push_back(std::move(e));
+        return _entries.back();
+    }
+
+    static WatchdogEvent _event(const Entry& e, uint32_t alarms, uint32_t raised, int64_t now) {
+        const ServiceBase& s = *e.svc;
+        return {&s, e.name, alarms, raised,
+                s.pending.load(std::memory_order_relaxed),
+                (now - s.last_drain_ns.load(std::memory_order_relaxed)) / 1000000,
+                (now - s.last_beat()) / 1000000};
+    }
+
+    size_t _scan_locked() {
+        const int64_t now = coarse_now_ns();
+        size_t n = 0;
+        for (const Entry& e : _entries) {
+            ServiceBase& s = *e.svc;
+            uint32_t a = 0;
+            if (s.running() && s.has_consumer()) {
+                if (e.stall_ms && s.pending.load(std::memory_order_relaxed) &&
+                    now - s.last_drain_ns.load(std::memory_order_relaxed) > int64_t(e.stall_ms) * 1000000)
+                    a |= kStalledConsumer;
+                if (e.heartbeat_ms && now - s.last_beat() > int64_t(e.heartbeat_ms) * 1000000)
+                    a |= kStuckWorker;
+            }
+            const uint32_t was = s.alarms.exchange(a, std::memory_order_relaxed);
+            if (a) ++n;
+            if (a != was && e.callback) e.callback(_event(e, a, a & ~was, now));
+        }
+        return n;
+    }
+
+    void _run() {
+        std::unique_lock<std::mutex> lk(_mtx);
+        while (!_quit) {
+            _cv.wait_for(lk, std::chrono::milliseconds(_period_ms));
+            if (!_quit) _scan_locked();
+        }
+    }
+
+    mutable std::mutex      _mtx;
+    std::condition_variable _cv;
+    std::vector<Entry>      _entries;
+    uint32_t                _period_ms = kDefaultPeriodMs;
+    bool                    _quit      = false;
+    std::thread             _thread;
+};
+
+} // namespace fcb
+
+// Candidate instances (see fcb::process_instance()).  The watchdog thread
+// runs in the library whose instance is adopted, which process_instance()
+// pins.  The watchdog reads the services it watches, so its symbol carries
+// FCB_SERVICE_LAYOUT.
+FCB_EXPORT __attribute__((used)) inline void* FCB_LAYOUT_SYMBOL(fcb_watchdog_v1)() {
+    static fcb::Watchdog* w = new fcb::Watchdog;   // never destroyed
+    return w;
+}
+
+namespace fcb {
+
+// The process-wide watchdog.
+inline Watchdog& watchdog() {
+    static Watchdog* const instance = static_cast<Watchdog*>(process_instance(
+        FCB_SYMBOL_NAME(FCB_LAYOUT_SYMBOL(fcb_watchdog_v1)), FCB_LAYOUT_SYMBOL(fcb_watchdog_v1)));
+    return *instance;
+}
+
+// set_watchdog from Dart: 0, 0 unwatches, without starting the watchdog if
+// the service was never watched.
+inline void watch_service(ServiceBase& svc, uint32_t stall_ms, uint32_t heartbeat_ms) {
+    if (stall_ms || heartbeat_ms)
+        watchdog().watch(svc, stall_ms, heartbeat_ms);
+    else if (ServiceWatcher* w = svc.watcher.load(std::memory_order_relaxed))
+        w->unwatch(svc);
+}
+
+
+} // namespace fcb
+
+
+// ── FCB_EXPORT_WATCHDOG_SYMBOLS ──────────────────────────────────────────────
+// set_watchdog(stall_ms, heartbeat_ms), which Service.watch binds: the
+// limits of fcb::watchdog().watch(svc, …); 0, 0 stops watching.
+//
+// FCB_EXPORT_CHANNEL_WATCHDOG_SYMBOLS exports the same for every channel of
+// an FCB_EXPORT_CHANNEL_SYMBOLS library, as channel_set_watchdog(ch, …);
+// channel_of is the same expression.
+//
+#define FCB_EXPORT_WATCHDOG_SYMBOLS(svc)                                            \
+    FCB_EXPORT void set_watchdog(uint32_t stall_ms, uint32_t heartbeat_ms) {        \
+        fcb::watch_service(svc, stall_ms, heartbeat_ms);                            \
+    }
+
+#define FCB_EXPORT_CHANNEL_WATCHDOG_SYMBOLS(channel_of)                             \
+    FCB_EXPORT void channel_set_watchdog(uint32_t ch, uint32_t stall_ms, uint32_t heartbeat_ms) { \
+        fcb::watch_service(channel_of(ch), stall_ms, heartbeat_ms);                 \
+    }
@@ -0,0 +1,206 @@
+// flutter_cpp_bridge/zmq_demux.h
+//
+// Topic demultiplexer: one ZMQ socket and one reader thread feeding many
+// per-consumer queues ("channels"), each bound in Dart as its own Service.
+// Fifteen topics from one publisher then cost one socket, one thread and
+// one kernel copy instead of fifteen of each.
+//
+// Routing is either
+//   • by prefix of the first frame (the SUB topic), one prefix per channel,
+//     declared from Dart — the socket subscribes to exactly those prefixes;
+//     a message matching several channels reaches each of them, sharing the
+//     frame buffers (zmq_msg_copy) rather than copying them; or
+//   • by a native router returning the channel index (e.g. a FlatBuffers
+//     payload_type switch) for a fixed number of channels.
+//
+// The reader runs while at least one channel is started; a channel that is
+// not started receives nothing.
+//
+// Requirements: C++17, libzmq (see zmq_ingest.h).
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/zmq_demux.h"
+//
+//   // Prefix routing, channels declared from Dart:
+//   static fcb::ZmqDemux g_hub;
+//
+//   // …or native routing into 3 channels:
+//   static fcb::ZmqDemux g_hub{3, [](const fcb::ZmqBatch& b) {
+//       return int(payload_type(b)) - 1;       // -1 drops the message
+//   }};
+//
+//   FCB_EXPORT_ZMQ_DEMUX_SYMBOLS(g_hub)
+//
+// On the Dart side, use ZmqDemux (zmq_ingest_service.dart).
+//
+
+#pragma once
+#include "zmq_ingest.h"
+
+#include <memory>
+
+namespace fcb {
+
+class ZmqDemux {
+public:
+    using Channel = Queue<ZmqBatch>;
+    // Channel index for a batch; out of range (e.g. -1) drops it.
+    using Router  = std::function<int(const ZmqBatch&)>;
+
+    // Edited from Dart (zmq_demux_* symbols) before open().
+    ZmqIngestConfig config;
+
+    explicit ZmqDemux(uint32_t channels = 0, Router router = {})
+        : _router(std::move(router)) {
+        for (uint32_t i = 0; i < channels; ++i) _add();
+    }
+
+    ~ZmqDemux() {
+        _quit.store(true, std::memory_order_relaxed);
+        if (_reader.joinable()) _reader.join();
+    }
+
+    ZmqDemux(const ZmqDemux&) = delete;
+    ZmqDemux& operator=(const ZmqDemux&) = delete;
+
+    // Starts a new configuration: config.reset(), and for prefix routing
+    // the channel list too (natively routed channels are fixed).  Refused
+    // (false) while a channel is started.  Dropped channels are kept, not
+    // destroyed, as Dart may still hold their messages.
+    bool configure(int type, int rcvhwm, int rcvbuf, bool conflate) {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        if (_active > 0) return false;
+        if (_reader.joinable()) _reader.join();   // previous reader, stopping
+        _rx.close();
+        config.reset(type, rcvhwm, rcvbuf, conflate);
+        if (!_router) {
+            for (auto& ch : _channels) _retired.push_back(std::move(ch));
+            _channels.clear();
+            _prefixes.clear();
+        }
+        return true;
+    }
+
+    // Adds a channel receiving messages whose first frame starts with prefix
+    // ("" = everything) and subscribes the socket to it.  Only valid before
+    // open(); returns the channel index, or UINT32_MAX while a channel is
+    // started (the reader walks the channel list).
+    uint32_t add_channel(std::string prefix) {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        if (_active > 0) return UINT32_MAX;
+        if (_reader.joinable()) _reader.join();
+        config.topics.push_back(prefix);
+        _prefixes.resize(_channels.size());
+        _prefixes.push_back(std::move(prefix));
+        return _add();
+    }
+
+    uint32_t size() const noexcept { return static_cast<uint32_t>(_channels.size()); }
+    Channel& channel(uint32_t i) noexcept { return *_channels[i]; }
+
+    bool open() { return _rx.open(config); }
+    std::string error() { return _rx.error(); }
+
+    // Starts one channel; the first one started launches the reader.
+    void start_channel(uint32_t i) {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        Channel& ch = channel(i);
+        if (!ch.stopped()) return;
+        ch.mark_started();
+        if (_active++ > 0) return;
+        if (_reader.joinable()) _reader.join();   // previous reader, stopping
+        _quit.store(false, std::memory_order_relaxed);
+        _reader = std::thread([this] { _run(); });
+    }
+
+    // Stops one channel; the last one stopped ends the reader (which closes
+    // the socket within its 100 ms poll interval).
+    void stop_channel(uint32_t i) {
+        std::lock_guard<std::mutex> lk(_life_mtx);
+        Channel& ch = channel(i);
+        if (ch.stopped()) return;
+        ch.request_stop();
+        if (--_active == 0) _quit.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    uint32_t _add() {
+        _channels.emplace_back(new Channel);
+        _channels.back()->stop_flag.store(true, std::memory_order_relaxed);
+        return size() - 1;
+    }
+
+    void _run() {
+        if (!_rx.open(config)) return;
+        // The channel list cannot change while a channel is started.
+        _rx.run([this] { return _quit.load(std::memory_order_relaxed); },
+                [this](ZmqBatch&& batch) { _route(std::move(batch)); },
+                [this] { for (auto& ch : _channels) ch->heartbeat(); });
+        _rx.close();
+    }
+
+    void _route(ZmqBatch&& batch) {
+        if (_router) {
+            int i = _router(batch);
+            if (i >= 0 && uint32_t(i) < size() && !channel(i).stopped())
+                channel(i).push(std::move(batch));
+            return;
+        }
+        // Every matching channel gets the message; the last one takes the
+        // original, the others a shared reference.
+        int last = -1;
+        for (uint32_t i = 0; i < _prefixes.size(); ++i) {
+            if (channel(i).stopped() || !batch.has_prefix(_prefixes[i])) continue;
+            if (last >= 0) channel(last).push(batch.share());
+            last = int(i);
+        }
+        if (last >= 0) channel(last).push(std::move(batch));
+    }
+
+    Router                                _router;
+    std::vector<std::string>              _prefixes;
+    std::vector<std::unique_ptr<Channel>> _channels;
+    std::vector<std::unique_ptr<Channel>> _retired;   // see configure()
+    ZmqReceiver                           _rx;
+
+    std::mutex        _life_mtx;
+    unsigned          _active = 0;
+    std::atomic<bool> _quit{false};
+    std::thread       _reader;
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_ZMQ_DEMUX_SYMBOLS ─────────────────────────────────────────────
+// FCB_EXPORT_CHANNEL_SYMBOLS for the hub's channels, the batch accessors of
+// FCB_EXPORT_ZMQ_BATCH_SYMBOLS, and the configuration API:
+//
+//   zmq_demux_configure(type, rcvhwm, rcvbuf, conflate)  →  bool  false while
+//                                      running; clears endpoints and channels
+//   zmq_demux_add_endpoint(address, bind)                →  void
+//   zmq_demux_add_channel(prefix, len)  →  uint32_t     channel index, or
+//                                                       UINT32_MAX if running
+//   zmq_demux_channel_count()           →  uint32_t
+//   zmq_demux_open()                    →  const char*  nullptr, or the error
+//
+#define FCB_EXPORT_ZMQ_DEMUX_SYMBOLS(hub)                                           \
+    FCB_EXPORT_CHANNEL_SYMBOLS((hub).channel, (hub).start_channel, (hub).stop_channel) \
+    FCB_EXPORT_ZMQ_BATCH_SYMBOLS()                                                  \
+    FCB_EXPORT bool zmq_demux_configure(int type, int rcvhwm, int rcvbuf,           \
+                                        bool conflate) {                            \
+        return (hub).configure(type, rcvhwm, rcvbuf, conflate);                     \
+    }                                                                               \
+    FCB_EXPORT void zmq_demux_add_endpoint(const char* address, bool bind) {        \
+        (hub).config.endpoints.push_back({address, bind});                          \
+    }                                                                               \
+    FCB_EXPORT uint32_t zmq_demux_add_channel(const uint8_t* prefix, uint32_t len) { \
+        return (hub).add_channel(std::string(reinterpret_cast<const char*>(prefix), len)); \
+    }                                                                               \
+    FCB_EXPORT uint32_t zmq_demux_channel_count() { return (hub).size(); }          \
+    FCB_EXPORT const char* zmq_demux_open() {                                       \
+        static thread_local std::string error;                                      \
+        if ((hub).open()) return nullptr;                                           \
+        error = (hub).error();                                                      \
+        return error.c_str();                                                       \
+    }
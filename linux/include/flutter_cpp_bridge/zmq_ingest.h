@@ -0,0 +1,368 @@
+// flutter_cpp_bridge/zmq_ingest.h
+//
+// Reusable ZMQ ingest service: a SUB, PULL or DISH socket whose endpoints,
+// subscriptions and receive options are set from Dart before the service is
+// started, so each feed can be tuned for throughput or latency without
+// recompiling.
+//
+//   • several endpoints, each connected or bound;
+//   • SUB topic prefixes / DISH groups (DISH needs a libzmq built with the
+//     draft API);
+//   • ZMQ_RCVHWM, ZMQ_RCVBUF, and ZMQ_CONFLATE for latest-only feeds
+//     (libzmq ignores CONFLATE for multipart messages);
+//   • every ZMQ message — all frames of a multipart message — is delivered
+//     as one fcb::ZmqBatch that keeps the frames in their zmq_msg_t, so Dart
+//     reads them zero-copy until free_message().
+//
+// The ingest thread is provided: the service only declares the instance,
+// optionally with a filter that runs on the ingest thread before a batch is
+// queued (routing, validation, note_ingest_seq() …).
+//
+// Requirements: C++17, libzmq (C API, <zmq.h>; see README, "CMake — ZMQ").
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/zmq_ingest.h"
+//
+//   static fcb::ZmqIngest g_svc;
+//
+//   FCB_EXPORT_ZMQ_INGEST_SYMBOLS(g_svc)
+//
+// On the Dart side, use ZmqIngestService (zmq_ingest_service.dart):
+//
+//   ZmqIngestService('libfeed.so',
+//       endpoints: ['tcp://10.0.0.2:5556'], topics: ['imu.'],
+//       receiveHighWaterMark: 10000);
+//
+
+#pragma once
+#include "service_helpers.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <zmq.h>
+
+namespace fcb {
+
+// One received ZMQ message.  Frames stay in their zmq_msg_t (a std::deque
+// never relocates them); the last frame is the payload, earlier frames are
+// envelopes such as a topic.
+class ZmqBatch {
+public:
+    ZmqBatch() = default;
+    ZmqBatch(ZmqBatch&& o) noexcept : _frames(std::move(o._frames)) { o._frames.clear(); }
+    ZmqBatch& operator=(ZmqBatch&& o) noexcept {
+        if (this != &o) { _close(); _frames = std::move(o._frames); o._frames.clear(); }
+        return *this;
+    }
+    ZmqBatch(const ZmqBatch&) = delete;
+    ZmqBatch& operator=(const ZmqBatch&) = delete;
+    ~ZmqBatch() { _close(); }
+
+    size_t size() const noexcept { return _frames.size(); }
+    bool   empty() const noexcept { return _frames.empty(); }
+
+    const uint8_t* data(size_t i) const noexcept {
+        return static_cast<const uint8_t*>(zmq_msg_data(const_cast<zmq_msg_t*>(&_frames[i])));
+    }
+    size_t frame_size(size_t i) const noexcept {
+        return zmq_msg_size(const_cast<zmq_msg_t*>(&_frames[i]));
+    }
+    size_t bytes() const noexcept {
+        size_t n = 0;
+        for (size_t i = 0; i < _frames.size(); ++i) n += frame_size(i);
+        return n;
+    }
+
+    // Another reference to the same frames: zmq_msg_copy() shares the
+    // payload buffers (reference-counted) instead of copying them.
+    ZmqBatch share() const {
+        ZmqBatch out;
+        for (const auto& f : _frames) {
+            zmq_msg_t& g = out._frames.emplace_back();
+            zmq_msg_init(&g);
+            zmq_msg_copy(&g, const_cast<zmq_msg_t*>(&f));
+        }
+        return out;
+    }
+
+    // True if the first frame (the topic for SUB sockets) starts with prefix.
+    bool has_prefix(const std::string& prefix) const noexcept {
+        return !_frames.empty() && frame_size(0) >= prefix.size() &&
+               std::memcmp(data(0), prefix.data(), prefix.size()) == 0;
+    }
+
+    // Receives all frames of the next message.  Returns false (batch empty)
+    // on EAGAIN or error; errno as left by zmq_msg_recv().
+    bool recv(void* sock, int flags) {
+        _close();
+        for (;;) {
+            zmq_msg_t& f = _frames.emplace_back();
+            zmq_msg_init(&f);
+            if (zmq_msg_recv(&f, sock, flags) < 0) { _close(); return false; }
+            if (!zmq_msg_more(&f)) return true;
+            flags &= ~ZMQ_DONTWAIT;   // the remaining frames are already here
+        }
+    }
+
+private:
+    void _close() noexcept {
+        for (auto& f : _frames) zmq_msg_close(&f);
+        _frames.clear();
+    }
+
+    std::deque<zmq_msg_t> _frames;
+};
+
+inline size_t message_bytes(const ZmqBatch& b) noexcept {
+    return sizeof(b) + b.bytes();
+}
+
+struct ZmqIngestConfig {
+    struct Endpoint {
+        std::string address;
+        bool        bind = false;
+    };
+    int                      type     = ZMQ_SUB;   // ZMQ_SUB, ZMQ_PULL or ZMQ_DISH
+    std::vector<Endpoint>    endpoints;
+    std::vector<std::string> topics;               // SUB prefixes / DISH groups
+    int                      rcvhwm   = -1;        // -1 = libzmq default
+    int                      rcvbuf   = -1;
+    bool                     conflate = false;
+
+    // Sets the socket options and clears the endpoint and topic lists, so a
+    // wrapper configured again does not inherit the previous one's.
+    void reset(int type_, int rcvhwm_, int rcvbuf_, bool conflate_) {
+        *this    = ZmqIngestConfig{};
+        type     = type_;
+        rcvhwm   = rcvhwm_;
+        rcvbuf   = rcvbuf_;
+        conflate = conflate_;
+    }
+};
+
+// Socket half shared by ZmqIngest and ZmqDemux: creates the socket from a
+// ZmqIngestConfig and runs the receive loop.
+class ZmqReceiver {
+public:
+    ZmqReceiver() = default;
+    ZmqReceiver(const ZmqReceiver&) = delete;
+    ZmqReceiver& operator=(const ZmqReceiver&) = delete;
+    ~ZmqReceiver() { close(); }
+
+    // No-op if already open.  Returns false and sets error() on failure.
+    bool open(const ZmqIngestConfig& config) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_sock) return true;
+        _error.clear();
+        _ctx  = zmq_ctx_new();
+        _sock = _ctx ? zmq_socket(_ctx, config.type) : nullptr;
+        if (!_sock) return _fail("socket");
+        int linger = 0;
+        zmq_setsockopt(_sock, ZMQ_LINGER, &linger, sizeof linger);
+        if (config.rcvhwm >= 0 &&
+            zmq_setsockopt(_sock, ZMQ_RCVHWM, &config.rcvhwm, sizeof(int)) != 0)
+            return _fail("ZMQ_RCVHWM");
+        if (config.rcvbuf >= 0 &&
+            zmq_setsockopt(_sock, ZMQ_RCVBUF, &config.rcvbuf, sizeof(int)) != 0)
+            return _fail("ZMQ_RCVBUF");
+        if (config.conflate) {
+            int on = 1;
+            if (zmq_setsockopt(_sock, ZMQ_CONFLATE, &on, sizeof on) != 0)
+                return _fail("ZMQ_CONFLATE");
+        }
+        for (const auto& t : config.topics) {
+            if (config.type == ZMQ_SUB) {
+                if (zmq_setsockopt(_sock, ZMQ_SUBSCRIBE, t.data(), t.size()) != 0)
+                    return _fail("subscribe " + t);
+            }
+#ifdef ZMQ_DISH
+            else if (config.type == ZMQ_DISH) {
+                if (zmq_join(_sock, t.c_str()) != 0) return _fail("join " + t);
+            }
+#endif
+        }
+        for (const auto& ep : config.endpoints) {
+            int rc = ep.bind ? zmq_bind(_sock, ep.address.c_str())
+                             : zmq_connect(_sock, ep.address.c_str());
+            if (rc != 0) return _fail((ep.bind ? "bind " : "connect ") + ep.address);
+        }
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _close_locked();
+    }
+
+    // Empty unless the last open() or run() failed.  A copy: the owning
+    // thread may set it while Dart reads.
+    std::string error() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _error;
+    }
+
+    // Receive loop for an open socket, on the thread that will own it.
+    // Polls with a short timeout so that stop() is noticed, then drains
+    // everything already queued in the socket into sink(ZmqBatch&&).
+    // beat() runs after every poll, so that the services fed keep their
+    // heartbeat while the socket is quiet.
+    template<typename Stop, typename Sink, typename Beat>
+    void run(Stop stop, Sink sink, Beat beat) {
+        zmq_pollitem_t item{_sock, 0, ZMQ_POLLIN, 0};
+        while (!stop()) {
+            int rc = zmq_poll(&item, 1, 100);
+            beat();   // alive while the socket is quiet (Watchdog)
+            if (rc < 0 && zmq_errno() != EINTR) {
+                std::lock_guard<std::mutex> lk(_mtx);
+                _error = std::string("poll: ") + zmq_strerror(zmq_errno());
+                break;
+            }
+            if (rc <= 0) continue;
+            for (;;) {
+                ZmqBatch batch;
+                if (!batch.recv(_sock, ZMQ_DONTWAIT)) break;
+                sink(std::move(batch));
+            }
+        }
+    }
+
+private:
+    bool _fail(const std::string& what) {
+        _error = what + ": " + zmq_strerror(zmq_errno());
+        _close_locked();
+        return false;
+    }
+    void _close_locked() noexcept {
+        if (_sock) zmq_close(_sock);
+        if (_ctx)  zmq_ctx_term(_ctx);
+        _sock = _ctx = nullptr;
+    }
+
+    std::mutex  _mtx;
+    void*       _ctx  = nullptr;
+    void*       _sock = nullptr;
+    std::string _error;
+};
+
+struct ZmqIngest : Queue<ZmqBatch> {
+    // Edited from Dart (zmq_ingest_* symbols) before start_service().
+    ZmqIngestConfig config;
+
+    // Optional; runs on the ingest thread.  Returning false drops the batch.
+    std::function<bool(ZmqBatch&)> filter;
+
+    explicit ZmqIngest(std::function<bool(ZmqBatch&)> filter_fn = {})
+        : filter(std::move(filter_fn)) {}
+
+    // Creates the socket from config.  Called from Dart before starting so
+    // that a bad endpoint is reported synchronously; the ingest thread calls
+    // it too if the socket is not open yet.  Returns false and sets error()
+    // on failure.
+    bool open() { return _rx.open(config); }
+
+    // Empty unless the last open() or ingest run failed.
+    std::string error() { return _rx.error(); }
+
+    // Starts a new configuration: config.reset() plus closing a socket left
+    // open by an earlier open().  Refused (false) while the service runs;
+    // waits for a stopping ingest thread to close its socket first.
+    bool configure(int type, int rcvhwm, int rcvbuf, bool conflate) {
+        if (running()) return false;
+        while (_in_run.load(std::memory_order_acquire))
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        _rx.close();
+        config.reset(type, rcvhwm, rcvbuf, conflate);
+        return true;
+    }
+
+    // Body of the ingest thread started by FCB_EXPORT_ZMQ_INGEST_SYMBOLS.
+    // A socket that fails to open or to poll ends the run: the service no
+    // longer counts as running and error() keeps the reason.
+    static void run(ZmqIngest& svc) {
+        svc._in_run.store(true, std::memory_order_release);
+        if (!svc.stopped() && svc.open()) {
+            svc._rx.run([&svc] { return svc.stopped(); },
+                        [&svc](ZmqBatch&& batch) {
+                            if (!svc.filter || svc.filter(batch)) svc.push(std::move(batch));
+                        },
+                        [&svc] { svc.heartbeat(); });
+        }
+        svc._rx.close();
+        if (!svc.stopped()) svc.mark_finished();
+        svc._in_run.store(false, std::memory_order_release);
+    }
+
+private:
+    ZmqReceiver       _rx;
+    std::atomic<bool> _in_run{false};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_ZMQ_INGEST_SYMBOLS ────────────────────────────────────────────
+// Mandatory symbols for an fcb::ZmqIngest service (its ingest thread is the
+// worker), the configuration API and the batch accessors:
+//
+//   zmq_ingest_configure(type, rcvhwm, rcvbuf, conflate)  →  bool  false while
+//                                      running; clears endpoints and topics
+//   zmq_ingest_add_endpoint(address, bind)                →  void
+//   zmq_ingest_add_topic(bytes, len)                      →  uint32_t  index
+//   zmq_ingest_open()              →  const char*  nullptr, or the error text
+//   zmq_ingest_error()             →  const char*  nullptr, or why the ingest
+//                                                  thread stopped on its own
+//   zmq_ingest_frame_count(msg)    →  uint32_t     frames in the batch
+//   zmq_ingest_frame_data(msg, i)  →  const uint8_t*
+//   zmq_ingest_frame_size(msg, i)  →  uint32_t
+//
+// get_msg_bytes / get_msg_len return the last (payload) frame, so byte-buffer
+// Dart wrappers keep working.
+//
+#define FCB_EXPORT_ZMQ_INGEST_SYMBOLS(svc)                                          \
+    FCB_EXPORT_SYMBOLS(svc, fcb::ZmqIngest::run)                                    \
+    FCB_EXPORT bool zmq_ingest_configure(int type, int rcvhwm, int rcvbuf,          \
+                                         bool conflate) {                           \
+        return (svc).configure(type, rcvhwm, rcvbuf, conflate);                     \
+    }                                                                               \
+    FCB_EXPORT void zmq_ingest_add_endpoint(const char* address, bool bind) {       \
+        (svc).config.endpoints.push_back({address, bind});                          \
+    }                                                                               \
+    FCB_EXPORT uint32_t zmq_ingest_add_topic(const uint8_t* bytes, uint32_t len) {  \
+        (svc).config.topics.emplace_back(reinterpret_cast<const char*>(bytes), len); \
+        return static_cast<uint32_t>((svc).config.topics.size() - 1);               \
+    }                                                                               \
+    FCB_EXPORT const char* zmq_ingest_open() {                                      \
+        static thread_local std::string error;                                      \
+        if ((svc).open()) return nullptr;                                           \
+        error = (svc).error();                                                      \
+        return error.c_str();                                                       \
+    }                                                                               \
+    FCB_EXPORT const char* zmq_ingest_error() {                                     \
+        static thread_local std::string error;                                      \
+        error = (svc).error();                                                      \
+        return error.empty() ? nullptr : error.c_str();                             \
+    }                                                                               \
+    FCB_EXPORT_ZMQ_BATCH_SYMBOLS()
+
+// ── FCB_EXPORT_ZMQ_BATCH_SYMBOLS ─────────────────────────────────────────────
+// Accessors for fcb::ZmqBatch messages (see FCB_EXPORT_ZMQ_INGEST_SYMBOLS);
+// included by the ZMQ export macros.
+//
+#define FCB_EXPORT_ZMQ_BATCH_SYMBOLS()                                              \
+    FCB_EXPORT uint32_t zmq_ingest_frame_count(fcb::ZmqBatch* msg) {                \
+        return static_cast<uint32_t>(msg->size());                                  \
+    }                                                                               \
+    FCB_EXPORT const uint8_t* zmq_ingest_frame_data(fcb::ZmqBatch* msg, uint32_t i) { \
+        return msg->data(i);                                                        \
+    }                                                                               \
+    FCB_EXPORT uint32_t zmq_ingest_frame_size(fcb::ZmqBatch* msg, uint32_t i) {     \
+        return static_cast<uint32_t>(msg->frame_size(i));                           \
+    }                                                                               \
+    FCB_EXPORT const uint8_t* get_msg_bytes(fcb::ZmqBatch* msg) {                   \
+        return msg->data(msg->size() - 1);                                          \
+    }                                                                               \
+    FCB_EXPORT uint32_t get_msg_len(fcb::ZmqBatch* msg) {                           \
+        return static_cast<uint32_t>(msg->frame_size(msg->size() - 1));             \
+    }
@@ -0,0 +1,349 @@
+// flutter_cpp_bridge/zmq_publish.h
+//
+// Outbound ZMQ: Dart publishes commands and state to external processes
+// through FFI instead of a platform channel.
+//
+//   • Dart reserves a buffer from a native pool (zmq_publish_reserve), writes
+//     the message into it in place, and hands it back with zmq_publish_send;
+//   • the buffer is queued to a dedicated sender thread, so the UI thread
+//     never touches the socket;
+//   • the sender passes the buffer to zmq_msg_init_data(): libzmq takes
+//     ownership and returns it to the pool when transmitted — no copy after
+//     Dart has written it.
+//
+// The queue is bounded (config.max_queued): a full queue rejects new
+// messages instead of blocking Dart.  A multipart message (parts sent with
+// `more`) is accepted or rejected as a whole: its parts are held back until
+// the last one arrives, and dropped if a reserve() for the next part fails.
+//
+// Requirements: C++17, libzmq (see zmq_ingest.h).
+//
+// ─── Example ────────────────────────────────────────────────────────────────
+//
+//   #include "flutter_cpp_bridge/zmq_publish.h"
+//
+//   static fcb::ZmqPublisher g_pub;
+//
+//   FCB_EXPORT_ZMQ_PUBLISH_SYMBOLS(g_pub)
+//
+// On the Dart side, use ZmqPublisherService (zmq_publisher_service.dart).
+//
+
+#pragma once
+#include "zmq_ingest.h"
+
+#include <cstdlib>
+
+namespace fcb {
+
+class ZmqPublisher {
+public:
+    struct Config {
+        using Endpoint = ZmqIngestConfig::Endpoint;
+        int                   type       = ZMQ_PUB;   // ZMQ_PUB, ZMQ_PUSH or ZMQ_RADIO
+        std::vector<Endpoint> endpoints;
+        int                   sndhwm     = -1;        // -1 = libzmq default
+        int                   sndbuf     = -1;
+        size_t                max_queued = 4096;      // parts waiting for the sender
+    };
+
+    // Edited from Dart (zmq_publish_* symbols) before open().
+    Config config;
+
+    ZmqPublisher() = default;
+    ZmqPublisher(const ZmqPublisher&) = delete;
+    ZmqPublisher& operator=(const ZmqPublisher&) = delete;
+    ~ZmqPublisher() {
+        stop();
+        for (auto& bucket : _free)
+            for (Header* h : bucket) std::free(h);
+    }
+
+    // Creates the socket; returns false and sets error() on failure.
+    bool open() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_sock) return true;
+        _error.clear();
+        _ctx  = zmq_ctx_new();
+        _sock = _ctx ? zmq_socket(_ctx, config.type) : nullptr;
+        if (!_sock) return _fail("socket");
+        int linger = 0, timeout = 100;   // lets stop() interrupt a blocked PUSH
+        zmq_setsockopt(_sock, ZMQ_LINGER, &linger, sizeof linger);
+        zmq_setsockopt(_sock, ZMQ_SNDTIMEO, &timeout, sizeof timeout);
+        if (config.sndhwm >= 0 &&
+            zmq_setsockopt(_sock, ZMQ_SNDHWM, &config.sndhwm, sizeof(int)) != 0)
+            return _fail("ZMQ_SNDHWM");
+        if (config.sndbuf >= 0 &&
+            zmq_setsockopt(_sock, ZMQ_SNDBUF, &config.sndbuf, sizeof(int)) != 0)
+            return _fail("ZMQ_SNDBUF");
+        for (const auto& ep : config.endpoints) {
+            int rc = ep.bind ? zmq_bind(_sock, ep.address.c_str())
+                             : zmq_connect(_sock, ep.address.c_str());
+            if (rc != 0) return _fail((ep.bind ? "bind " : "connect ") + ep.address);
+        }
+        return true;
+    }
+
+    const std::string& error() const noexcept { return _error; }
+
+    // Replaces the options and clears the endpoint list, so a wrapper
+    // configured again does not inherit the previous one's.  Refused (false)
+    // while the sender runs; closes a socket left open by open().
+    bool configure(int type, int sndhwm, int sndbuf, size_t max_queued) {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_sender.joinable()) return false;
+        _close();
+        config            = Config{};
+        config.type       = type;
+        config.sndhwm     = sndhwm;
+        config.sndbuf     = sndbuf;
+        config.max_queued = max_queued;
+        _drop_message();
+        return true;
+    }
+
+    // Whether start() ran and stop() did not.
+    bool running() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        return _sender.joinable();
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_sender.joinable()) return;
+        _quit.store(false, std::memory_order_relaxed);
+        _sender = std::thread([this] { _run(); });
+    }
+
+    // Joins the sender (undelivered messages are dropped) and closes the
+    // socket.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            _quit.store(true, std::memory_order_relaxed);
+        }
+        _cv.notify_all();
+        if (_sender.joinable()) _sender.join();
+        std::lock_guard<std::mutex> lk(_mtx);
+        for (Item& it : _queue) recycle(it.data);
+        _queue.clear();
+        _drop_message();
+        _close();
+    }
+
+    // A buffer of at least n bytes, from the pool when possible.  Give it
+    // back with send() or recycle().
+    // Returns nullptr above the largest bucket (2 GiB) or when out of memory;
+    // a multipart message in progress is then dropped, so the next part
+    // sent starts a new message.
+    uint8_t* reserve(size_t n) {
+        if (n > (size_t(1) << (kBuckets - 1))) return _reserve_failed();
+        const uint32_t b = _bucket(n);
+        Header* h = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(_pool_mtx);
+            if (!_free[b].empty()) { h = _free[b].back(); _free[b].pop_back(); }
+        }
+        if (!h) {
+            h = static_cast<Header*>(std::malloc(sizeof(Header) + (size_t(1) << b)));
+            if (!h) return _reserve_failed();
+            h->owner  = this;
+            h->bucket = b;
+        }
+        return reinterpret_cast<uint8_t*>(h + 1);
+    }
+
+    void recycle(uint8_t* data) noexcept {
+        if (!data) return;
+        Header* h = reinterpret_cast<Header*>(data) - 1;
+        std::lock_guard<std::mutex> lk(_pool_mtx);
+        if (_free[h->bucket].size() < kMaxCached) _free[h->bucket].push_back(h);
+        else std::free(h);
+    }
+
+    // Queues len bytes of a reserve()d buffer, taking ownership in all
+    // cases.  `more` marks a part followed by further parts of the same
+    // message.  Returns false if the message was rejected (queue full, not
+    // open, or an earlier part was rejected).
+    bool send(uint8_t* data, size_t len, bool more) {
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            const bool continuation = _in_message;
+            if (continuation) ok = !_rejecting;
+            else              ok = _sock && _queue.size() < config.max_queued;
+            _in_message = more;
+            _rejecting  = more && !ok;
+            if (ok && more) {
+                _parts.push_back({data, len, more});
+                return true;               // queued with the last part
+            }
+            if (ok) {
+                _queue.insert(_queue.end(), _parts.begin(), _parts.end());
+                _parts.clear();
+                _queue.push_back({data, len, more});
+            }
+        }
+        if (!ok) {
+            recycle(data);
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _cv.notify_one();
+        return true;
+    }
+
+    // Convenience for callers holding the bytes elsewhere: one copy into a
+    // pooled buffer, then send().
+    bool send_copy(const void* bytes, size_t len, bool more) {
+        uint8_t* buf = reserve(len);
+        if (!buf) return false;
+        std::memcpy(buf, bytes, len);
+        return send(buf, len, more);
+    }
+
+    uint64_t sent() const noexcept    { return _sent.load(std::memory_order_relaxed); }
+    uint64_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(16) Header {
+        ZmqPublisher* owner;
+        uint32_t      bucket;
+    };
+    struct Item {
+        uint8_t* data;
+        size_t   len;
+        bool     more;
+    };
+    static constexpr uint32_t kMinBucket = 6;    // 64-byte buffers
+    static constexpr uint32_t kBuckets   = 32;
+    static constexpr size_t   kMaxCached = 64;   // per bucket
+
+    static uint32_t _bucket(size_t n) noexcept {
+        uint32_t b = kMinBucket;
+        while ((size_t(1) << b) < n && b + 1 < kBuckets) ++b;
+        return b;
+    }
+
+    static void _release(void* data, void* /*hint*/) {
+        Header* h = static_cast<Header*>(data) - 1;
+        h->owner->recycle(static_cast<uint8_t*>(data));
+    }
+
+    void _run() {
+        std::deque<Item> batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(_mtx);
+                _cv.wait(lk, [this] { return !_queue.empty() || _quit; });
+                if (_quit.load(std::memory_order_relaxed)) return;
+                batch.swap(_queue);
+            }
+            for (size_t i = 0; i < batch.size(); ++i) {
+                Item& it = batch[i];
+                if (_quit.load(std::memory_order_relaxed)) {
+                    // stop(): drop the rest rather than wait ZMQ_SNDTIMEO each
+                    recycle(it.data);
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                zmq_msg_t msg;
+                zmq_msg_init_data(&msg, it.data, it.len, &ZmqPublisher::_release, nullptr);
+                int rc;
+                while ((rc = zmq_msg_send(&msg, _sock, it.more ? ZMQ_SNDMORE : 0)) < 0 &&
+                       zmq_errno() == EAGAIN && !_quit.load(std::memory_order_relaxed)) {
+                    // PUSH with no peer: retry every ZMQ_SNDTIMEO until stop()
+                }
+                if (rc < 0) {
+                    zmq_msg_close(&msg);   // returns the buffer to the pool
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _sent.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            batch.clear();
+        }
+    }
+
+    uint8_t* _reserve_failed() {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _drop_message();
+        return nullptr;
+    }
+
+    // Drops the parts of an unfinished message.  Under _mtx.
+    void _drop_message() noexcept {
+        for (Item& it : _parts) recycle(it.data);
+        _dropped.fetch_add(_parts.size(), std::memory_order_relaxed);
+        _parts.clear();
+        _in_message = _rejecting = false;
+    }
+
+    bool _fail(const std::string& what) {
+        _error = what + ": " + zmq_strerror(zmq_errno());
+        _close();
+        return false;
+    }
+
+    void _close() noexcept {   // under _mtx
+        if (_sock) zmq_close(_sock);
+        if (_ctx)  zmq_ctx_term(_ctx);
+        _sock = _ctx = nullptr;
+    }
+
+    std::mutex              _mtx;        // socket, queue and lifecycle
+    std::condition_variable _cv;
+    std::deque<Item>        _queue;
+    std::vector<Item>       _parts;                // current message, held to its end
+    std::atomic<bool>       _quit{false};          // written under _mtx
+    bool                    _in_message = false;   // last part had `more`
+    bool                    _rejecting  = false;   // current message rejected
+    std::thread             _sender;
+    void*                   _ctx  = nullptr;
+    void*                   _sock = nullptr;
+    std::string             _error;
+
+    std::mutex            _pool_mtx;
+    std::vector<Header*>  _free[kBuckets];
+
+    std::atomic<uint64_t> _sent{0};
+    std::atomic<uint64_t> _dropped{0};
+};
+
+} // namespace fcb
+
+// ── FCB_EXPORT_ZMQ_PUBLISH_SYMBOLS ───────────────────────────────────────────
+// Standalone-service symbols (start_service / stop_service run the sender
+// thread) plus the publishing API:
+//
+//   service_running()                →  bool         sender thread up
+//   zmq_publish_configure(type, sndhwm, sndbuf, max_queued)  →  bool  false
+//                                   while running; clears the endpoints
+//   zmq_publish_add_endpoint(address, bind)                  →  void
+//   zmq_publish_open()               →  const char*  nullptr, or the error
+//   zmq_publish_reserve(size)        →  uint8_t*     pooled buffer, or nullptr
+//   zmq_publish_recycle(buf)         →  void         unused reservation
+//   zmq_publish_send(buf, len, more) →  bool         takes ownership of buf
+//   zmq_publish_sent()               →  uint64_t
+//   zmq_publish_dropped()            →  uint64_t
+//
+#define FCB_EXPORT_ZMQ_PUBLISH_SYMBOLS(pub)                                         \
+    FCB_EXPORT_STANDALONE((pub).start, (pub).stop)                                  \
+    FCB_EXPORT bool service_running() { return (pub).running(); }                   \
+    FCB_EXPORT bool zmq_publish_configure(int type, int sndhwm, int sndbuf,         \
+                                          uint32_t max_queued) {                    \
+        return (pub).configure(type, sndhwm, sndbuf, max_queued);                   \
+    }                                                                               \
+    FCB_EXPORT void zmq_publish_add_endpoint(const char* address, bool bind) {      \
+        (pub).config.endpoints.push_back({address, bind});                          \
+    }                                                                               \
+    FCB_EXPORT const char* zmq_publish_open() {                                     \
+        return (pub).open() ? nullptr : (pub).error().c_str();                      \
+    }                                                                               \
+    FCB_EXPORT uint8_t* zmq_publish_reserve(uint32_t size) { return (pub).reserve(size); } \
+    FCB_EXPORT void zmq_publish_recycle(uint8_t* buf) { (pub).recycle(buf); }       \
+    FCB_EXPORT bool zmq_publish_send(uint8_t* buf, uint32_t len, bool more) {       \
+        return (pub).send(buf, len, more);                                          \
+    }                                                                               \
+    FCB_EXPORT uint64_t zmq_publish_sent()    { return (pub).sent();    }           \
+    FCB_EXPORT uint64_t zmq_publish_dropped() { return (pub).dropped(); }
@@ -0,0 +1,136 @@
+// fcb::Bus: fan-out, subscriptions racing publishers, sink reuse, and the
+// BusBridge channels.
+#include "flutter_cpp_bridge/bus.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Counts the allocations made while `counting` is set on the thread.
+namespace {
+thread_local bool counting = false;
+std::atomic<int>  allocations{0};
+} // namespace
+
+void* operator new(std::size_t n) {
+    if (counting) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+TEST(Bus, DeliversOneSharedMessageToEverySubscriber) {
+    fcb::Bus bus;
+    fcb::BusTopic& topic = bus.topic("a/b");
+    EXPECT_EQ(&bus.topic("a/b"), &topic);
+    EXPECT_FALSE(topic.has_subscribers());
+
+    std::vector<const uint8_t*> seen;
+    fcb::BusSubscription one = topic.subscribe([&](const fcb::BusMessage& m) {
+        seen.push_back(m.data());
+    });
+    fcb::BusSubscription two = topic.subscribe([&](const fcb::BusMessage& m) {
+        EXPECT_EQ(*m.as<int>(), 42);
+        seen.push_back(m.data());
+    });
+    EXPECT_EQ(topic.subscribers(), 2u);
+    EXPECT_EQ(topic.publish_value(42), 2u);
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0], seen[1]);   // one buffer, not a copy each
+
+    one.reset();
+    EXPECT_FALSE(one);
+    EXPECT_EQ(topic.publish_value(42), 1u);
+    two = fcb::BusSubscription();
+    EXPECT_EQ(topic.publish_value(42), 0u);
+    EXPECT_EQ(topic.published(), 3u);
+    EXPECT_EQ(bus.topics(), (std::vector<std::string>{"a/b"}));
+}
+
+TEST(Bus, RefusesSubscribersBeyondTheSlots) {
+    fcb::Bus bus;
+    fcb::BusTopic& topic = bus.topic("full");
+    std::vector<fcb::BusSubscription> subs;
+    for (uint32_t i = 0; i < fcb::BusTopic::kMaxSubscribers; ++i) {
+        subs.push_back(topic.subscribe([](const fcb::BusMessage&) {}));
+        ASSERT_TRUE(subs.back());
+    }
+    EXPECT_FALSE(topic.subscribe([](const fcb::BusMessage&) {}));
+    subs.pop_back();
+    EXPECT_TRUE(topic.subscribe([](const fcb::BusMessage&) {}));
+}
+
+TEST(Bus, ReusesTheSinksOfEndedSubscriptions) {
+    fcb::Bus bus;
+    fcb::BusTopic& topic = bus.topic("churn");
+    int got = 0;
+    topic.subscribe([&got](const fcb::BusMessage&) { ++got; }).reset();
+
+    counting = true;
+    for (int i = 0; i < 1000; ++i) {
+        fcb::BusSubscription sub = topic.subscribe([&got](const fcb::BusMessage&) { ++got; });
+        ASSERT_TRUE(sub);
+    }
+    counting = false;
+    EXPECT_EQ(allocations.load(), 0);
+    EXPECT_EQ(topic.subscribers(), 0u);
+}
+
+TEST(Bus, UnsubscribeRacingPublishersIsFinal) {
+    // Once reset() returns, the callback is never entered again, even with
+    // publishers running on other threads and the sink reused.
+    fcb::Bus bus;
+    fcb::BusTopic& topic = bus.topic("race");
+    std::atomic<bool> stop{false};
+    std::atomic<int>  late{0};
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < 3; ++t) {
+        publishers.emplace_back([&topic, &stop, t] {
+            while (!stop.load(std::memory_order_relaxed)) topic.publish_value(t);
+        });
+    }
+
+    fcb::BusSubscription keep = topic.subscribe([](const fcb::BusMessage&) {});
+    for (int i = 0; i < 2000; ++i) {
+        auto ended = std::make_shared<std::atomic<bool>>(false);
+        std::atomic<int> calls{0};
+        fcb::BusSubscription sub = topic.subscribe([ended, &calls, &late](const fcb::BusMessage&) {
+            if (ended->load()) late.fetch_add(1);
+            calls.fetch_add(1);
+        });
+        ASSERT_TRUE(sub);
+        if (i % 100 == 0)
+            for (int spin = 0; calls.load() == 0 && spin < 1000; ++spin) std::this_thread::yield();
+        sub.reset();
+        ended->store(true);   // `calls` goes out of scope next
+    }
+    stop = true;
+    for (std::thread& t : publishers) t.join();
+    EXPECT_EQ(late.load(), 0);
+    EXPECT_EQ(topic.subscribers(), 1u);
+}
+
+TEST(BusBridge, SubscribesAChannelWhileItIsStarted) {
+    fcb::Bus bus;
+    fcb::BusBridge bridge(&bus);
+    const uint32_t ch = bridge.add("x");
+    EXPECT_EQ(ch, 0u);
+    EXPECT_EQ(bridge.publish("x", "stopped", 7), 0u);
+
+    ASSERT_TRUE(bridge.start_channel(ch));
+    EXPECT_EQ(bridge.publish("x", "hello", 5), 1u);
+    void* p = bridge.channel(ch).next();
+    ASSERT_NE(p, nullptr);
+    const auto* m = static_cast<fcb::BusMessage*>(p);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(m->data()), m->size()), "hello");
+    bridge.channel(ch).release(p);
+
+    bridge.stop_channel(ch);
+    EXPECT_EQ(bridge.publish("x", "gone", 4), 0u);
+    EXPECT_FALSE(bridge.topic(ch).has_subscribers());
+}
@@ -0,0 +1,92 @@
+// fcb::CurrentValue: coalescing, double buffering while Dart holds the
+// value, and the notification owed on release().
+#include "flutter_cpp_bridge/service_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+int g_notified = 0;
+void count_notify() { ++g_notified; }
+
+} // namespace
+
+TEST(CurrentValue, HandsOutTheLatestValueOnce) {
+    fcb::CurrentValue<int> cv;
+    EXPECT_EQ(cv.next(), nullptr);
+    cv.set(1);
+    cv.set(2);
+    void* p = cv.next();
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(*static_cast<int*>(p), 2);
+    EXPECT_EQ(cv.seq_of(p), 2u);
+    EXPECT_EQ(cv.next(), nullptr);
+    cv.release(p);
+    EXPECT_EQ(cv.next(), nullptr);
+}
+
+TEST(CurrentValue, SetWhileHeldDoesNotTouchTheHeldValue) {
+    fcb::CurrentValue<std::string> cv;
+    cv.set(std::string(64, 'a'));
+    auto* held = static_cast<std::string*>(cv.next());
+    ASSERT_NE(held, nullptr);
+
+    cv.set(std::string(64, 'b'));          // e.g. while an async job awaits
+    cv.set(std::string(64, 'c'));
+    EXPECT_EQ(*held, std::string(64, 'a'));
+    EXPECT_EQ(cv.next(), nullptr);         // still out
+
+    cv.release(held);
+    auto* p = static_cast<std::string*>(cv.next());
+    ASSERT_NE(p, nullptr);
+    EXPECT_NE(p, held);
+    EXPECT_EQ(*p, std::string(64, 'c'));
+    cv.set(std::string(64, 'd'));
+    EXPECT_EQ(*p, std::string(64, 'c'));
+    cv.release(p);
+    p = static_cast<std::string*>(cv.next());
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(*p, std::string(64, 'd'));
+    cv.release(p);
+}
+
+TEST(CurrentValue, ReleaseNotifiesWhenANewerValueWaits) {
+    fcb::CurrentValue<int> cv;
+    cv.notify_cb = count_notify;
+    g_notified = 0;
+    cv.set(1);
+    void* p = cv.next();
+    cv.release(p);
+    EXPECT_EQ(g_notified, 1);              // nothing newer: no extra call
+
+    cv.set(2);
+    p = cv.next();
+    cv.set(3);                             // its notification finds it out
+    EXPECT_EQ(cv.next(), nullptr);
+    EXPECT_EQ(g_notified, 3);
+    cv.release(p);
+    EXPECT_EQ(g_notified, 4);              // owed one
+    p = cv.next();
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(*static_cast<int*>(p), 3);
+    cv.release(p);
+}
+
+TEST(History, ReleaseNotifiesWhenPushedWhileHeld) {
+    fcb::History<int> h(4);
+    h.notify_cb = count_notify;
+    g_notified = 0;
+    h.push(1);
+    void* t = h.next();
+    h.push(2);
+    EXPECT_EQ(*static_cast<uint64_t*>(t), 1u);   // stable while held
+    h.release(t);
+    EXPECT_EQ(g_notified, 3);
+    t = h.next();
+    ASSERT_NE(t, nullptr);
+    EXPECT_EQ(*static_cast<uint64_t*>(t), 2u);
+    h.release(t);
+    EXPECT_EQ(g_notified, 3);
+}
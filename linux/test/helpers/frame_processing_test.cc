@@ -0,0 +1,109 @@
+// fcb::frame: SIMD colour conversion against the scalar reference, crops.
+#include "flutter_cpp_bridge/frame_processing.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+
+// A w × h 4:2:0 image in `layout` with random planes and odd strides.
+struct TestImage {
+    std::vector<uint8_t> y, u, v;
+    fcb::frame::YuvImage img;
+
+    TestImage(fcb::frame::YuvLayout layout, uint32_t w, uint32_t h,
+              uint32_t seed) {
+        std::mt19937 rng(seed);
+        auto fill = [&](std::vector<uint8_t>& p, size_t n) {
+            p.resize(n);
+            for (auto& b : p) b = uint8_t(rng());
+        };
+        uint32_t cw = (w + 1) / 2, ch = (h + 1) / 2;
+        img.layout   = layout;
+        img.width    = w;
+        img.height   = h;
+        img.y_stride = w + 3;
+        fill(y, size_t(img.y_stride) * h);
+        if (layout == fcb::frame::YuvLayout::I420) {
+            img.uv_stride = cw + 5;
+            fill(u, size_t(img.uv_stride) * ch);
+            fill(v, size_t(img.uv_stride) * ch);
+            img.v = v.data();
+        } else {
+            img.uv_stride = cw * 2 + 5;
+            fill(u, size_t(img.uv_stride) * ch);
+        }
+        img.y = y.data();
+        img.u = u.data();
+    }
+};
+
+const fcb::frame::YuvLayout kLayouts[] = {
+    fcb::frame::YuvLayout::I420,
+    fcb::frame::YuvLayout::NV12,
+    fcb::frame::YuvLayout::NV21,
+};
+
+} // namespace
+
+TEST(FrameProcessing, SimdMatchesScalarOnOddWidthsAndTails) {
+    for (auto layout : kLayouts) {
+        for (uint32_t w = 1; w <= 41; ++w) {
+            for (uint32_t h : {1u, 2u, 3u, 7u}) {
+                TestImage t(layout, w, h, w * 31 + h);
+                uint32_t stride = w * 4;
+                std::vector<uint8_t> simd(size_t(stride) * h, 0xAA);
+                std::vector<uint8_t> ref(size_t(stride) * h, 0x55);
+                fcb::frame::yuv_to_rgba(t.img, simd.data(), stride);
+                fcb::frame::yuv_to_rgba_scalar(t.img, ref.data(), stride);
+                ASSERT_EQ(simd, ref) << fcb::frame::simd_path()
+                                     << " layout " << int(layout)
+                                     << " " << w << "x" << h;
+            }
+        }
+    }
+}
+
+TEST(FrameProcessing, TiledConversionMatchesScalar) {
+    fcb::frame::TilePool pool(3);
+    for (auto layout : kLayouts) {
+        TestImage t(layout, 77, 101, 7);
+        uint32_t stride = 77 * 4 + 8;
+        std::vector<uint8_t> tiled(size_t(stride) * 101, 0);
+        std::vector<uint8_t> ref(size_t(stride) * 101, 0);
+        fcb::frame::yuv_to_rgba(t.img, tiled.data(), stride, &pool);
+        fcb::frame::yuv_to_rgba_scalar(t.img, ref.data(), stride);
+        EXPECT_EQ(tiled, ref) << "layout " << int(layout);
+    }
+}
+
+TEST(FrameProcessing, CropKeepsChromaAligned) {
+    TestImage t(fcb::frame::YuvLayout::NV12, 33, 19, 3);
+    fcb::frame::YuvImage c = fcb::frame::crop(t.img, {5, 3, 100, 100});
+    EXPECT_EQ(c.width, 29u);                  // x rounded down to 4
+    EXPECT_EQ(c.height, 17u);                 // y rounded down to 2
+    std::vector<uint8_t> got(size_t(c.width) * 4 * c.height);
+    std::vector<uint8_t> all(size_t(t.img.width) * 4 * t.img.height);
+    fcb::frame::yuv_to_rgba(c, got.data(), c.width * 4);
+    fcb::frame::yuv_to_rgba_scalar(t.img, all.data(), t.img.width * 4);
+    for (uint32_t row = 0; row < c.height; ++row)
+        ASSERT_EQ(0, std::memcmp(got.data() + size_t(row) * c.width * 4,
+                                 all.data() + (size_t(row + 2) * t.img.width + 4) * 4,
+                                 size_t(c.width) * 4)) << "row " << row;
+}
+
+TEST(FrameProcessing, PipelineEmptyCropClearsTheFrame) {
+    TestImage t(fcb::frame::YuvLayout::I420, 16, 16, 1);
+    fcb::FrameMsg out;
+    fcb::frame::Pipeline full({{}, 8, 8, 1});
+    full.process(t.img, out);
+    ASSERT_EQ(out.pixels.size(), 8u * 8u * 4u);
+
+    fcb::frame::Pipeline outside({{32, 32, 8, 8}, 8, 8, 1});
+    outside.process(t.img, out);
+    EXPECT_EQ(out.width, 0u);
+    EXPECT_EQ(out.height, 0u);
+    EXPECT_EQ(out.stride, 0u);
+    EXPECT_TRUE(out.pixels.empty());
+}
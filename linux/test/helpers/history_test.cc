@@ -0,0 +1,55 @@
+// fcb::History: ring windows, zero-copy views and coalesced ticks.
+#include "flutter_cpp_bridge/service_helpers.h"
+
+#include <gtest/gtest.h>
+
+TEST(History, ZeroCapacityKeepsTheLatestSample) {
+    fcb::History<int> h(0);
+    EXPECT_EQ(h.capacity(), 1u);
+    h.push(1);
+    h.push(2);
+    int out[2] = {};
+    EXPECT_EQ(h.read_range(0, 2, out), 1u);
+    EXPECT_EQ(out[0], 2);
+    fcb::History<int>::View v = h.view(0, 2);
+    EXPECT_EQ(v.first_count + v.second_count, 1u);
+    EXPECT_EQ(v.first_seq, 1u);
+}
+
+TEST(History, ReadsAWindowAcrossTheWrap) {
+    fcb::History<int> h(4);
+    for (int i = 0; i < 6; ++i) h.push(i);
+    EXPECT_EQ(h.begin_seq(), 2u);
+    EXPECT_EQ(h.end_seq(), 6u);
+
+    int out[4] = {};
+    EXPECT_EQ(h.read_range(0, 4, out), 4u);   // clamped to begin_seq()
+    EXPECT_EQ(out[0], 2);
+    EXPECT_EQ(out[3], 5);
+
+    fcb::History<int>::View v = h.view(3, 10);
+    EXPECT_EQ(v.first_seq, 3u);
+    EXPECT_EQ(v.first_count, 1u);             // seq 3 sits at the ring's end
+    EXPECT_EQ(v.second_count, 2u);
+    EXPECT_EQ(v.first[0], 3);
+    EXPECT_EQ(v.second[0], 4);
+    EXPECT_EQ(v.second[1], 5);
+    EXPECT_EQ(h.read_range(6, 4, out), 0u);
+}
+
+TEST(History, CoalescesTicks) {
+    fcb::History<int> h(8);
+    h.push(1);
+    h.push(2);
+    void* t = h.next();
+    ASSERT_NE(t, nullptr);
+    EXPECT_EQ(*static_cast<uint64_t*>(t), 2u);
+    EXPECT_EQ(h.next(), nullptr);             // one tick out at a time
+    h.release(t);
+    EXPECT_EQ(h.next(), nullptr);             // nothing new since
+    h.push(3);
+    t = h.next();
+    ASSERT_NE(t, nullptr);
+    EXPECT_EQ(h.seq_of(t), 3u);
+    h.release(t);
+}
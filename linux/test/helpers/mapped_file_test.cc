@@ -0,0 +1,87 @@
+// fcb::MappedFile: view() bounds, including the empty file, which has no
+// mapping at all.
+#include "flutter_cpp_bridge/mapped_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+std::string temp_file(const std::string& bytes) {
+    char tmpl[] = "/tmp/fcb_mapped_file_XXXXXX";
+    const int fd = mkstemp(tmpl);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(::write(fd, bytes.data(), bytes.size()), ssize_t(bytes.size()));
+    ::close(fd);
+    return tmpl;
+}
+
+} // namespace
+
+TEST(MappedFile, ViewsInsideTheFileOnly) {
+    const std::string path = temp_file("0123456789");
+    fcb::MappedFile file;
+    file.config.path = path;
+    EXPECT_EQ(file.view(0, 0), nullptr);   // not open yet
+    ASSERT_TRUE(file.open()) << file.error();
+    ASSERT_EQ(file.size(), 10u);
+
+    const uint8_t* p = file.view(3, 4);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(p), 4), "3456");
+    EXPECT_NE(file.view(10, 0), nullptr);
+    EXPECT_EQ(file.view(8, 3), nullptr);
+    EXPECT_EQ(file.view(11, 0), nullptr);
+
+    file.stop();
+    EXPECT_EQ(file.view(0, 1), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(MappedFile, EmptyFileHasAnEmptyView) {
+    const std::string path = temp_file("");
+    fcb::MappedFile file;
+    file.config.path = path;
+    ASSERT_TRUE(file.open()) << file.error();
+    EXPECT_EQ(file.size(), 0u);
+    EXPECT_NE(file.view(0, 0), nullptr);
+    EXPECT_EQ(file.view(0, 1), nullptr);
+    EXPECT_EQ(file.view(1, 0), nullptr);
+
+    file.stop();
+    EXPECT_EQ(file.view(0, 0), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(MappedFile, ConfigureMapsTheNewPath) {
+    const std::string first  = temp_file("first");
+    const std::string second = temp_file("second!");
+    fcb::MappedFile file;
+    fcb::MappedFileConfig config;
+    config.path = first;
+    ASSERT_TRUE(file.configure(config));
+    ASSERT_TRUE(file.open()) << file.error();
+    ASSERT_EQ(file.size(), 5u);
+
+    // Mapped but not started: the old mapping is dropped, not served again.
+    config.path = second;
+    ASSERT_TRUE(file.configure(config));
+    EXPECT_EQ(file.view(0, 0), nullptr);
+    ASSERT_TRUE(file.open()) << file.error();
+    ASSERT_EQ(file.size(), 7u);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(file.view(0, 7)), 7), "second!");
+
+    // Running: views may be held, so the mapping stays as it is.
+    file.start();
+    config.path = first;
+    EXPECT_FALSE(file.configure(config));
+    EXPECT_EQ(file.config.path, second);
+    EXPECT_EQ(file.size(), 7u);
+    file.stop();
+    EXPECT_TRUE(file.configure(config));
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
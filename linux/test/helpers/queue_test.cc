@@ -0,0 +1,219 @@
+// fcb::Queue: out-of-order release, MemoryPolicy eviction, lazy TTL expiry
+// and sequence / ingest-gap accounting.
+#include "flutter_cpp_bridge/service_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+int take(fcb::Queue<int>& q) {
+    void* p = q.next();
+    EXPECT_NE(p, nullptr);
+    if (!p) return -1;
+    int v = *static_cast<int*>(p);
+    q.release(p);
+    return v;
+}
+
+} // namespace
+
+TEST(Queue, DeliversInOrderAndReleasesInAnyOrder) {
+    fcb::Queue<int> q;
+    for (int i = 0; i < 4; ++i) q.push(i);
+    EXPECT_EQ(q.bytes_held.load(), int64_t(4 * sizeof(int)));
+
+    void* a = q.next();
+    void* b = q.next();
+    void* c = q.next();
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(*static_cast<int*>(a), 0);
+    EXPECT_EQ(*static_cast<int*>(b), 1);
+    EXPECT_EQ(*static_cast<int*>(c), 2);
+
+    q.release(b);                          // out of order: nothing moves
+    EXPECT_EQ(*static_cast<int*>(a), 0);
+    EXPECT_EQ(*static_cast<int*>(c), 2);
+    EXPECT_EQ(q.bytes_held.load(), int64_t(4 * sizeof(int)));
+    q.release(a);                          // pops a and b
+    EXPECT_EQ(q.bytes_held.load(), int64_t(2 * sizeof(int)));
+    EXPECT_EQ(take(q), 3);
+    q.release(c);
+    EXPECT_EQ(q.next(), nullptr);
+    EXPECT_EQ(q.bytes_held.load(), 0);
+    EXPECT_TRUE(q._q.empty());
+}
+
+TEST(Queue, ReleaseOfUnknownPointerIsIgnored) {
+    fcb::Queue<int> q;
+    q.push(1);
+    int other = 0;
+    q.release(nullptr);
+    q.release(&other);
+    EXPECT_EQ(take(q), 1);
+}
+
+TEST(Queue, StampsSequenceNumbers) {
+    fcb::Queue<int> q;
+    for (int i = 0; i < 3; ++i) q.push(i);
+    EXPECT_EQ(q.last_seq.load(), 3u);
+    void* a = q.next();
+    void* b = q.next();
+    EXPECT_EQ(q.seq_of(a), 1u);
+    EXPECT_EQ(q.seq_of(b), 2u);
+    q.release(a);
+    EXPECT_EQ(q.seq_of(a), 0u);            // no longer handed out
+    EXPECT_EQ(q.seq_of(b), 2u);
+    q.release(b);
+}
+
+TEST(Queue, CountsIngestGapsAndResyncsOnRestart) {
+    fcb::Queue<int> q;
+    EXPECT_EQ(q.note_ingest_seq(10), 0u);  // first one sets the baseline
+    EXPECT_EQ(q.note_ingest_seq(11), 0u);
+    EXPECT_EQ(q.note_ingest_seq(15), 3u);  // 12, 13, 14 missing
+    EXPECT_EQ(q.note_ingest_seq(2), 0u);   // producer restarted
+    EXPECT_EQ(q.note_ingest_seq(4), 1u);
+    EXPECT_EQ(q.ingest_gaps.load(), 4u);
+    EXPECT_EQ(q.stats().ingest_gaps, 4u);
+}
+
+TEST(Queue, ExpiresStaleMessagesLazily) {
+    fcb::Queue<int> q;
+    q.push(1, 1ms);
+    q.push(2);                             // no ttl
+    q.push(3, 1ms);
+    q.push(4, 1h);
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(q.expired.load(), 0u);       // nothing happens until next()
+
+    void* p = q.next();
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(*static_cast<int*>(p), 2);
+    EXPECT_EQ(q.seq_of(p), 2u);            // seq jumps past the expired one
+    EXPECT_EQ(q.expired.load(), 1u);
+    q.release(p);
+    EXPECT_EQ(take(q), 4);
+    EXPECT_EQ(q.expired.load(), 2u);
+    EXPECT_EQ(q.next(), nullptr);
+    EXPECT_EQ(q.bytes_held.load(), 0);
+    EXPECT_EQ(q.stats().expired, 2u);
+}
+
+TEST(Queue, DefaultTtlAppliesToPlainPush) {
+    fcb::Queue<int> q;
+    q.default_ttl = 1ms;
+    q.push(1);
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(q.next(), nullptr);
+    EXPECT_EQ(q.expired.load(), 1u);
+}
+
+TEST(Queue, ExpiryNeverTouchesHandedOutMessages) {
+    fcb::Queue<int> q;
+    q.push(1, 1ms);
+    void* p = q.next();
+    ASSERT_NE(p, nullptr);
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(q.next(), nullptr);
+    EXPECT_EQ(*static_cast<int*>(p), 1);
+    EXPECT_EQ(q.expired.load(), 0u);
+    q.release(p);
+}
+
+TEST(Queue, DropOldestEvictsPendingUntilWithinShare) {
+    fcb::MemoryBudget budget;
+    budget.limit = 4 * sizeof(int);
+    fcb::Queue<int> q;
+    q.set_memory_budget(&budget, 1);
+
+    q.push(0);
+    void* held = q.next();                 // handed out: never evicted
+    for (int i = 1; i <= 6; ++i) q.push(i);
+
+    EXPECT_EQ(q.evicted.load(), 3u);
+    EXPECT_EQ(budget.evicted.load(), 3u);
+    EXPECT_EQ(budget.used.load(), q.bytes_held.load());
+    EXPECT_EQ(*static_cast<int*>(held), 0);
+    EXPECT_EQ(take(q), 4);                 // 1, 2, 3 evicted
+    EXPECT_EQ(take(q), 5);
+    EXPECT_EQ(take(q), 6);
+    q.release(held);
+    EXPECT_EQ(budget.used.load(), 0);
+}
+
+TEST(Queue, EvictionShowsAsSequenceJump) {
+    fcb::MemoryBudget budget;
+    budget.limit = 2 * sizeof(int);
+    fcb::Queue<int> q;
+    q.set_memory_budget(&budget, 1);
+    for (int i = 0; i < 5; ++i) q.push(i);
+    void* p = q.next();
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(q.seq_of(p), 4u);
+    EXPECT_EQ(q.stats().evicted, 3u);      // seq 1..3: the local drops
+    q.release(p);
+}
+
+TEST(Queue, CoalesceKeepsOnlyTheNewest) {
+    fcb::MemoryBudget budget;
+    budget.limit = 3 * sizeof(int);
+    fcb::Queue<int> q;
+    q.memory_policy = fcb::MemoryPolicy::Coalesce;
+    q.set_memory_budget(&budget, 1);
+    for (int i = 0; i < 4; ++i) q.push(i);
+    EXPECT_EQ(q.evicted.load(), 3u);
+    EXPECT_EQ(take(q), 3);
+    EXPECT_EQ(q.next(), nullptr);
+}
+
+TEST(Queue, SpillReceivesEvictedMessages) {
+    fcb::MemoryBudget budget;
+    budget.limit = 2 * sizeof(int);
+    fcb::Queue<int> q;
+    std::vector<int> spilled;
+    q.memory_policy = fcb::MemoryPolicy::Spill;
+    q.spill = [&](int&& v) { spilled.push_back(v); };
+    q.set_memory_budget(&budget, 1);
+    for (int i = 0; i < 5; ++i) q.push(i);
+    EXPECT_EQ(spilled, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(take(q), 3);
+    EXPECT_EQ(take(q), 4);
+}
+
+TEST(Queue, ShareIsWeighted) {
+    fcb::MemoryBudget budget;
+    budget.limit = 8 * sizeof(int);
+    fcb::Queue<int> big, small;
+    big.set_memory_budget(&budget, 3);     // share: 6 ints
+    small.set_memory_budget(&budget, 1);   // share: 2 ints
+    for (int i = 0; i < 4; ++i) small.push(i);
+    EXPECT_EQ(small.evicted.load(), 0u);   // budget not exceeded yet
+    for (int i = 0; i < 6; ++i) big.push(i);
+    EXPECT_EQ(big.evicted.load(), 0u);     // over budget, but within share
+    small.push(4);
+    EXPECT_EQ(small.evicted.load(), 3u);   // over its share: back to 2
+    EXPECT_EQ(budget.used.load(), int64_t(8 * sizeof(int)));
+}
+
+TEST(Queue, MovingBudgetCarriesHeldBytes) {
+    fcb::MemoryBudget a, b;
+    fcb::Queue<int> q;
+    q.set_memory_budget(&a, 2);
+    q.push(1);
+    q.push(2);
+    EXPECT_EQ(a.used.load(), int64_t(2 * sizeof(int)));
+    EXPECT_EQ(a.total_weight.load(), 2u);
+    q.set_memory_budget(&b, 1);
+    EXPECT_EQ(a.used.load(), 0);
+    EXPECT_EQ(a.total_weight.load(), 0u);
+    EXPECT_EQ(b.used.load(), int64_t(2 * sizeof(int)));
+    q.set_memory_budget(nullptr, 0);
+    EXPECT_EQ(b.used.load(), 0);
+    EXPECT_EQ(take(q), 1);
+    EXPECT_EQ(take(q), 2);
+    EXPECT_EQ(b.used.load(), 0);
+}
@@ -0,0 +1,201 @@
+// fcb::SerialIngest framers — delimiter, length-prefix and COBS — fed in
+// pieces the way the ingest loop does, including resynchronisation and
+// oversize drops; and the whole service over a pseudo-terminal.
+#include "flutter_cpp_bridge/serial_ingest.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Frames = std::vector<std::string>;
+
+// The frames of one packed SerialBatch.
+Frames unpack(const fcb::BytesMsg& msg) {
+    fcb::SerialBatchHeader h;
+    std::memcpy(&h, msg.data(), sizeof h);
+    std::vector<uint32_t> starts(h.count + 1);
+    std::memcpy(starts.data(), msg.data() + h.offsets_at, starts.size() * sizeof(uint32_t));
+    const char* bytes = reinterpret_cast<const char*>(msg.data() + sizeof h);
+    Frames out;
+    for (uint32_t i = 0; i < h.count; ++i)
+        out.emplace_back(bytes + starts[i], starts[i + 1] - starts[i]);
+    return out;
+}
+
+// Drives a framer like SerialIngest: unconsumed bytes are offered again
+// with the next piece appended.
+class Feeder {
+public:
+    explicit Feeder(fcb::SerialFramer framer) : _framer(std::move(framer)) {}
+
+    void feed(const std::string& piece) {
+        _pending += piece;
+        const size_t used = _framer(reinterpret_cast<const uint8_t*>(_pending.data()),
+                                    _pending.size(), _frames);
+        ASSERT_LE(used, _pending.size());
+        _pending.erase(0, used);
+        dropped += _frames.take_dropped();
+        if (_frames.count() > 0) {
+            for (std::string& f : unpack(_frames.take(0))) frames.push_back(std::move(f));
+        }
+    }
+    void feed_bytewise(const std::string& data) {
+        for (char c : data) feed(std::string(1, c));
+    }
+
+    Frames   frames;
+    uint64_t dropped = 0;
+
+private:
+    fcb::SerialFramer  _framer;
+    fcb::SerialFrames  _frames;
+    std::string        _pending;
+};
+
+std::string bytes(std::initializer_list<int> values) {
+    std::string s;
+    for (int v : values) s.push_back(char(v));
+    return s;
+}
+
+// Reference COBS encoder, terminator included.
+std::string cobs(const std::string& in) {
+    std::string out(1, '\0');
+    size_t  code_at = 0;
+    uint8_t code    = 1;
+    for (char c : in) {
+        if (c != 0) {
+            out.push_back(c);
+            if (++code != 0xFF) continue;
+        }
+        out[code_at] = char(code);
+        code_at = out.size();
+        out.push_back('\0');
+        code = 1;
+    }
+    out[code_at] = char(code);
+    out.push_back('\0');
+    return out;
+}
+
+} // namespace
+
+// ── Delimiter ────────────────────────────────────────────────────────────────
+
+TEST(SerialDelimiterFramer, JoinsFramesAcrossReadsAndSkipsEmptyOnes) {
+    Feeder f(fcb::serial_delimiter_framer('\n', 64));
+    f.feed("ab\ncd");
+    f.feed("e\n\nf");
+    EXPECT_EQ(f.frames, (Frames{"ab", "cde"}));
+    f.feed("g\n");
+    EXPECT_EQ(f.frames, (Frames{"ab", "cde", "fg"}));
+    EXPECT_EQ(f.dropped, 0u);
+}
+
+TEST(SerialDelimiterFramer, DropsOversizedFramesUpToTheNextDelimiter) {
+    Feeder f(fcb::serial_delimiter_framer('\n', 4));
+    f.feed("toolong\nok\n");
+    EXPECT_EQ(f.frames, (Frames{"ok"}));
+    EXPECT_EQ(f.dropped, 1u);
+
+    f.feed("0123456789");      // no delimiter in sight: discarded as it comes
+    f.feed("abcdefgh");
+    f.feed("tail\nnext\n");
+    EXPECT_EQ(f.frames, (Frames{"ok", "next"}));
+    EXPECT_EQ(f.dropped, 2u);
+}
+
+// ── Length prefix ────────────────────────────────────────────────────────────
+
+TEST(SerialLengthPrefixFramer, ReadsLittleAndBigEndianLengths) {
+    Feeder le(fcb::serial_length_prefix_framer(2, false, 64));
+    le.feed_bytewise(bytes({3, 0, 'a', 'b', 'c', 0, 0, 1, 0, 'z'}));
+    EXPECT_EQ(le.frames, (Frames{"abc", "z"}));   // the empty frame is skipped
+
+    Feeder be(fcb::serial_length_prefix_framer(4, true, 64));
+    be.feed(bytes({0, 0, 0, 2, 'h'}));
+    EXPECT_TRUE(be.frames.empty());
+    be.feed(bytes({'i', 0, 0}));
+    be.feed(bytes({0, 1, '!'}));
+    EXPECT_EQ(be.frames, (Frames{"hi", "!"}));
+
+    Feeder one(fcb::serial_length_prefix_framer(1, false, 64));
+    one.feed(bytes({1, 'x', 2, 'y', 'z'}));
+    EXPECT_EQ(one.frames, (Frames{"x", "yz"}));
+}
+
+TEST(SerialLengthPrefixFramer, SkipsNoiseByteByByteToResync) {
+    Feeder f(fcb::serial_length_prefix_framer(2, false, 8));
+    // 0xFFFF and 0x02FF exceed max_frame: two bytes skipped, then "hi".
+    f.feed(bytes({0xFF, 0xFF, 2, 0, 'h', 'i', 1, 0, '.'}));
+    EXPECT_EQ(f.frames, (Frames{"hi", "."}));
+    EXPECT_EQ(f.dropped, 2u);
+}
+
+// ── COBS ─────────────────────────────────────────────────────────────────────
+
+TEST(SerialCobsFramer, DecodesFramesContainingZeros) {
+    const std::string a = bytes({0x11, 0x00, 0x22});
+    const std::string b = bytes({0x00});
+    std::string c(300, 'c');   // longer than one 254-byte COBS block
+    c[100] = '\0';
+    Feeder f(fcb::serial_cobs_framer(512));
+    f.feed_bytewise(cobs(a) + cobs(b));
+    f.feed(cobs(c));
+    EXPECT_EQ(f.frames, (Frames{a, b, c}));
+    EXPECT_EQ(f.dropped, 0u);
+}
+
+TEST(SerialCobsFramer, DropsCorruptAndOversizedFrames) {
+    Feeder f(fcb::serial_cobs_framer(4));
+    f.feed(bytes({0x05, 0x11, 0x00}));        // code runs past the frame
+    f.feed(cobs("toolong"));                  // decodes to more than 4 bytes
+    f.feed(cobs("ok"));
+    EXPECT_EQ(f.frames, (Frames{"ok"}));
+    EXPECT_EQ(f.dropped, 2u);
+
+    f.feed(std::string(20, 'n'));             // no terminator in sight
+    f.feed(std::string(1, '\0') + cobs("yes"));
+    EXPECT_EQ(f.frames, (Frames{"ok", "yes"}));
+    EXPECT_EQ(f.dropped, 3u);
+}
+
+// ── SerialIngest over a pty ──────────────────────────────────────────────────
+
+TEST(SerialIngest, QueuesFramesReadFromTheDevice) {
+    const int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+        GTEST_SKIP() << "no pseudo-terminal: " << std::strerror(errno);
+
+    fcb::SerialIngest svc;
+    svc.config.path      = ptsname(master);
+    svc.config.max_frame = 16;
+    ASSERT_TRUE(svc.open()) << svc.error();
+    svc.mark_started();
+    std::thread reader([&svc] { fcb::SerialIngest::run(svc); });
+
+    const std::string line = "one\ntwo\nthis line is far too long\nthree\n";
+    ASSERT_EQ(::write(master, line.data(), line.size()), ssize_t(line.size()));
+
+    Frames got;
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (got.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+        void* p = svc.next();
+        if (!p) { std::this_thread::sleep_for(5ms); continue; }
+        for (std::string& f : unpack(*static_cast<fcb::BytesMsg*>(p))) got.push_back(std::move(f));
+        svc.release(p);
+    }
+    svc.request_stop();
+    reader.join();
+    ::close(master);
+
+    EXPECT_EQ(got, (Frames{"one", "two", "three"}));
+    EXPECT_EQ(svc.dropped(), 1u);
+    EXPECT_EQ(svc.bytes_read(), line.size());
+}
@@ -0,0 +1,71 @@
+// fcb::ServiceRegistry: JSON escaping, live state, and duplicate names.
+#include "flutter_cpp_bridge/service_registry.h"
+
+#include <gtest/gtest.h>
+
+TEST(ServiceRegistry, JsonEscapesQuotesBackslashesAndControls) {
+    fcb::ServiceRegistry reg;
+    fcb::ServiceInfo info = fcb::make_service_info("a\"b\\c", " x , y\n,, ", "standalone");
+    info.library = "/lib/\x01.so";
+    ASSERT_TRUE(reg.add(info));
+    EXPECT_EQ(reg.json(),
+              "[{\"name\":\"a\\\"b\\\\c\",\"library\":\"/lib/\\u0001.so\","
+              "\"kind\":\"standalone\",\"message_type\":\"\","
+              "\"capabilities\":[\"x\",\"y\\u000a\"],\"channel\":-1,"
+              "\"running\":false,\"consumer\":false}]");
+}
+
+TEST(ServiceRegistry, JsonReadsTheLiveStateOfEachService) {
+    fcb::ServiceRegistry reg;
+    EXPECT_EQ(reg.json(), "[]");
+    fcb::Queue<int32_t> q;
+    ASSERT_TRUE(reg.add(fcb::describe_service(q, "ints", "")));
+    ASSERT_TRUE(reg.add(fcb::describe_channel(q, 3, "ch", "")));
+
+    const std::string idle = reg.json();
+    EXPECT_NE(idle.find("\"name\":\"ints\",\"library\":\"\",\"kind\":\"queue\","
+                        "\"message_type\":\"int\""),
+              std::string::npos)
+        << idle;
+    EXPECT_NE(idle.find("\"channel\":3"), std::string::npos);
+    EXPECT_EQ(idle.find("\"running\":true"), std::string::npos);
+
+    q.mark_started();
+    q.set_consumer(true);
+    const std::string live = reg.json();
+    EXPECT_NE(live.find("\"running\":true,\"consumer\":true}"), std::string::npos) << live;
+    q.request_stop();
+    EXPECT_EQ(reg.json().find("\"running\":true"), std::string::npos);
+}
+
+TEST(ServiceRegistry, RefusesADuplicateName) {
+    fcb::ServiceRegistry reg;
+    ASSERT_TRUE(reg.add(fcb::make_service_info("svc", "first", "standalone")));
+    EXPECT_FALSE(reg.add(fcb::make_service_info("svc", "second", "standalone")));
+    ASSERT_EQ(reg.list().size(), 1u);
+    EXPECT_EQ(reg.list()[0].capabilities, (std::vector<std::string>{"first"}));
+
+    reg.remove("svc");
+    EXPECT_TRUE(reg.list().empty());
+    EXPECT_TRUE(reg.add(fcb::make_service_info("svc", "second", "standalone")));
+}
+
+TEST(ServiceRegistration, ADuplicateDoesNotUnregisterTheOriginal) {
+    const auto names = [] {
+        std::vector<std::string> out;
+        for (const fcb::ServiceInfo& s : fcb::registry().list()) out.push_back(s.name);
+        return out;
+    };
+    fcb::ServiceRegistration first(fcb::make_service_info("dup-test", "", "standalone"));
+    ASSERT_TRUE(first.added());
+    {
+        fcb::ServiceRegistration second(fcb::make_service_info("dup-test", "", "standalone"));
+        EXPECT_FALSE(second.added());
+    }
+    EXPECT_EQ(names(), (std::vector<std::string>{"dup-test"}));
+
+    char* json = fcb_registry_json();
+    ASSERT_NE(json, nullptr);
+    EXPECT_NE(std::string(json).find("\"name\":\"dup-test\""), std::string::npos);
+    fcb_registry_free(json);
+}
@@ -0,0 +1,55 @@
+// fcb::TimeSeries: range queries and min/max decimation bounds.
+#include "flutter_cpp_bridge/time_series.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Store : ::testing::Test {
+    fcb::TimeSeries<float> ts;
+    void SetUp() override {
+        for (int i = 0; i < 10000; ++i)   // spans several index blocks
+            ts.append(int64_t(i) * 10, float((i * 7919) % 1000));
+    }
+    fcb::TimeSeriesResult<float> query(int64_t t0, int64_t t1, uint32_t n) {
+        return ts.run({1, t0, t1, n});
+    }
+};
+
+} // namespace
+
+TEST_F(Store, RejectsOutOfOrderSamples) {
+    EXPECT_FALSE(ts.append(0, 1.f));
+    EXPECT_TRUE(ts.append(99990, 1.f));
+}
+
+TEST_F(Store, SmallRangesAreReturnedWhole) {
+    auto r = query(100, 150, 100);            // t0 <= t < t1
+    ASSERT_EQ(r.times.size(), 5u);
+    EXPECT_EQ(r.times.front(), 100);
+    EXPECT_EQ(r.times.back(), 140);
+    EXPECT_TRUE(query(150, 150, 100).times.empty());
+    EXPECT_EQ(query(0, 100000, 0).times.size(), 10000u);   // 0 = no limit
+}
+
+TEST_F(Store, DecimationNeverExceedsMaxPoints) {
+    for (uint32_t n = 1; n <= 9; ++n) {
+        auto r = query(0, 100000, n);
+        EXPECT_GE(r.times.size(), 1u) << n;
+        EXPECT_LE(r.times.size(), n) << n;
+        EXPECT_EQ(r.times.size(), r.values.size());
+        EXPECT_TRUE(std::is_sorted(r.times.begin(), r.times.end())) << n;
+    }
+}
+
+TEST_F(Store, SinglePointIsTheNewestSample) {
+    auto r = query(0, 5000, 1);
+    ASSERT_EQ(r.times.size(), 1u);
+    EXPECT_EQ(r.times[0], 4990);
+}
+
+TEST_F(Store, DecimationKeepsTheExtremes) {
+    auto r = query(0, 100000, 64);
+    EXPECT_EQ(*std::min_element(r.values.begin(), r.values.end()), 0.f);
+    EXPECT_EQ(*std::max_element(r.values.begin(), r.values.end()), 999.f);
+}
@@ -0,0 +1,219 @@
+// fcb::UdpIngest over loopback: the datagram index, truncation, UDP_GRO
+// segment splitting, and the batch storage pool.
+#include "flutter_cpp_bridge/udp_ingest.h"
+
+#include <gtest/gtest.h>
+
+#include <netinet/udp.h>
+
+#include <string>
+#include <thread>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103   // <linux/udp.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Received {
+    std::string data;
+    int64_t     timestamp_ns;
+};
+
+// Runs the ingest thread of an opened service for the lifetime of the object.
+class Running {
+public:
+    explicit Running(fcb::UdpIngest& svc) : _svc(svc) {
+        svc.mark_started();
+        _thread = std::thread([&svc] { fcb::UdpIngest::run(svc); });
+    }
+    ~Running() {
+        _svc.request_stop();
+        _thread.join();
+    }
+
+private:
+    fcb::UdpIngest& _svc;
+    std::thread     _thread;
+};
+
+// Datagrams queued by svc until `want` have arrived or two seconds passed.
+std::vector<Received> collect(fcb::UdpIngest& svc, size_t want) {
+    std::vector<Received> out;
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (out.size() < want && std::chrono::steady_clock::now() < deadline) {
+        void* p = svc.next();
+        if (!p) { std::this_thread::sleep_for(5ms); continue; }
+        auto* b = static_cast<fcb::UdpBatch*>(p);
+        for (size_t i = 0; i < b->size(); ++i) {
+            out.push_back({std::string(reinterpret_cast<const char*>(b->datagram(i)),
+                                       b->length(i)),
+                           b->index()[i].timestamp_ns});
+        }
+        svc.release(p);
+    }
+    return out;
+}
+
+int sender(uint16_t port, sockaddr_in& to) {
+    to = sockaddr_in{};
+    to.sin_family      = AF_INET;
+    to.sin_port        = htons(port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+}
+
+} // namespace
+
+TEST(UdpIngest, IndexesEveryDatagramOfABatch) {
+    fcb::UdpIngest svc;
+    svc.config.address      = "127.0.0.1";
+    svc.config.batch        = 8;
+    svc.config.max_datagram = 64;
+    svc.config.timestamps   = true;
+    ASSERT_TRUE(svc.open()) << svc.error();
+    const uint16_t port = svc.local_port();
+    ASSERT_NE(port, 0);
+
+    sockaddr_in to;
+    const int tx = sender(port, to);
+    ASSERT_GE(tx, 0);
+    const std::string sent[] = {"a", "hello", std::string(64, 'x'), std::string(100, 'y')};
+    for (const std::string& d : sent)
+        ASSERT_EQ(sendto(tx, d.data(), d.size(), 0, reinterpret_cast<sockaddr*>(&to), sizeof to),
+                  ssize_t(d.size()));
+
+    Running running(svc);
+    const std::vector<Received> got = collect(svc, 4);
+    ::close(tx);
+
+    ASSERT_EQ(got.size(), 4u);
+    EXPECT_EQ(got[0].data, "a");
+    EXPECT_EQ(got[1].data, "hello");
+    EXPECT_EQ(got[2].data, sent[2]);
+    EXPECT_EQ(got[3].data, std::string(64, 'y'));   // cut to the slot size
+    for (const Received& r : got) EXPECT_GT(r.timestamp_ns, 0);
+    EXPECT_EQ(svc.truncated(), 1u);
+}
+
+TEST(UdpIngest, SplitsGroSegmentsIntoDatagrams) {
+    fcb::UdpIngest svc;
+    svc.config.address = "127.0.0.1";
+    svc.config.gro     = true;
+    if (!svc.open()) GTEST_SKIP() << svc.error();
+
+    sockaddr_in to;
+    const int tx = sender(svc.local_port(), to);
+    ASSERT_GE(tx, 0);
+    int segment = 1000;
+    if (setsockopt(tx, IPPROTO_UDP, UDP_SEGMENT, &segment, sizeof segment) != 0) {
+        ::close(tx);
+        GTEST_SKIP() << "UDP_SEGMENT: " << std::strerror(errno);
+    }
+    // One send of 2500 bytes leaves as segments of 1000, 1000 and 500 bytes;
+    // whether the receiver sees them coalesced or not, the index must list
+    // the three datagrams.
+    std::string payload;
+    for (int i = 0; i < 2500; ++i) payload.push_back(char('a' + i / 1000));
+    ASSERT_EQ(sendto(tx, payload.data(), payload.size(), 0,
+                     reinterpret_cast<sockaddr*>(&to), sizeof to),
+              ssize_t(payload.size()));
+
+    Running running(svc);
+    const std::vector<Received> got = collect(svc, 3);
+    ::close(tx);
+
+    ASSERT_EQ(got.size(), 3u);
+    EXPECT_EQ(got[0].data, std::string(1000, 'a'));
+    EXPECT_EQ(got[1].data, std::string(1000, 'b'));
+    EXPECT_EQ(got[2].data, std::string(500, 'c'));
+}
+
+TEST(UdpIngest, TrimsPartialGroBatches) {
+    fcb::UdpIngest svc;
+    svc.config.address = "127.0.0.1";
+    svc.config.gro     = true;   // 64 slots of 64 KiB
+    if (!svc.open()) GTEST_SKIP() << svc.error();
+
+    sockaddr_in to;
+    const int tx = sender(svc.local_port(), to);
+    ASSERT_GE(tx, 0);
+    ASSERT_EQ(sendto(tx, "ping", 4, 0, reinterpret_cast<sockaddr*>(&to), sizeof to), 4);
+
+    Running running(svc);
+    void* p = nullptr;
+    for (int i = 0; i < 400 && !(p = svc.next()); ++i) std::this_thread::sleep_for(5ms);
+    ::close(tx);
+    ASSERT_NE(p, nullptr);
+    const auto* b = static_cast<fcb::UdpBatch*>(p);
+    ASSERT_EQ(b->size(), 1u);
+    EXPECT_LT(b->capacity_bytes(), size_t(128) << 10);   // one slot, not 4 MiB
+    EXPECT_LT(svc.bytes_held.load(), int64_t(128) << 10);
+    svc.release(p);
+}
+
+TEST(UdpIngest, ConfigureClosesTheSocketAndIsRefusedWhileRunning) {
+    fcb::UdpIngest svc;
+    fcb::UdpIngestConfig loopback;
+    loopback.address = "127.0.0.1";
+    ASSERT_TRUE(svc.configure(loopback));
+    ASSERT_TRUE(svc.open()) << svc.error();
+    EXPECT_NE(svc.local_port(), 0);
+
+    // A new configuration is not served by the socket bound for the old one.
+    fcb::UdpIngestConfig other = loopback;
+    other.batch = 4;
+    ASSERT_TRUE(svc.configure(other));
+    EXPECT_EQ(svc.local_port(), 0);
+    EXPECT_EQ(svc.config.batch, 4u);
+    ASSERT_TRUE(svc.open()) << svc.error();
+
+    {
+        Running running(svc);
+        EXPECT_FALSE(svc.configure(loopback));
+        EXPECT_EQ(svc.config.batch, 4u);
+    }
+    EXPECT_TRUE(svc.configure(loopback));   // once stopped
+}
+
+TEST(UdpIngest, RunEndsAndKeepsTheErrorWhenTheSocketCannotOpen) {
+    fcb::UdpIngest svc;
+    fcb::UdpIngestConfig bad;
+    bad.address = "not an address";
+    ASSERT_TRUE(svc.configure(bad));
+    svc.mark_started();
+    std::thread([&svc] { fcb::UdpIngest::run(svc); }).join();
+
+    EXPECT_FALSE(svc.running());
+    EXPECT_NE(svc.error().find("not an address"), std::string::npos);
+    EXPECT_TRUE(svc.configure(bad));   // no longer counts as running
+    svc.request_stop();
+}
+
+TEST(UdpBufferPool, CachesUpToItsByteLimit) {
+    fcb::UdpBufferPool pool(1000);
+    auto small = pool.acquire(600);
+    uint8_t* bytes = small->bytes.get();
+    pool.recycle(std::move(small));
+    auto again = pool.acquire(100);
+    EXPECT_EQ(again->bytes.get(), bytes);   // reused, already large enough
+    EXPECT_EQ(again->size, 600u);
+    pool.recycle(std::move(again));
+
+    auto big = pool.acquire(2000);          // the cached 600 bytes, grown
+    EXPECT_EQ(big->size, 2000u);
+    pool.recycle(std::move(big));           // over the limit: freed
+    EXPECT_EQ(pool.acquire(10)->size, 10u);
+}
+
+TEST(UdpBufferPool, TrimReleasesOnlyLargeTails) {
+    fcb::UdpBufferPool::Storage s;
+    s.bytes.reset(static_cast<uint8_t*>(std::malloc(size_t(4) << 20)));
+    s.size = size_t(4) << 20;
+    fcb::UdpBufferPool::trim(s, size_t(3) << 20 | 1);   // tail under 1 MiB
+    EXPECT_EQ(s.size, size_t(4) << 20);
+    fcb::UdpBufferPool::trim(s, 65535);
+    EXPECT_EQ(s.size, 65535u);
+}
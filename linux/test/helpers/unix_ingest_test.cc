@@ -0,0 +1,199 @@
+// fcb::UnixIngest with fcb::UnixClient: inline packets, memfd payloads, and
+// the rejection of oversized packets and of unsealed or unsealable
+// descriptors.
+#include "flutter_cpp_bridge/unix_ingest.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+class UnixIngestTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _svc.config.path       = "@fcb-unix-ingest-test-" + std::to_string(getpid());
+        _svc.config.max_inline = 64;
+        ASSERT_TRUE(_svc.open()) << _svc.error();
+        _svc.mark_started();
+        _thread = std::thread([this] { fcb::UnixIngest::run(_svc); });
+        ASSERT_TRUE(_client.connect(_svc.config.path)) << std::strerror(errno);
+    }
+    void TearDown() override {
+        _client.close();
+        _svc.request_stop();
+        _thread.join();
+    }
+
+    // The next message as (bytes, mapped), waiting up to two seconds.
+    bool take(std::string& bytes, bool& mapped) {
+        const auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (void* p = _svc.next()) {
+                const auto* m = static_cast<fcb::UnixMsg*>(p);
+                bytes.assign(reinterpret_cast<const char*>(m->data()), m->size());
+                mapped = m->mapped();
+                _svc.release(p);
+                return true;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    }
+
+    // Waits until rejected() reaches n.
+    bool rejected(uint64_t n) {
+        for (int i = 0; i < 2000 && _svc.rejected() < n; ++i)
+            std::this_thread::sleep_for(1ms);
+        return _svc.rejected() == n;
+    }
+
+    fcb::UnixIngest  _svc;
+    fcb::UnixClient  _client;
+    std::thread      _thread;
+};
+
+int memfd_with(const std::string& bytes, unsigned seals) {
+    const int fd = memfd_create("fcb-test", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) return -1;
+    if (::write(fd, bytes.data(), bytes.size()) != ssize_t(bytes.size()) ||
+        (seals && fcntl(fd, F_ADD_SEALS, seals) != 0)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+TEST_F(UnixIngestTest, DeliversInlinePackets) {
+    ASSERT_TRUE(_client.send_inline("first", 5));
+    ASSERT_TRUE(_client.send("second", 6));   // below memfd_threshold
+
+    std::string bytes;
+    bool mapped = true;
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_EQ(bytes, "first");
+    EXPECT_FALSE(mapped);
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_EQ(bytes, "second");
+    EXPECT_FALSE(mapped);
+}
+
+TEST_F(UnixIngestTest, MapsSealedMemfds) {
+    const std::string payload(200000, 'm');
+    ASSERT_TRUE(_client.send(payload.data(), payload.size()));   // above the threshold
+    const int fd = memfd_with("shrink-sealed only", F_SEAL_SHRINK);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(_client.send_fd(fd));
+    ::close(fd);
+
+    std::string bytes;
+    bool mapped = false;
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_TRUE(mapped);
+    EXPECT_EQ(bytes, payload);
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_TRUE(mapped);
+    EXPECT_EQ(bytes, "shrink-sealed only");
+    EXPECT_EQ(_svc.rejected(), 0u);
+}
+
+TEST_F(UnixIngestTest, RejectsOversizedPackets) {
+    const std::string big(65, 'x');   // max_inline is 64
+    ASSERT_TRUE(_client.send_inline(big.data(), big.size()));
+    ASSERT_TRUE(_client.send_inline("ok", 2));
+    EXPECT_TRUE(rejected(1));
+
+    std::string bytes;
+    bool mapped = true;
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_EQ(bytes, "ok");
+}
+
+TEST_F(UnixIngestTest, RejectsUnsealedAndUnsealableDescriptors) {
+    const int unsealed = memfd_with("no seals", 0);
+    ASSERT_GE(unsealed, 0);
+    ASSERT_TRUE(_client.send_fd(unsealed));
+    ::close(unsealed);
+
+    const int grow_only = memfd_with("grow sealed", F_SEAL_GROW);
+    ASSERT_GE(grow_only, 0);
+    ASSERT_TRUE(_client.send_fd(grow_only));
+    ::close(grow_only);
+
+    int pipe_fds[2];   // F_GET_SEALS fails with EINVAL
+    ASSERT_EQ(pipe2(pipe_fds, O_CLOEXEC), 0);
+    ASSERT_TRUE(_client.send_fd(pipe_fds[0]));
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+
+    ASSERT_TRUE(_client.send_inline("after", 5));
+    EXPECT_TRUE(rejected(3));
+    std::string bytes;
+    bool mapped = true;
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_EQ(bytes, "after");
+}
+
+TEST_F(UnixIngestTest, ConfigureIsRefusedWhileRunning) {
+    fcb::UnixIngestConfig other;
+    other.path = "@fcb-unix-ingest-other-" + std::to_string(getpid());
+    EXPECT_FALSE(_svc.configure(other));
+    EXPECT_EQ(_svc.config.max_inline, 64u);
+    ASSERT_TRUE(_client.send_inline("still served", 12));
+    std::string bytes;
+    bool mapped = true;
+    ASSERT_TRUE(take(bytes, mapped));
+    EXPECT_EQ(bytes, "still served");
+}
+
+TEST(UnixIngest, ConfigureClosesASocketLeftOpen) {
+    const std::string first  = "@fcb-unix-ingest-first-" + std::to_string(getpid());
+    const std::string second = "@fcb-unix-ingest-second-" + std::to_string(getpid());
+    fcb::UnixIngest svc;
+    fcb::UnixIngestConfig config;
+    config.path = first;
+    ASSERT_TRUE(svc.configure(config));
+    ASSERT_TRUE(svc.open()) << svc.error();
+
+    config.path = second;
+    ASSERT_TRUE(svc.configure(config));
+    fcb::UnixClient client;
+    EXPECT_FALSE(client.connect(first));   // closed, not left listening
+    ASSERT_TRUE(svc.open()) << svc.error();
+    EXPECT_TRUE(client.connect(second)) << std::strerror(errno);
+}
+
+TEST(UnixIngest, ReplacesOnlyAStaleSocketFile) {
+    const std::string path = "/tmp/fcb-unix-ingest-path-" + std::to_string(getpid());
+    {
+        // A socket file left behind by a process that did not close().
+        const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        sockaddr_un addr;
+        socklen_t   len;
+        ASSERT_TRUE(fcb::unix_address(path, addr, len));
+        ASSERT_EQ(bind(fd, reinterpret_cast<sockaddr*>(&addr), len), 0);
+        ::close(fd);
+    }
+    fcb::UnixIngest svc;
+    svc.config.path = path;
+    EXPECT_TRUE(svc.open()) << svc.error();
+    svc.close();
+
+    // Not a socket: left alone, and open() fails.
+    FILE* f = std::fopen(path.c_str(), "w");
+    ASSERT_NE(f, nullptr);
+    std::fputs("keep me", f);
+    std::fclose(f);
+    EXPECT_FALSE(svc.open());
+    EXPECT_NE(svc.error().find(std::strerror(EADDRINUSE)), std::string::npos);
+    struct stat st;
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(st.st_size, 7);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,88 @@
+// fcb::Watchdog: scan() raising and clearing the stalled-consumer and
+// stuck-worker alarms.
+#include "flutter_cpp_bridge/watchdog.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Moves the activity of q one second into the past.
+void age(fcb::ServiceBase& q) {
+    const int64_t then = fcb::coarse_now_ns() - 1000000000;
+    q.last_push_ns.store(then);
+    q.last_drain_ns.store(then);
+    q.last_beat_ns.store(then);
+}
+
+} // namespace
+
+TEST(Watchdog, ScanRaisesAndClearsAlarms) {
+    fcb::Watchdog wd;
+    wd.set_period(3600 * 1000);   // only the scans below
+    fcb::Queue<int32_t> q;
+    q.mark_started();
+    q.set_consumer(true);
+    std::vector<fcb::WatchdogEvent> events;
+    wd.watch(q, /*stall_ms=*/100, /*heartbeat_ms=*/100, "q");
+    wd.on_alarm(q, [&events](const fcb::WatchdogEvent& e) { events.push_back(e); });
+
+    EXPECT_EQ(wd.scan(), 0u);
+    EXPECT_TRUE(events.empty());
+
+    q.push(1);
+    age(q);
+    EXPECT_EQ(wd.scan(), 1u);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].name, "q");
+    EXPECT_EQ(events[0].alarms, fcb::kStalledConsumer | fcb::kStuckWorker);
+    EXPECT_EQ(events[0].raised, fcb::kStalledConsumer | fcb::kStuckWorker);
+    EXPECT_EQ(events[0].pending, 1u);
+    EXPECT_GE(events[0].drain_idle_ms, 900);
+    EXPECT_EQ(q.alarms.load(), fcb::kStalledConsumer | fcb::kStuckWorker);
+    ASSERT_EQ(wd.alarmed().size(), 1u);
+
+    EXPECT_EQ(wd.scan(), 1u);   // unchanged: no callback
+    EXPECT_EQ(events.size(), 1u);
+
+    q.heartbeat();
+    EXPECT_EQ(wd.scan(), 1u);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].alarms, fcb::kStalledConsumer);
+    EXPECT_EQ(events[1].raised, 0u);
+
+    void* p = q.next();
+    ASSERT_NE(p, nullptr);
+    q.release(p);
+    EXPECT_EQ(wd.scan(), 0u);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[2].alarms, 0u);
+    EXPECT_EQ(q.alarms.load(), 0u);
+    EXPECT_TRUE(wd.alarmed().empty());
+}
+
+TEST(Watchdog, RaisesNothingWithoutAConsumerOrOnceStopped) {
+    fcb::Watchdog wd;
+    wd.set_period(3600 * 1000);
+    fcb::Queue<int32_t> q;
+    q.mark_started();
+    q.set_consumer(true);
+    wd.watch(q, 100, /*heartbeat_ms=*/0, "q");   // stuck-worker alarm off
+    q.push(1);
+    age(q);
+    EXPECT_EQ(wd.scan(), 1u);
+    EXPECT_EQ(q.alarms.load(), fcb::kStalledConsumer);
+
+    q.set_consumer(false);
+    EXPECT_EQ(wd.scan(), 0u);
+    q.set_consumer(true);
+    EXPECT_EQ(wd.scan(), 1u);
+    q.request_stop();
+    EXPECT_EQ(wd.scan(), 0u);
+
+    q.mark_started();
+    age(q);
+    EXPECT_EQ(wd.scan(), 1u);
+    wd.unwatch(q);
+    EXPECT_EQ(q.alarms.load(), 0u);
+    EXPECT_EQ(wd.scan(), 0u);
+}
@@ -0,0 +1,140 @@
+// fcb::ZmqDemux: prefix routing, and the reset done by configure().
+#include "flutter_cpp_bridge/zmq_demux.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string ipc_address(const char* name) {
+    return "ipc:///tmp/fcb_" + std::string(name) + "_" + std::to_string(getpid());
+}
+
+struct Publisher {
+    void* ctx  = zmq_ctx_new();
+    void* sock = zmq_socket(ctx, ZMQ_PUB);
+
+    explicit Publisher(const std::string& address) {
+        int linger = 0;
+        zmq_setsockopt(sock, ZMQ_LINGER, &linger, sizeof linger);
+        EXPECT_EQ(zmq_bind(sock, address.c_str()), 0);
+    }
+    ~Publisher() {
+        zmq_close(sock);
+        zmq_ctx_term(ctx);
+    }
+
+    void send(const std::string& topic, const std::string& payload) {
+        zmq_send(sock, topic.data(), topic.size(), ZMQ_SNDMORE);
+        zmq_send(sock, payload.data(), payload.size(), 0);
+    }
+};
+
+// First frames of the messages queued in ch, which are released.
+std::vector<std::string> take_topics(fcb::ZmqDemux::Channel& ch) {
+    std::vector<std::string> topics;
+    while (void* p = ch.next()) {
+        auto* batch = static_cast<fcb::ZmqBatch*>(p);
+        topics.emplace_back(reinterpret_cast<const char*>(batch->data(0)),
+                            batch->frame_size(0));
+        ch.release(p);
+    }
+    return topics;
+}
+
+// Publishes (topic, payload) until `ch` receives something: a SUB socket
+// drops what is published before its subscription reaches the publisher.
+std::vector<std::string> publish_until(Publisher& pub, const std::string& topic,
+                                       fcb::ZmqDemux::Channel& ch) {
+    std::vector<std::string> got;
+    for (int i = 0; i < 200 && got.empty(); ++i) {
+        pub.send(topic, "payload");
+        std::this_thread::sleep_for(10ms);
+        got = take_topics(ch);
+    }
+    return got;
+}
+
+} // namespace
+
+TEST(ZmqDemux, RoutesToEveryMatchingChannel) {
+    const std::string address = ipc_address("demux_route");
+    Publisher pub(address);
+    fcb::ZmqDemux hub;
+    ASSERT_TRUE(hub.configure(ZMQ_SUB, -1, -1, false));
+    EXPECT_EQ(hub.add_channel("a."), 0u);
+    EXPECT_EQ(hub.add_channel("a.b"), 1u);
+    EXPECT_EQ(hub.add_channel("c"), 2u);
+    hub.config.endpoints.push_back({address, false});
+    ASSERT_TRUE(hub.open()) << hub.error();
+    for (uint32_t i = 0; i < hub.size(); ++i) hub.start_channel(i);
+
+    std::vector<std::string> got = publish_until(pub, "a.b.x", hub.channel(1));
+    ASSERT_FALSE(got.empty());
+    EXPECT_EQ(got[0], "a.b.x");
+    std::vector<std::string> shared = take_topics(hub.channel(0));
+    ASSERT_FALSE(shared.empty());                 // a shared reference
+    EXPECT_EQ(shared[0], "a.b.x");
+
+    got = publish_until(pub, "c1", hub.channel(2));
+    ASSERT_FALSE(got.empty());
+    EXPECT_EQ(got[0], "c1");
+    for (const std::string& t : take_topics(hub.channel(0))) EXPECT_EQ(t, "a.b.x");
+    for (const std::string& t : take_topics(hub.channel(1))) EXPECT_EQ(t, "a.b.x");
+
+    for (uint32_t i = 0; i < hub.size(); ++i) hub.stop_channel(i);
+}
+
+TEST(ZmqDemux, ConfigureResetsChannelsAndEndpoints) {
+    const std::string first = ipc_address("demux_first");
+    const std::string second = ipc_address("demux_second");
+    Publisher pub_first(first);
+    Publisher pub_second(second);
+
+    fcb::ZmqDemux hub;
+    ASSERT_TRUE(hub.configure(ZMQ_SUB, -1, -1, false));
+    hub.add_channel("old");
+    hub.config.endpoints.push_back({first, false});
+    ASSERT_TRUE(hub.open());
+    hub.start_channel(0);
+
+    // Refused while a channel runs: the reader walks the channel list.
+    EXPECT_FALSE(hub.configure(ZMQ_SUB, -1, -1, false));
+    EXPECT_EQ(hub.add_channel("late"), UINT32_MAX);
+    EXPECT_EQ(hub.size(), 1u);
+
+    fcb::ZmqDemux::Channel& old = hub.channel(0);
+    ASSERT_FALSE(publish_until(pub_first, "old", old).empty());
+    hub.stop_channel(0);
+
+    // Joins the stopping reader, closes its socket and clears the lists.
+    ASSERT_TRUE(hub.configure(ZMQ_SUB, -1, -1, false));
+    EXPECT_EQ(hub.size(), 0u);
+    EXPECT_TRUE(hub.config.endpoints.empty());
+    EXPECT_TRUE(hub.config.topics.empty());
+
+    EXPECT_EQ(hub.add_channel("new"), 0u);
+    hub.config.endpoints.push_back({second, false});
+    ASSERT_TRUE(hub.open()) << hub.error();
+    hub.start_channel(0);
+    std::vector<std::string> got = publish_until(pub_second, "new", hub.channel(0));
+    ASSERT_FALSE(got.empty());
+    EXPECT_EQ(got[0], "new");
+
+    // Nothing from the first endpoint, or for the dropped prefix.
+    for (int i = 0; i < 10; ++i) pub_first.send("old", "payload");
+    pub_second.send("old", "payload");
+    std::this_thread::sleep_for(50ms);
+    for (const std::string& t : take_topics(hub.channel(0))) EXPECT_EQ(t, "new");
+    hub.stop_channel(0);
+}
+
+TEST(ZmqDemux, NativelyRoutedChannelsSurviveConfigure) {
+    fcb::ZmqDemux hub{3, [](const fcb::ZmqBatch&) { return 0; }};
+    ASSERT_TRUE(hub.configure(ZMQ_SUB, -1, -1, false));
+    EXPECT_EQ(hub.size(), 3u);
+    EXPECT_TRUE(hub.config.topics.empty());
+}
@@ -0,0 +1,115 @@
+// fcb::ZmqPublisher: the configure → open → start order of the Dart wrapper,
+// and whole-message delivery of multipart messages.
+#include "flutter_cpp_bridge/zmq_publish.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+namespace {
+
+std::string ipc_address(const char* name) {
+    return "ipc:///tmp/fcb_" + std::string(name) + "_" + std::to_string(getpid());
+}
+
+struct Puller {
+    void* ctx  = zmq_ctx_new();
+    void* sock = zmq_socket(ctx, ZMQ_PULL);
+
+    explicit Puller(const std::string& address) {
+        int linger = 0, timeout = 2000;
+        zmq_setsockopt(sock, ZMQ_LINGER, &linger, sizeof linger);
+        zmq_setsockopt(sock, ZMQ_RCVTIMEO, &timeout, sizeof timeout);
+        EXPECT_EQ(zmq_connect(sock, address.c_str()), 0);
+    }
+    ~Puller() {
+        zmq_close(sock);
+        zmq_ctx_term(ctx);
+    }
+
+    // The frames of the next message; empty on timeout.
+    std::vector<std::string> receive() {
+        std::vector<std::string> frames;
+        int more = 1;
+        size_t size = sizeof more;
+        while (more) {
+            char buf[256];
+            int n = zmq_recv(sock, buf, sizeof buf, 0);
+            if (n < 0) return {};
+            frames.emplace_back(buf, size_t(n));
+            zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &size);
+        }
+        return frames;
+    }
+};
+
+bool send_part(fcb::ZmqPublisher& pub, const std::string& part, bool more) {
+    return pub.send_copy(part.data(), part.size(), more);
+}
+
+} // namespace
+
+TEST(ZmqPublisher, OpensAndSendsInTheWrapperOrder) {
+    // ZmqPublisherService: configure, add endpoints, open, then start.
+    const std::string address = ipc_address("publish_order");
+    fcb::ZmqPublisher pub;
+    ASSERT_TRUE(pub.configure(ZMQ_PUSH, -1, -1, 16));
+    pub.config.endpoints.push_back({address, true});
+    ASSERT_TRUE(pub.open()) << pub.error();
+    pub.start();
+    EXPECT_TRUE(pub.running());
+
+    Puller pull(address);
+    EXPECT_TRUE(send_part(pub, "topic", true));
+    EXPECT_TRUE(send_part(pub, "payload", false));
+    EXPECT_EQ(pull.receive(), (std::vector<std::string>{"topic", "payload"}));
+    EXPECT_EQ(pub.sent(), 2u);
+
+    EXPECT_FALSE(pub.configure(ZMQ_PUSH, -1, -1, 16));   // sender running
+    pub.stop();
+    EXPECT_FALSE(pub.running());
+    ASSERT_TRUE(pub.configure(ZMQ_PUB, -1, -1, 16));
+    EXPECT_TRUE(pub.config.endpoints.empty());
+}
+
+TEST(ZmqPublisher, FailedReserveDropsTheMessageInProgress) {
+    const std::string address = ipc_address("publish_reserve");
+    fcb::ZmqPublisher pub;
+    ASSERT_TRUE(pub.configure(ZMQ_PUSH, -1, -1, 16));
+    pub.config.endpoints.push_back({address, true});
+    ASSERT_TRUE(pub.open()) << pub.error();
+
+    EXPECT_TRUE(send_part(pub, "lost", true));
+    EXPECT_EQ(pub.reserve(size_t(1) << 40), nullptr);   // above the pool
+    EXPECT_EQ(pub.dropped(), 1u);
+    EXPECT_TRUE(send_part(pub, "alone", false));        // a new message
+    EXPECT_TRUE(send_part(pub, "a", true));
+    EXPECT_TRUE(send_part(pub, "b", false));
+
+    Puller pull(address);
+    pub.start();
+    EXPECT_EQ(pull.receive(), (std::vector<std::string>{"alone"}));
+    EXPECT_EQ(pull.receive(), (std::vector<std::string>{"a", "b"}));
+    pub.stop();
+}
+
+TEST(ZmqPublisher, FullQueueRejectsTheWholeMessage) {
+    fcb::ZmqPublisher pub;
+    ASSERT_TRUE(pub.configure(ZMQ_PUB, -1, -1, 1));
+    ASSERT_TRUE(pub.open()) << pub.error();
+
+    EXPECT_TRUE(send_part(pub, "first", false));         // fills the queue
+    EXPECT_FALSE(send_part(pub, "topic", true));
+    EXPECT_FALSE(send_part(pub, "payload", false));      // rest of it too
+    EXPECT_EQ(pub.dropped(), 2u);
+    pub.stop();                                          // frees "first"
+}
+
+TEST(ZmqPublisher, StopDropsAnUnfinishedMessage) {
+    fcb::ZmqPublisher pub;
+    ASSERT_TRUE(pub.configure(ZMQ_PUB, -1, -1, 16));
+    ASSERT_TRUE(pub.open()) << pub.error();
+    EXPECT_TRUE(send_part(pub, "topic", true));
+    pub.stop();
+    EXPECT_EQ(pub.dropped(), 1u);
+}
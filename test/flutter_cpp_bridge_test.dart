@@ -12,5 +12,20 @@ void main() {
       final pool = ServicePool();
       expect(() => pool.dispose(), returnsNormally);
     });
+
+    test('keeps the default drain budget and reports no hits when empty', () {
+      final pool = ServicePool(drainBudget: const Duration(milliseconds: 2));
+      expect(pool.drainBudget, const Duration(milliseconds: 2));
+      expect(pool.budgetHits, 0);
+    });
+
+    test('owns a memory budget when given one', () {
+      final pool = ServicePool(memoryBudgetBytes: 1 << 20);
+      expect(pool.memoryBudget!.limitBytes, 1 << 20);
+      expect(pool.memoryBudget!.usedBytes, 0);
+      expect(pool.bytesHeld, 0);
+      expect(ServicePool().memoryBudget, isNull);
+      pool.dispose();
+    });
   });
 }
@@ -0,0 +1,13 @@
+// Publisher library for zmq_publisher_service_test.dart: a plain
+// FCB_EXPORT_ZMQ_PUBLISH_SYMBOLS build.  The test compiles it in setUpAll
+// when pkg-config finds libzmq:
+//
+//   c++ -std=c++17 -shared -fPIC -Ilinux/include
+//       test/native/fake_publisher.cc -o libfake_publisher.so -pthread
+//       $(pkg-config --cflags --libs libzmq)
+//
+#include "flutter_cpp_bridge/zmq_publish.h"
+
+static fcb::ZmqPublisher g_pub;
+
+FCB_EXPORT_ZMQ_PUBLISH_SYMBOLS(g_pub)
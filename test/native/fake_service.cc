@@ -0,0 +1,29 @@
+// Fake service library for the Dart dispatch tests (service_test.dart).
+//
+// A plain FCB_EXPORT_SYMBOLS queue of ints whose messages are pushed from
+// Dart, so the tests drive Service through the real symbol lookup and native
+// callback without a worker thread.  service_test.dart compiles it in
+// setUpAll:
+//
+//   c++ -std=c++17 -shared -fPIC -Ilinux/include
+//       test/native/fake_service.cc -o libfake_service.so -pthread
+//
+#include "flutter_cpp_bridge/service_helpers.h"
+
+static fcb::Queue<int32_t> g_svc;
+
+static void worker(fcb::Queue<int32_t>&) {}
+
+FCB_EXPORT_SYMBOLS(g_svc, worker)
+
+// Pushes one message and notifies Dart, as a worker would.
+FCB_EXPORT void fake_push(int32_t value) { g_svc.push(value); }
+
+FCB_EXPORT int32_t fake_value(void* msg) { return *static_cast<int32_t*>(msg); }
+
+FCB_EXPORT bool fake_has_consumer() { return g_svc.has_consumer(); }
+
+// Frees whatever a test left queued, so the next one starts empty.
+FCB_EXPORT void fake_reset() {
+    while (void* msg = g_svc.next()) g_svc.release(msg);
+}
@@ -0,0 +1,225 @@
+@TestOn('linux')
+library;
+
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:flutter_cpp_bridge/flutter_cpp_bridge.dart';
+
+/// Binds the test hooks of test/native/fake_service.cc.
+class _FakeService extends Service {
+  _FakeService(super.libname) {
+    push = lib
+        .lookup<NativeFunction<Void Function(Int32)>>('fake_push')
+        .asFunction<void Function(int)>();
+    value = lib
+        .lookup<NativeFunction<Int32 Function(Pointer<BackendMsg>)>>(
+          'fake_value',
+        )
+        .asFunction<int Function(Pointer<BackendMsg>)>();
+    hasConsumer = lib
+        .lookup<NativeFunction<Bool Function()>>('fake_has_consumer')
+        .asFunction<bool Function()>();
+    reset = lib
+        .lookup<NativeFunction<Void Function()>>('fake_reset')
+        .asFunction<void Function()>();
+  }
+
+  late final void Function(int) push;
+  late final int Function(Pointer<BackendMsg>) value;
+  late final bool Function() hasConsumer;
+  late final void Function() reset;
+}
+
+/// Lets the notifications posted by the native side reach the event loop.
+Future<void> _settle(bool Function() done) async {
+  for (var i = 0; i < 200 && !done(); i++) {
+    await Future<void>.delayed(const Duration(milliseconds: 5));
+  }
+}
+
+void main() {
+  late String libPath;
+  late _FakeService svc;
+
+  setUpAll(() async {
+    final dir = await Directory.systemTemp.createTemp('fcb_service_test');
+    libPath = '${dir.path}/libfake_service.so';
+    final result = await Process.run('c++', [
+      '-std=c++17',
+      '-shared',
+      '-fPIC',
+      '-Ilinux/include',
+      'test/native/fake_service.cc',
+      '-o',
+      libPath,
+      '-pthread',
+    ]);
+    if (result.exitCode != 0) {
+      fail('could not build the fake service:\n${result.stderr}');
+    }
+  });
+
+  setUp(() {
+    svc = _FakeService(libPath);
+    svc.reset();
+  });
+
+  tearDown(() {
+    svc.dispose();
+    svc.reset();
+  });
+
+  group('assignJob', () {
+    test('runs the job synchronously, in order, and frees each message',
+        () async {
+      final got = <int>[];
+      final held = <int>[];
+      svc.assignJob((msg) {
+        got.add(svc.value(msg));
+        held.add(svc.stats.bytesHeld); // freed only once the job returns
+      });
+      expect(svc.hasConsumer(), isTrue);
+      for (var i = 1; i <= 5; i++) {
+        svc.push(i);
+      }
+      await _settle(() => got.length == 5);
+      expect(got, [1, 2, 3, 4, 5]);
+      expect(held, everyElement(greaterThan(0)));
+      expect(svc.stats.bytesHeld, 0);
+      expect(svc.stats.pending, 0);
+
+      svc.cancelJob();
+      expect(svc.hasConsumer(), isFalse);
+    });
+
+    test('frees messages at once while nothing consumes them', () async {
+      svc.push(1);
+      svc.push(2);
+      await _settle(() => svc.stats.pending == 0);
+      await Future<void>.delayed(const Duration(milliseconds: 20));
+      expect(svc.stats.pending, 0);
+      expect(svc.stats.bytesHeld, 0);
+    });
+
+    test('hands messages to the stream when no job is assigned', () async {
+      final got = <int>[];
+      final sub = svc.messages.listen((msg) {
+        got.add(svc.value(msg));
+        svc.freeMessage(msg);
+      });
+      expect(svc.hasConsumer(), isTrue);
+      svc.push(7);
+      svc.push(8);
+      await _settle(() => got.length == 2);
+      expect(got, [7, 8]);
+      expect(svc.stats.bytesHeld, 0);
+      await sub.cancel();
+      expect(svc.hasConsumer(), isFalse);
+    });
+  });
+
+  group('assignAsyncJob', () {
+    test('keeps at most maxInFlight messages out and resumes in order',
+        () async {
+      final started = <int>[];
+      final done = <int, Completer<void>>{};
+      svc.assignAsyncJob((msg) {
+        final v = svc.value(msg);
+        started.add(v);
+        return (done[v] = Completer<void>()).future;
+      }, maxInFlight: 2);
+      for (var i = 1; i <= 5; i++) {
+        svc.push(i);
+      }
+      await _settle(() => svc.stats.pending == 3);
+      await Future<void>.delayed(const Duration(milliseconds: 20));
+      expect(started, [1, 2]);
+      expect(svc.stats.pending, 3); // held back in the native queue
+
+      // Completion order does not matter; each one frees a slot.
+      done[2]!.complete();
+      await _settle(() => started.length == 3);
+      expect(started, [1, 2, 3]);
+      done[1]!.complete();
+      done[3]!.complete();
+      await _settle(() => started.length == 5);
+      expect(started, [1, 2, 3, 4, 5]);
+      done[4]!.complete();
+      done[5]!.complete();
+      await _settle(() => svc.stats.bytesHeld == 0);
+      expect(svc.stats.bytesHeld, 0);
+      expect(svc.stats.pending, 0);
+    });
+
+    test('cancelJob frees the messages the full window held back', () async {
+      final pending = <Completer<void>>[];
+      svc.assignAsyncJob((msg) {
+        final c = Completer<void>();
+        pending.add(c);
+        return c.future;
+      }, maxInFlight: 1);
+      svc.push(1);
+      svc.push(2);
+      svc.push(3);
+      await _settle(() => svc.stats.pending == 2);
+      expect(pending, hasLength(1));
+
+      svc.cancelJob();
+      expect(svc.stats.pending, 0);
+      pending.single.complete();
+      await _settle(() => svc.stats.bytesHeld == 0);
+      expect(svc.stats.bytesHeld, 0);
+    });
+  });
+
+  group('drainBudget', () {
+    test('drains the whole backlog on one notification within budget',
+        () async {
+      final got = <int>[];
+      svc.drainBudget = const Duration(seconds: 1);
+      svc.assignJob((msg) => got.add(svc.value(msg)));
+      for (var i = 1; i <= 50; i++) {
+        svc.push(i);
+      }
+      await _settle(() => got.length == 50);
+      expect(got, List<int>.generate(50, (i) => i + 1));
+      expect(svc.budgetHits, 0);
+      expect(svc.stats.bytesHeld, 0);
+    });
+
+    test('yields when the budget is spent and resumes without frames',
+        () async {
+      final got = <int>[];
+      // A zero budget is spent by every message: each drain delivers one,
+      // then resumes from the scheduler fallback (no binding here).
+      svc.drainBudget = Duration.zero;
+      svc.assignJob((msg) => got.add(svc.value(msg)));
+      for (var i = 1; i <= 5; i++) {
+        svc.push(i);
+      }
+      await _settle(() => got.length == 5);
+      expect(got, [1, 2, 3, 4, 5]);
+      expect(svc.budgetHits, 5);
+      expect(svc.stats.pending, 0);
+    });
+
+    test('a scheduled resume stops once the job is cancelled', () async {
+      final got = <int>[];
+      svc.drainBudget = Duration.zero;
+      svc.assignJob((msg) {
+        got.add(svc.value(msg));
+        if (got.length == 2) svc.cancelJob();
+      });
+      for (var i = 1; i <= 5; i++) {
+        svc.push(i);
+      }
+      await _settle(() => svc.budgetHits == 2);
+      await Future<void>.delayed(const Duration(milliseconds: 20));
+      expect(got, [1, 2]);
+      expect(svc.budgetHits, 2);
+    });
+  });
+}
@@ -0,0 +1,92 @@
+@TestOn('linux')
+library;
+
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:flutter_cpp_bridge/flutter_cpp_bridge.dart';
+
+Future<void> _settle(bool Function() done) async {
+  for (var i = 0; i < 200 && !done(); i++) {
+    await Future<void>.delayed(const Duration(milliseconds: 5));
+  }
+}
+
+/// The compiler flags for libzmq, or null without pkg-config or libzmq.
+List<String>? _zmqFlags() {
+  try {
+    final r = Process.runSync('pkg-config', ['--cflags', '--libs', 'libzmq']);
+    if (r.exitCode != 0) return null;
+    return (r.stdout as String).trim().split(RegExp(r'\s+'));
+  } on ProcessException {
+    return null;
+  }
+}
+
+void main() {
+  final zmqFlags = _zmqFlags();
+  final skip = zmqFlags == null ? 'libzmq not found by pkg-config' : null;
+  late String libPath;
+
+  setUpAll(() async {
+    if (zmqFlags == null) return;
+    final dir = await Directory.systemTemp.createTemp('fcb_publisher_test');
+    libPath = '${dir.path}/libfake_publisher.so';
+    final result = await Process.run('c++', [
+      '-std=c++17',
+      '-shared',
+      '-fPIC',
+      '-Ilinux/include',
+      'test/native/fake_publisher.cc',
+      '-o',
+      libPath,
+      '-pthread',
+      ...zmqFlags,
+    ]);
+    if (result.exitCode != 0) {
+      fail('could not build the fake publisher:\n${result.stderr}');
+    }
+  });
+
+  ZmqPublisherService open() => ZmqPublisherService(
+        libPath,
+        endpoints: ['ipc://${Directory.systemTemp.path}/fcb_publisher_$pid'],
+        bind: true,
+      );
+
+  test('configures, opens, then starts the sender', () async {
+    final out = open();
+    try {
+      expect(out.send(Uint8List.fromList([1, 2, 3])), isTrue);
+      await _settle(() => out.sent == 1);
+      expect(out.sent, 1);
+      expect(out.dropped, 0);
+    } finally {
+      out.dispose();
+    }
+  }, skip: skip);
+
+  test('refuses a second wrapper while the first one runs', () {
+    final out = open();
+    try {
+      expect(open, throwsStateError);
+    } finally {
+      out.dispose();
+    }
+    open().dispose(); // the library is free again
+  }, skip: skip);
+
+  test('a part that cannot be reserved drops the whole message', () {
+    final out = open();
+    try {
+      final head = Uint8List(1);
+      expect(out.send(head, more: true), isTrue);
+      expect(out.reserve(0xFFFFFFFF), nullptr);
+      expect(out.dropped, 1);
+    } finally {
+      out.dispose();
+    }
+  }, skip: skip);
+}